@@ -14,12 +14,15 @@
 
 #include "experimental/squirrel/bin_matvec_prot.h"
 
+#include <array>
 #include <future>
+#include <limits>
 
 #include "seal/seal.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/rlwe.h"
 #include "yacl/utils/elapsed_timer.h"
+#include "yacl/utils/parallel.h"
 
 #include "libspu/mpc/cheetah/arith/common.h"
 #include "libspu/mpc/cheetah/arith/vector_encoder.h"
@@ -210,6 +213,8 @@ struct BinMatVecProtocol::Impl : public spu::mpc::cheetah::EnableCPRNG {
     size_t num_lwes = outp.size();
     SPU_ENFORCE_EQ(num_lwes, dim_out, "expected num_lwes={}, got={}", dim_out,
                    outp.size());
+    SPU_ENFORCE(indicator.empty() || indicator.size() == dim_in,
+                "expected indicator size={}, got={}", dim_in, indicator.size());
 
     // Partition `n` samples into batches.
     // Each batch contains at most `2^B` samples.
@@ -247,15 +252,31 @@ struct BinMatVecProtocol::Impl : public spu::mpc::cheetah::EnableCPRNG {
     };
     IndexMapper mapper(dim_in, poly_degree_in(ring_bitwidth_));
 
+    // Each sample is hit once per feature. Resolve its location (and whether
+    // it is masked out by the indicator) once instead of per non-zero.
+    constexpr uint32_t kSkip = std::numeric_limits<uint32_t>::max();
+    std::vector<std::array<uint32_t, 2>> locs(dim_in);
+    yacl::parallel_for(0, dim_in, [&](size_t bgn, size_t end) {
+      for (size_t i = bgn; i < end; ++i) {
+        if (not indicator.empty() and 0 == indicator[i]) {
+          locs[i] = {kSkip, 0};
+          continue;
+        }
+        auto loc = mapper.MapToLoc(i);
+        locs[i] = {static_cast<uint32_t>(loc[0]),
+                   static_cast<uint32_t>(loc[1])};
+      }
+    });
+
     auto pick_then_sum = [&](size_t row_start, size_t row_util) {
       for (size_t row = row_start; row < row_util; ++row) {
         for (auto col_iter = matrix.iterate_row_begin(row);
              col_iter != matrix.iterate_row_end(row); ++col_iter) {
           SPU_ENFORCE(*col_iter < dim_in);
-          if (not indicator.empty() and 0 == indicator[*col_iter]) {
+          const auto &loc = locs[*col_iter];
+          if (loc[0] == kSkip) {
             continue;
           }
-          auto loc = mapper.MapToLoc(*col_iter);
           outp[row].AddLazyInplace(vec[loc[0]], loc[1], context);
         }
 
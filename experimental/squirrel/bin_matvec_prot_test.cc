@@ -37,14 +37,14 @@ class BinMatVecProtTest
     // sparsity 5%
     nnz = std::max(1UL, static_cast<size_t>(nnz * 0.05));
     // row major
-    bin_mat.rows_data_.resize(rows);
+    std::vector<StlSparseMatrix::SparseRow> rows_data(rows);
     for (size_t i = 0; i < nnz; ++i) {
       size_t r = static_cast<size_t>(uniform(eng) % rows);
       size_t c = static_cast<size_t>(uniform(eng) % cols);
-      bin_mat.rows_data_[r].insert(c);
+      rows_data[r].insert(c);
     }
 
-    bin_mat.cols_ = cols;
+    bin_mat = StlSparseMatrix::Initialize(rows_data, cols);
   }
 
   // plaintext BinMatVec
@@ -67,6 +67,29 @@ class BinMatVecProtTest
   }
 };
 
+TEST(StlSparseMatrixTest, CSR) {
+  std::vector<StlSparseMatrix::SparseRow> rows_data = {{3, 0, 2}, {}, {1}};
+  auto mat = StlSparseMatrix::Initialize(rows_data, 4);
+  EXPECT_EQ(mat.rows(), 3);
+  EXPECT_EQ(mat.cols(), 4);
+  EXPECT_EQ(mat.nnz(), 4U);
+
+  std::vector<size_t> row0(mat.iterate_row_begin(0), mat.iterate_row_end(0));
+  EXPECT_EQ(row0, std::vector<size_t>({0, 2, 3}));
+  EXPECT_EQ(mat.iterate_row_begin(1), mat.iterate_row_end(1));
+  EXPECT_EQ(*mat.iterate_row_begin(2), 1U);
+  // rows are stored back to back
+  EXPECT_EQ(mat.iterate_row_end(0), mat.iterate_row_begin(2));
+
+  auto same = StlSparseMatrix::Initialize({0, 3, 3, 4}, {0, 2, 3, 1}, 4);
+  EXPECT_EQ(same.row_ptr_, mat.row_ptr_);
+  EXPECT_EQ(same.col_indices_, mat.col_indices_);
+
+  // out of range
+  EXPECT_ANY_THROW(StlSparseMatrix::Initialize({{4}}, 4));
+  EXPECT_ANY_THROW(StlSparseMatrix::Initialize({0, 1}, {4}, 4));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Cheetah, BinMatVecProtTest,
     testing::Combine(testing::Values(spu::FM32, spu::FM64, spu::FM128),
@@ -182,9 +205,8 @@ TEST_P(BinMatVecProtTest, EmptyMat) {
   int64_t dim_in = std::get<0>(std::get<1>(GetParam()));
   int64_t dim_out = std::get<1>(std::get<1>(GetParam()));
 
-  StlSparseMatrix mat;
-  mat.rows_data_.resize(dim_out);
-  mat.cols_ = dim_in;
+  auto mat = StlSparseMatrix::Initialize(
+      std::vector<StlSparseMatrix::SparseRow>(dim_out), dim_in);
 
   NdArrayRef vec_shr[2];
   vec_shr[0] = ring_rand(field, {dim_in})
@@ -13,6 +13,10 @@
 // limitations under the License.
 #include "experimental/squirrel/tree_build_worker.h"
 
+#include <limits>
+
+#include "yacl/utils/parallel.h"
+
 #include "experimental/squirrel/bin_matvec_prot.h"
 #include "experimental/squirrel/objectives.h"
 
@@ -71,32 +75,51 @@ void XGBTreeBuildWorker::BuildMap(const xt::xarray<double>& dframe) {
   SPU_ENFORCE_EQ(nfeatures, nfeatures_);
   binnings_.resize(nfeatures, Binning(bucket_size_));
 
-  std::vector<StlSparseMatrix::SparseRow> nzero_position(
-      /*nrows*/ bucket_size_ * nfeatures);
+  SPU_ENFORCE(nsamples <= std::numeric_limits<StlSparseMatrix::Index>::max(),
+              "too many samples {}", nsamples);
+
+  // Every sample falls into exactly one bucket of each feature. Thus the
+  // non-zeros of the f-th feature are the f-th `nsamples` slots of the CSR
+  // arrays, and the features can be bucketed (by counting sort) in parallel.
+  std::vector<size_t> row_ptr(bucket_size_ * nfeatures + 1, 0);
+  std::vector<StlSparseMatrix::Index> col_indices(nsamples * nfeatures);
 
-  for (size_t f = 0; f < nfeatures; ++f) {
-    const size_t feature_bucket_pos = f * bucket_size_;
+  yacl::parallel_for(0, nfeatures, [&](size_t bgn, size_t end) {
+    for (size_t f = bgn; f < end; ++f) {
+      const size_t feature_bucket_pos = f * bucket_size_;
 
-    xt::xarray<double> fd =
-        xt::ravel<xt::layout_type::column_major>(xt::col(dframe, f));
-    absl::Span<const double> _fd = {fd.data(), fd.size()};
+      xt::xarray<double> fd =
+          xt::ravel<xt::layout_type::column_major>(xt::col(dframe, f));
+      absl::Span<const double> _fd = {fd.data(), fd.size()};
 
-    binnings_[f].Fit(_fd);
-    std::vector<uint16_t> bucket_indices = binnings_[f].Transform(_fd);
+      binnings_[f].Fit(_fd);
+      std::vector<uint16_t> bucket_indices = binnings_[f].Transform(_fd);
 
-    SPU_ENFORCE_EQ(nsamples, bucket_indices.size());
+      SPU_ENFORCE_EQ(nsamples, bucket_indices.size());
+
+      std::vector<size_t> offsets(bucket_size_ + 1, 0);
+      for (size_t i = 0; i < nsamples; ++i) {
+        size_t bucket = bucket_indices[i];
+        SPU_ENFORCE(bucket < bucket_size_);
+        offsets[bucket + 1] += 1;
+      }
+      for (size_t b = 0; b < bucket_size_; ++b) {
+        offsets[b + 1] += offsets[b];
+        row_ptr[feature_bucket_pos + b + 1] = f * nsamples + offsets[b + 1];
+      }
 
-    // Put samples in bucket[0], ..., bucket[bucket_size-1]
-    for (size_t i = 0; i < nsamples; ++i) {
-      size_t bucket = bucket_indices[i];
-      SPU_ENFORCE(bucket < bucket_size_);
-      int row = static_cast<int>(feature_bucket_pos + bucket);
-      int col = static_cast<int>(i);
-      nzero_position[row].insert(col);
+      // Put samples in bucket[0], ..., bucket[bucket_size-1]
+      // Samples are visited in order, so each row comes out sorted.
+      auto* feature_cols = col_indices.data() + f * nsamples;
+      for (size_t i = 0; i < nsamples; ++i) {
+        feature_cols[offsets[bucket_indices[i]]++] =
+            static_cast<StlSparseMatrix::Index>(i);
+      }
     }
-  }
+  });
 
-  bucket_map_ = StlSparseMatrix::Initialize(nzero_position, /*ncols*/ nsamples);
+  bucket_map_ = StlSparseMatrix::Initialize(
+      std::move(row_ptr), std::move(col_indices), /*ncols*/ nsamples);
 }
 
 std::pair<spu::Value, spu::Value> XGBTreeBuildWorker::ComputeGradientSums(
@@ -209,15 +232,15 @@ std::vector<uint8_t> XGBTreeBuildWorker::PotentialLeftIndicator(
   size_t bucket_bgn = feature_index * bucket_size_;
 
   // bucket_map_: (bucket_size * nfeatures) x nsample mapping
-  for (size_t k = bucket_bgn; k <= target_bucket_index; ++k) {
-    for (auto col_iter = bucket_map_.iterate_row_begin(k);
-         col_iter != bucket_map_.iterate_row_end(k); ++col_iter) {
-      size_t sample_index = *col_iter;
-      SPU_ENFORCE(sample_index < nsamples);
-      // hit once
-      SPU_ENFORCE(indicator[sample_index] == 0);
-      indicator[sample_index] = 1;
-    }
+  // The rows [bucket_bgn, target_bucket_index] are stored contiguously.
+  auto col_bgn = bucket_map_.iterate_row_begin(bucket_bgn);
+  auto col_end = bucket_map_.iterate_row_end(target_bucket_index);
+  for (auto col_iter = col_bgn; col_iter != col_end; ++col_iter) {
+    size_t sample_index = *col_iter;
+    SPU_ENFORCE(sample_index < nsamples);
+    // hit once
+    SPU_ENFORCE(indicator[sample_index] == 0);
+    indicator[sample_index] = 1;
   }
   return indicator;
 }
@@ -163,6 +163,19 @@ def compile(source: libspu.CompilationSource, copts: libspu.CompilerOptions) ->
     return _spu_compilation(source, copts)
 
 
+def print_ir(code: bytes) -> str:
+    """Print the code of an executable as textual IR.
+
+    Args:
+        code (bytes): ExecutableProto.code, textual IR or MLIR bytecode.
+
+    Returns:
+        str: textual IR.
+    """
+
+    return libspu.print_ir(code)
+
+
 def check_cpu_feature():
     """Check CPU features required by SPU."""
     libspu._check_cpu_features()
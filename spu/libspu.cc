@@ -30,9 +30,11 @@
 
 #include "libspu/compiler/compile.h"
 #include "libspu/core/context.h"
+#include "libspu/core/encoding.h"
 #include "libspu/core/logging.h"
 #include "libspu/core/value.h"
 #include "libspu/device/api.h"
+#include "libspu/device/executable_cache.h"
 #include "libspu/device/io.h"
 #include "libspu/device/pphlo/pphlo_executor.h"
 #include "libspu/device/symbol_table.h"
@@ -309,7 +311,7 @@ struct PyBindShare {
   std::vector<py::bytes> share_chunks;
 };
 
-static spu::Value ValueFromPyBindShare(const PyBindShare& py_share) {
+static spu::ValueProto ProtoFromPyBindShare(const PyBindShare& py_share) {
   spu::ValueProto value;
   pb::ValueMetaProto meta;
   SPU_ENFORCE(meta.ParseFromString(py_share.meta));
@@ -319,18 +321,51 @@ static spu::Value ValueFromPyBindShare(const PyBindShare& py_share) {
     SPU_ENFORCE(chunk.ParseFromString(s));
     value.chunks.emplace_back(std::move(chunk));
   }
-  return Value::fromProto(value);
+  return value;
+}
+
+// The chunks are parsed in place and copied into the value once.
+static spu::Value ValueFromPyBindShare(const PyBindShare& py_share) {
+  spu::ValueProtoView value;
+  SPU_ENFORCE(value.meta.ParseFromString(py_share.meta));
+  value.chunks.reserve(py_share.share_chunks.size());
+  for (const auto& s : py_share.share_chunks) {
+    char* data = nullptr;
+    Py_ssize_t size = 0;
+    SPU_ENFORCE(PyBytes_AsStringAndSize(s.ptr(), &data, &size) == 0);
+    value.chunks.emplace_back(spu::ValueChunkView::parseFrom(
+        std::string_view(data, static_cast<size_t>(size))));
+  }
+  return Value::fromProtoView(value);
+}
+
+static PyBindShare ProtoToPyBindShare(const spu::ValueProto& value_pb) {
+  PyBindShare ret;
+  ret.meta = value_pb.meta.SerializeAsString();
+  ret.share_chunks.reserve(value_pb.chunks.size());
+  for (const auto& s : value_pb.chunks) {
+    ret.share_chunks.emplace_back(s.SerializeAsString());
+  }
+  return ret;
 }
 
+// The chunks are serialized straight from the buffer of the value into the
+// python bytes.
 static PyBindShare ValueToPyBindShare(const spu::Value& value,
                                       size_t max_chunk_size) {
   PyBindShare ret;
 
-  const auto value_pb = value.toProto(max_chunk_size);
+  const auto value_pb = value.toProtoView(max_chunk_size);
   ret.meta = value_pb.meta.SerializeAsString();
   ret.share_chunks.reserve(value_pb.chunks.size());
   for (const auto& s : value_pb.chunks) {
-    ret.share_chunks.emplace_back(s.SerializeAsString());
+    const size_t size = s.serializedSize();
+    auto bytes = py::reinterpret_steal<py::bytes>(
+        PyBytes_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size)));
+    SPU_ENFORCE(bytes.ptr() != nullptr, "failed to allocate {} bytes", size);
+    s.serializeToArray(
+        reinterpret_cast<uint8_t*>(PyBytes_AS_STRING(bytes.ptr())));
+    ret.share_chunks.emplace_back(std::move(bytes));
   }
   return ret;
 }
@@ -496,39 +531,47 @@ class IoWrapper {
         ByteToElementStrides(binfo.strides.begin(), binfo.strides.end(),
                              binfo.itemsize));
 
-    const auto shares = ptr_->makeShares(
-        view, static_cast<spu::Visibility>(visibility), owner_rank);
+    const auto shares = ptr_->makeShareProtos(
+        view, static_cast<spu::Visibility>(visibility), owner_rank,
+        max_chunk_size_);
 
     std::vector<PyBindShare> serialized;
     serialized.reserve(shares.size());
     for (const auto& share : shares) {
-      serialized.emplace_back(ValueToPyBindShare(share, max_chunk_size_));
+      serialized.emplace_back(ProtoToPyBindShare(share));
     }
 
     return serialized;
   }
 
   py::array Reconstruct(const std::vector<PyBindShare>& vals) {
-    std::vector<spu::Value> shares;
+    std::vector<spu::ValueProto> shares;
     SPU_ENFORCE(!vals.empty());
     shares.reserve(vals.size());
     for (const auto& val : vals) {
-      shares.emplace_back(ValueFromPyBindShare(val));
+      shares.emplace_back(ProtoFromPyBindShare(val));
     }
     // sanity
     for (size_t idx = 1; idx < shares.size(); ++idx) {
-      const auto& cur = shares[idx];
-      const auto& prev = shares[idx - 1];
+      const auto& cur = shares[idx].meta;
+      const auto& prev = shares[idx - 1].meta;
       SPU_ENFORCE(cur.storage_type() == prev.storage_type(),
                   "storage type mismatch, {} {}", cur.storage_type(),
                   prev.storage_type());
-      SPU_ENFORCE(cur.dtype() == prev.dtype(), "data type mismatch, {} {}",
-                  cur.dtype(), prev.dtype());
+      SPU_ENFORCE(cur.data_type() == prev.data_type(),
+                  "data type mismatch, {} {}", cur.data_type(),
+                  prev.data_type());
     }
 
-    const PtType pt_type = ptr_->getPtType(shares);
-    std::vector<size_t> shape = {shares.front().shape().begin(),
-                                 shares.front().shape().end()};
+    const auto& meta = shares.front().meta;
+    const auto dtype = static_cast<DataType>(meta.data_type());
+    PtType pt_type = getDecodeType(dtype);
+    if (meta.is_complex()) {
+      SPU_ENFORCE(dtype == DT_F32 || dtype == DT_F64);
+      pt_type = dtype == DT_F32 ? PT_CF32 : PT_CF64;
+    }
+    std::vector<size_t> shape = {meta.shape().dims().begin(),
+                                 meta.shape().dims().end()};
 
     py::array ret(py::dtype(PtTypeToPyFormat(pt_type)), shape);
     const py::buffer_info& binfo = ret.request();
@@ -538,7 +581,7 @@ class IoWrapper {
         ByteToElementStrides(binfo.strides.begin(), binfo.strides.end(),
                              binfo.itemsize));
 
-    ptr_->combineShares(shares, &ret_view);
+    ptr_->combineShareProtos(shares, &ret_view);
     return ret;
   }
 };
@@ -622,7 +665,10 @@ void BindSPU(py::module& m) {
       .def_readwrite("disable_matmul_pack", &CheetahConfig::disable_matmul_pack)
       .def_readwrite("enable_mul_lsb_error",
                      &CheetahConfig::enable_mul_lsb_error)
-      .def_readwrite("ot_kind", &CheetahConfig::ot_kind);
+      .def_readwrite("ot_kind", &CheetahConfig::ot_kind)
+      .def_readwrite("enable_ot_prefetch", &CheetahConfig::enable_ot_prefetch)
+      .def_readwrite("matmul_encode_cache_budget",
+                     &CheetahConfig::matmul_encode_cache_budget);
 
   py::class_<RuntimeConfig> rt_cls(m, "RuntimeConfig");
 
@@ -725,7 +771,30 @@ void BindSPU(py::module& m) {
       .def_readwrite("experimental_exp_prime_disable_lower_bound",
                      &RuntimeConfig::experimental_exp_prime_disable_lower_bound)
       .def_readwrite("experimental_exp_prime_enable_upper_bound",
-                     &RuntimeConfig::experimental_exp_prime_enable_upper_bound);
+                     &RuntimeConfig::experimental_exp_prime_enable_upper_bound)
+      .def_readwrite("experimental_beaver_prefetch_depth",
+                     &RuntimeConfig::experimental_beaver_prefetch_depth)
+      .def_readwrite("experimental_beaver_record_dir",
+                     &RuntimeConfig::experimental_beaver_record_dir)
+      .def_readwrite("experimental_beaver_replay_dir",
+                     &RuntimeConfig::experimental_beaver_replay_dir)
+      .def_readwrite("experimental_beaver_cache_memory_budget",
+                     &RuntimeConfig::experimental_beaver_cache_memory_budget)
+      .def_readwrite("experimental_enable_numa_pinning",
+                     &RuntimeConfig::experimental_enable_numa_pinning)
+      .def_readwrite("experimental_enable_comm_bit_packing",
+                     &RuntimeConfig::experimental_enable_comm_bit_packing)
+      .def_readwrite("experimental_mmul_num_threads",
+                     &RuntimeConfig::experimental_mmul_num_threads)
+      .def_readwrite("experimental_spdz2k_mac_check_interval",
+                     &RuntimeConfig::experimental_spdz2k_mac_check_interval)
+      .def_readwrite("experimental_buffer_pool_size",
+                     &RuntimeConfig::experimental_buffer_pool_size)
+      .def_readwrite("experimental_enable_executable_cache",
+                     &RuntimeConfig::experimental_enable_executable_cache)
+      .def_readwrite(
+          "experimental_enable_critical_path_scheduling",
+          &RuntimeConfig::experimental_enable_critical_path_scheduling);
 
   // Compiler
   py::enum_<SourceIRType>(m, "SourceIRType")
@@ -764,7 +833,7 @@ void BindSPU(py::module& m) {
   py::class_<CompilerOptions>(m, "CompilerOptions")
       .def(py::init<>())
       .def(py::init<bool, std::string, XLAPrettyPrintKind, bool, bool, bool,
-                    bool, bool, bool, bool, bool, bool>(),
+                    bool, bool, bool, bool, bool, bool, bool, bool>(),
            py::arg("enable_pretty_print") = false,
            py::arg("pretty_print_dump_dir") = "",
            py::arg("xla_pp_kind") = XLAPrettyPrintKind::TEXT,
@@ -776,7 +845,9 @@ void BindSPU(py::module& m) {
            py::arg("disable_select_optimization") = false,
            py::arg("enable_optimize_denominator_with_broadcast") = false,
            py::arg("disable_deallocation_insertion") = false,
-           py::arg("disable_partial_sort_optimization") = false)
+           py::arg("disable_partial_sort_optimization") = false,
+           py::arg("enable_bytecode_output") = false,
+           py::arg("enable_secret_op_batching") = false)
       .def("__hash__",
            [](const CompilerOptions& self) {
              return std::hash<spu::CompilerOptions>{}(self);
@@ -806,7 +877,11 @@ void BindSPU(py::module& m) {
       .def_readwrite("disable_deallocation_insertion",
                      &CompilerOptions::disable_deallocation_insertion)
       .def_readwrite("disable_partial_sort_optimization",
-                     &CompilerOptions::disable_partial_sort_optimization);
+                     &CompilerOptions::disable_partial_sort_optimization)
+      .def_readwrite("enable_bytecode_output",
+                     &CompilerOptions::enable_bytecode_output)
+      .def_readwrite("enable_secret_op_batching",
+                     &CompilerOptions::enable_secret_op_batching);
 
   py::class_<ExecutableProto>(m, "ExecutableProto")
       .def(py::init<>())
@@ -902,6 +977,15 @@ void BindSPU(py::module& m) {
         return py::bytes(spu::compiler::compile(source, copts));
       },
       "spu compile.", py::arg("source"), py::arg("copts"));
+
+  m.def(
+      "print_ir",
+      [](const py::bytes& code) {
+        return spu::device::ParsedExecutable::parse(std::string(code))
+            ->toString();
+      },
+      "textual IR of an executable code, which may be MLIR bytecode.",
+      py::arg("code"));
 }
 
 void BindLogging(py::module& m) {
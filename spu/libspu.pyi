@@ -95,6 +95,8 @@ class CheetahConfig:
         self.disable_matmul_pack = disable_matmul_pack
         self.enable_mul_lsb_error = enable_mul_lsb_error
         self.ot_kind = ot_kind
+        self.enable_ot_prefetch = False
+        self.matmul_encode_cache_budget = 0
 
 class RuntimeConfig:
     class SortMethod(enum.IntEnum):
@@ -164,6 +166,17 @@ class RuntimeConfig:
     experimental_exp_prime_offset: int
     experimental_exp_prime_disable_lower_bound: bool
     experimental_exp_prime_enable_upper_bound: bool
+    experimental_beaver_prefetch_depth: int
+    experimental_beaver_record_dir: str
+    experimental_beaver_replay_dir: str
+    experimental_beaver_cache_memory_budget: int
+    experimental_enable_numa_pinning: bool
+    experimental_enable_comm_bit_packing: bool
+    experimental_mmul_num_threads: int
+    experimental_spdz2k_mac_check_interval: int
+    experimental_buffer_pool_size: int
+    experimental_enable_executable_cache: bool
+    experimental_enable_critical_path_scheduling: bool
 
     # @staticmethod
     # def makeFromJson(json: str) -> 'RuntimeConfig': ...
@@ -222,6 +235,8 @@ class CompilerOptions:
         enable_optimize_denominator_with_broadcast=False,
         disable_deallocation_insertion=False,
         disable_partial_sort_optimization=False,
+        enable_bytecode_output=False,
+        enable_secret_op_batching=False,
     ):
         self.enable_pretty_print = enable_pretty_print
         self.pretty_print_dump_dir = pretty_print_dump_dir
@@ -239,6 +254,8 @@ class CompilerOptions:
         )
         self.disable_deallocation_insertion = disable_deallocation_insertion
         self.disable_partial_sort_optimization = disable_partial_sort_optimization
+        self.enable_bytecode_output = enable_bytecode_output
+        self.enable_secret_op_batching = enable_secret_op_batching
 
 class ExecutableProto:
     def __init__(
@@ -295,3 +312,4 @@ class IoWrapper:
 
 def _check_cpu_features(): ...
 def compile(source: CompilationSource, copts: CompilerOptions) -> bytes: ...
+def print_ir(code: bytes) -> str: ...
@@ -19,6 +19,8 @@
 import numpy as np
 import numpy.testing as npt
 
+import spu.api as spu_api
+import spu.libspu as libspu
 import spu.utils.frontend as spu_fe
 
 
@@ -42,6 +44,26 @@ def test():
         self.assertIn("@main", ir)
         self.assertIn("pphlo", ir)
 
+    def test_print_bytecode(self):
+        def test():
+            return 1
+
+        result, *_ = spu_fe.compile(
+            spu_fe.Kind.JAX,
+            test,
+            list(),
+            dict(),
+            [],
+            [],
+            lambda _: ["out1"],
+            copts=libspu.CompilerOptions(enable_bytecode_output=True),
+        )
+
+        # bytecode is not utf-8, but could be printed as textual IR.
+        ir = spu_api.print_ir(result.code)
+        self.assertIn("@main", ir)
+        self.assertIn("pphlo", ir)
+
 
 if __name__ == '__main__':
     unittest.main()
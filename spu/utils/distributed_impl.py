@@ -711,7 +711,7 @@ def dump_ir(self, *args, **kwargs):
             executable, *_ = self._compile_jax_func(
                 self.pyfunc, self.static_argnums, self.copts, *args, **kwargs
             )
-            return executable.code.decode('utf-8')
+            return spu_api.print_ir(executable.code)
 
         def _compile_jax_func(self, fn, static_argnums, copts, *args, **kwargs):
             def mock_parameters(obj: Union[SPU.Object, np.ndarray]):
@@ -940,7 +940,7 @@ def dump_ir(self, state_dict, *args, **kwargs):
             self.state_dict = self._place_state_dict(state_dict)
             args, kwargs = self.device._place_arguments(*args, **kwargs)
             executable, *_ = self._compile_torch_func(self.pyfunc, *args, **kwargs)
-            return executable.code.decode('utf-8')
+            return spu_api.print_ir(executable.code)
 
         def _compile_torch_func(self, fn, copts, *args, **kwargs):
             import torch
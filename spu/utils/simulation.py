@@ -167,7 +167,7 @@ def outputNameGen(out_flat):
             copts=copts,
         )
 
-        wrapper.pphlo = executable.code.decode("utf-8")
+        wrapper.pphlo = spu_api.print_ir(executable.code)
 
         out_flat = sim(executable, *args_flat)
 
@@ -15,19 +15,26 @@
 #include "libspu/compiler/codegen/codegen.h"
 
 #include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 
+#include "libspu/core/prelude.h"
 #include "libspu/version.h"
 
 namespace spu::compiler {
 
-std::string CodeGen::doit(mlir::ModuleOp module) {
+std::string CodeGen::doit(mlir::ModuleOp module, bool emit_bytecode) {
   // Add ir version attr
   module->setAttr("pphlo.version",
                   mlir::StringAttr::get(module->getContext(), getVersionStr()));
   // Emit module
   std::string ir_dump;
   llvm::raw_string_ostream stream(ir_dump);
-  module.print(stream);
+  if (emit_bytecode) {
+    SPU_ENFORCE(mlir::succeeded(mlir::writeBytecodeToFile(module, stream)),
+                "Failed to emit bytecode");
+  } else {
+    module.print(stream);
+  }
 
   return stream.str();
 }
@@ -22,7 +22,8 @@ namespace spu::compiler {
 
 class CodeGen final {
 public:
-  static std::string doit(mlir::ModuleOp module);
+  // Emits the module as textual IR, or as MLIR bytecode when `emit_bytecode`.
+  static std::string doit(mlir::ModuleOp module, bool emit_bytecode = false);
 };
 
 } // namespace spu::compiler
@@ -34,7 +34,8 @@ std::string compile(const CompilationSource &source,
   core.doit(mlir_module.get());
 
   // Run codegen
-  return spu::compiler::CodeGen::doit(mlir_module.get());
+  return spu::compiler::CodeGen::doit(mlir_module.get(),
+                                      copts.enable_bytecode_output);
 }
 
 } // namespace spu::compiler
@@ -94,6 +94,11 @@ void Core::buildPipeline(mlir::PassManager *pm) {
   }
 
   optPM.addPass(mlir::createLoopInvariantCodeMotionPass());
+
+  if (options.enable_secret_op_batching) {
+    optPM.addPass(mlir::spu::pphlo::createBatchSecretOpsPass());
+  }
+
   optPM.addPass(mlir::spu::pphlo::createRegionAccessFixture());
   optPM.addPass(mlir::createCSEPass());
 
@@ -0,0 +1,40 @@
+// RUN: spu-opt --batch-secret-ops --split-input-file %s | FileCheck %s
+
+func.func @main(%arg0: tensor<2x!pphlo.secret<f32>>, %arg1: tensor<3x!pphlo.secret<f32>>) -> (tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<f32>>) {
+    //CHECK: pphlo.concatenate
+    //CHECK: pphlo.concatenate
+    //CHECK: %[[MUL:.*]] = pphlo.multiply %{{.*}}, %{{.*}} : tensor<5x!pphlo.secret<f32>>
+    //CHECK-NOT: pphlo.multiply
+    //CHECK: pphlo.slice %[[MUL]] [0:1:2]
+    //CHECK: pphlo.slice %[[MUL]] [2:1:5]
+    %0 = pphlo.multiply %arg0, %arg0 : tensor<2x!pphlo.secret<f32>>
+    %1 = pphlo.multiply %arg1, %arg1 : tensor<3x!pphlo.secret<f32>>
+    return %0, %1: tensor<2x!pphlo.secret<f32>>, tensor<3x!pphlo.secret<f32>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<2x2x!pphlo.secret<f32>>, %arg1: tensor<2x2x!pphlo.secret<f32>>) -> (tensor<2x2x!pphlo.secret<i1>>, tensor<2x2x!pphlo.secret<i1>>) {
+    //CHECK: %[[ADD:.*]] = pphlo.add
+    //CHECK: %[[LESS:.*]] = pphlo.less %{{.*}}, %{{.*}} : (tensor<8x!pphlo.secret<f32>>, tensor<8x!pphlo.secret<f32>>) -> tensor<8x!pphlo.secret<i1>>
+    //CHECK-NOT: pphlo.less
+    %0 = pphlo.less %arg0, %arg1 : (tensor<2x2x!pphlo.secret<f32>>, tensor<2x2x!pphlo.secret<f32>>) -> tensor<2x2x!pphlo.secret<i1>>
+    %1 = pphlo.add %arg0, %arg1 : tensor<2x2x!pphlo.secret<f32>>
+    %2 = pphlo.less %arg1, %arg0 : (tensor<2x2x!pphlo.secret<f32>>, tensor<2x2x!pphlo.secret<f32>>) -> tensor<2x2x!pphlo.secret<i1>>
+    return %0, %2: tensor<2x2x!pphlo.secret<i1>>, tensor<2x2x!pphlo.secret<i1>>
+}
+
+// -----
+
+func.func @main(%arg0: tensor<2x!pphlo.secret<f32>>, %arg1: tensor<2xf32>) -> (tensor<2x!pphlo.secret<f32>>, tensor<2x!pphlo.secret<f32>>) {
+    // Dependent ops are not merged
+    //CHECK: %[[M0:.*]] = pphlo.multiply %arg0, %arg0
+    //CHECK: pphlo.multiply %[[M0]], %arg0
+    %0 = pphlo.multiply %arg0, %arg0 : tensor<2x!pphlo.secret<f32>>
+    %1 = pphlo.multiply %0, %arg0 : tensor<2x!pphlo.secret<f32>>
+    // Multiplications by public are local
+    //CHECK-NOT: pphlo.concatenate
+    %2 = pphlo.multiply %arg0, %arg1 : (tensor<2x!pphlo.secret<f32>>, tensor<2xf32>) -> tensor<2x!pphlo.secret<f32>>
+    %3 = pphlo.multiply %1, %arg1 : (tensor<2x!pphlo.secret<f32>>, tensor<2xf32>) -> tensor<2x!pphlo.secret<f32>>
+    return %2, %3: tensor<2x!pphlo.secret<f32>>, tensor<2x!pphlo.secret<f32>>
+}
@@ -0,0 +1,165 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Estimates the communication of a pphlo program before running it, e.g.
+//
+//   spu-cost --protocol_kind=3 --latency_ms=20 --bandwidth_mbps=100 prog.mlir
+//   spu-cost --executable exec.pb
+
+#include <optional>
+
+#include "fmt/format.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "mlir/IR/Location.h"
+#include "spdlog/spdlog.h"
+
+#include "libspu/core/context.h"
+#include "libspu/core/prelude.h"
+#include "libspu/device/cost_model.h"
+#include "libspu/device/executable_cache.h"
+#include "libspu/mpc/factory.h"
+#include "libspu/mpc/utils/simulate.h"
+#include "libspu/spu.h"
+
+llvm::cl::opt<std::string> InputFilename(llvm::cl::Positional,
+                                         llvm::cl::desc("<input file>"),
+                                         llvm::cl::init("-"));
+
+llvm::cl::opt<bool> Executable(
+    "executable",
+    llvm::cl::desc("Input is a serialized ExecutableProto instead of IR"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<uint32_t> ProtocolKind(
+    "protocol_kind", llvm::cl::init(2),
+    llvm::cl::desc("2 for SEMI2k, 3 for ABY3, 4 for Cheetah, 5 for SecureNN"));
+
+llvm::cl::opt<uint32_t> Field("field", llvm::cl::init(2),
+                              llvm::cl::desc("1 for FM32, 2 for FM64, 3 for "
+                                             "FM128"));
+
+llvm::cl::opt<uint32_t> FxpBits(
+    "fxp_bits", llvm::cl::init(0),
+    llvm::cl::desc("Fixed point fraction bits, 0 for the field default"));
+
+llvm::cl::opt<double> LatencyMs("latency_ms", llvm::cl::init(1.0),
+                                llvm::cl::desc("Latency of a round, in ms"));
+
+llvm::cl::opt<double> BandwidthMbps("bandwidth_mbps", llvm::cl::init(1000.0),
+                                    llvm::cl::desc("Bandwidth, in Mbps"));
+
+llvm::cl::opt<bool> PerOp("per_op", llvm::cl::desc("Print the cost of each op"),
+                          llvm::cl::init(false));
+
+namespace {
+
+spu::device::KernelCostTable makeTable() {
+  spu::RuntimeConfig conf;
+  conf.protocol = static_cast<spu::ProtocolKind>(ProtocolKind.getValue());
+  conf.field = static_cast<spu::FieldType>(Field.getValue());
+  conf.fxp_fraction_bits = FxpBits.getValue();
+
+  size_t num_parties = 2;
+  switch (conf.protocol) {
+  case spu::SEMI2K:
+  case spu::CHEETAH:
+    num_parties = 2;
+    break;
+  case spu::ABY3:
+  case spu::SECURENN:
+    num_parties = 3;
+    break;
+  default:
+    SPU_THROW("unsupported protocol_kind={}", ProtocolKind.getValue());
+  }
+
+  // Kernels are only registered with a link context.
+  std::optional<spu::device::KernelCostTable> table;
+  spu::mpc::utils::simulate(
+      num_parties, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+        spu::SPUContext sctx(conf, lctx);
+        spu::mpc::Factory::RegisterProtocol(&sctx, lctx);
+        if (lctx->Rank() == 0) {
+          table = spu::device::KernelCostTable::fromContext(&sctx);
+        }
+      });
+  return std::move(*table);
+}
+
+std::string locationOf(mlir::Operation *op) {
+  if (auto loc = mlir::dyn_cast<mlir::FileLineColLoc>(op->getLoc())) {
+    return fmt::format("{}:{}", loc.getLine(), loc.getColumn());
+  }
+  return "";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvm::cl::ParseCommandLineOptions(argc, argv, "SPU cost estimator\n");
+
+  // suppress all link logs.
+  spdlog::set_level(spdlog::level::off);
+
+  auto buffer = llvm::MemoryBuffer::getFileOrSTDIN(InputFilename.getValue());
+  SPU_ENFORCE(buffer, "failed to read {}: {}", InputFilename.getValue(),
+              buffer.getError().message());
+
+  std::string code = (*buffer)->getBuffer().str();
+  if (Executable.getValue()) {
+    spu::ExecutableProto exec;
+    SPU_ENFORCE(exec.ParseFromString(code), "invalid ExecutableProto");
+    code = exec.code;
+  }
+
+  auto parsed = spu::device::ParsedExecutable::parse(code);
+  spu::device::CostModel model(makeTable());
+  auto report = model.estimate(parsed->entry());
+
+  spu::device::NetworkModel network;
+  network.latency_ms = LatencyMs.getValue();
+  network.bandwidth_mbps = BandwidthMbps.getValue();
+
+  if (PerOp.getValue()) {
+    fmt::print("{:<32} {:<12} {:>10} {:>16}\n", "op", "loc", "rounds",
+               "bytes");
+    for (const auto &[op, cost] : report.ops) {
+      fmt::print("{:<32} {:<12} {:>10} {:>16}\n",
+                 op->getName().getStringRef().str(), locationOf(op),
+                 cost.rounds, cost.bytes);
+    }
+    fmt::print("\n");
+  }
+
+  fmt::print("{:<32} {:>8} {:>10} {:>16} {:>12}\n", "op", "count", "rounds",
+             "bytes", "seconds");
+  for (const auto &[name, stats] : report.by_kind) {
+    fmt::print("{:<32} {:>8} {:>10} {:>16} {:>12.4f}\n", name, stats.count,
+               stats.cost.rounds, stats.cost.bytes,
+               network.seconds(stats.cost));
+  }
+  fmt::print("{:<32} {:>8} {:>10} {:>16} {:>12.4f}\n", "total",
+             report.ops.size(), report.total.rounds, report.total.bytes,
+             network.seconds(report.total));
+
+  if (!report.unmodeled.empty()) {
+    fmt::print("\nnot counted, ops with secret inputs that are not modeled:\n");
+    for (const auto &[name, count] : report.unmodeled) {
+      fmt::print("{:<32} {:>8}\n", name, count);
+    }
+  }
+
+  return 0;
+}
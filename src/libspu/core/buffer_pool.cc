@@ -0,0 +1,235 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/core/buffer_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "absl/numeric/bits.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu {
+
+namespace {
+
+// 4 classes per power of two, up to 2^63.
+constexpr size_t kClassesPerPow2 = 4;
+constexpr size_t kMinPow2 = 11;  // classes start from (2^11, 2^12]
+constexpr size_t kNumClasses = (64 - kMinPow2) * kClassesPerPow2;
+
+// Blocks cached by one thread, larger ones go to the shared lists.
+constexpr size_t kMaxThreadCacheBytes = 32UL * 1024 * 1024;
+
+// Set once the thread cache is destroyed, buffers freed later by thread local
+// destructors go to the shared lists directly.
+thread_local bool tls_cache_destroyed = false;
+
+}  // namespace
+
+struct BufferPool::ThreadCache {
+  // Taken by the owning thread and by release, which drains every cache.
+  std::mutex mutex;
+  size_t bytes = 0;
+  std::vector<std::vector<void*>> blocks;
+
+  ThreadCache() : blocks(kNumClasses) {
+    auto& pool = BufferPool::instance();
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    pool.thread_caches_.push_back(this);
+  }
+
+  // Drops all blocks, they are no longer counted by the pool.
+  void clear() {
+    auto& pool = BufferPool::instance();
+    for (size_t cls = 0; cls < blocks.size(); ++cls) {
+      for (void* ptr : blocks[cls]) {
+        std::free(ptr);
+        pool.cached_bytes_.fetch_sub(classSize(cls));
+      }
+      blocks[cls].clear();
+    }
+    bytes = 0;
+  }
+
+  // Hands the blocks over to the shared lists when the thread exits.
+  ~ThreadCache() {
+    tls_cache_destroyed = true;
+    auto& pool = BufferPool::instance();
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    auto& caches = pool.thread_caches_;
+    caches.erase(std::find(caches.begin(), caches.end(), this));
+    if (!pool.isActive()) {
+      clear();
+      return;
+    }
+    for (size_t cls = 0; cls < blocks.size(); ++cls) {
+      auto& list = pool.free_lists_[cls];
+      list.insert(list.end(), blocks[cls].begin(), blocks[cls].end());
+    }
+  }
+};
+
+BufferPool::BufferPool() : free_lists_(kNumClasses) {}
+
+BufferPool& BufferPool::instance() {
+  // Leaked on purpose, buffers may be freed during static destruction.
+  static auto* pool = new BufferPool();
+  return *pool;
+}
+
+size_t BufferPool::sizeClass(size_t size) {
+  SPU_ENFORCE(size > (size_t(1) << kMinPow2));
+  // (2^k, 2^(k+1)] is split into kClassesPerPow2 classes.
+  const size_t k = absl::bit_width(size - 1) - 1;
+  const size_t step = (size_t(1) << k) / kClassesPerPow2;
+  const size_t sub = (size - (size_t(1) << k) + step - 1) / step;
+  return (k - kMinPow2) * kClassesPerPow2 + (sub - 1);
+}
+
+size_t BufferPool::classSize(size_t cls) {
+  const size_t k = cls / kClassesPerPow2 + kMinPow2;
+  const size_t sub = cls % kClassesPerPow2 + 1;
+  return (size_t(1) << k) + sub * ((size_t(1) << k) / kClassesPerPow2);
+}
+
+BufferPool::ThreadCache* BufferPool::threadCache() {
+  if (tls_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local ThreadCache cache;
+  return &cache;
+}
+
+std::shared_ptr<yacl::Buffer> BufferPool::allocate(int64_t size) {
+  auto& pool = instance();
+  if (static_cast<size_t>(size) < kMinPooledSize || !pool.isActive()) {
+    return std::make_shared<yacl::Buffer>(size);
+  }
+
+  const size_t cls = sizeClass(size);
+  void* ptr = pool.acquire(cls);
+  return std::make_shared<yacl::Buffer>(
+      ptr, size, [cls](void* p) { BufferPool::instance().recycle(p, cls); });
+}
+
+void* BufferPool::acquire(size_t cls) {
+  const size_t size = classSize(cls);
+  auto take = [&](std::vector<void*>& list) {
+    void* ptr = list.back();
+    list.pop_back();
+    cached_bytes_.fetch_sub(size);
+    num_reused_.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+  };
+
+  auto* cache = threadCache();
+  if (cache != nullptr) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (!cache->blocks[cls].empty()) {
+      cache->bytes -= size;
+      return take(cache->blocks[cls]);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_lists_[cls].empty()) {
+      return take(free_lists_[cls]);
+    }
+  }
+
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void BufferPool::recycle(void* ptr, size_t cls) {
+  const size_t size = classSize(cls);
+  if (!isActive()) {
+    std::free(ptr);
+    return;
+  }
+  // Reserves the bytes first, concurrent frees can not overshoot the budget.
+  if (cached_bytes_.fetch_add(size) + size > max_cached_bytes_.load()) {
+    cached_bytes_.fetch_sub(size);
+    std::free(ptr);
+    return;
+  }
+
+  // Scopes are checked again under the lock of the list, release drains the
+  // lists after the last scope is gone, so no block is left behind.
+  auto* cache = threadCache();
+  if (cache != nullptr) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (isActive() && cache->bytes + size <= kMaxThreadCacheBytes) {
+      cache->bytes += size;
+      cache->blocks[cls].push_back(ptr);
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!isActive()) {
+    cached_bytes_.fetch_sub(size);
+    std::free(ptr);
+    return;
+  }
+  free_lists_[cls].push_back(ptr);
+}
+
+void BufferPool::release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t cls = 0; cls < free_lists_.size(); ++cls) {
+    for (void* ptr : free_lists_[cls]) {
+      std::free(ptr);
+      cached_bytes_.fetch_sub(classSize(cls));
+    }
+    free_lists_[cls].clear();
+  }
+  for (auto* cache : thread_caches_) {
+    std::lock_guard<std::mutex> cache_lock(cache->mutex);
+    cache->clear();
+  }
+}
+
+BufferPool::Scope::Scope(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes) {
+  auto& pool = BufferPool::instance();
+  std::lock_guard<std::mutex> lock(pool.mutex_);
+  pool.scope_budgets_.push_back(max_cached_bytes_);
+  pool.max_cached_bytes_ = *std::max_element(pool.scope_budgets_.begin(),
+                                             pool.scope_budgets_.end());
+  pool.num_scopes_.fetch_add(1);
+}
+
+BufferPool::Scope::~Scope() {
+  auto& pool = BufferPool::instance();
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    auto& budgets = pool.scope_budgets_;
+    budgets.erase(std::find(budgets.begin(), budgets.end(), max_cached_bytes_));
+    pool.max_cached_bytes_ =
+        budgets.empty() ? 0 : *std::max_element(budgets.begin(), budgets.end());
+    last = pool.num_scopes_.fetch_sub(1) == 1;
+  }
+  if (last) {
+    pool.release();
+  }
+}
+
+}  // namespace spu
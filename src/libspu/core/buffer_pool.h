@@ -0,0 +1,104 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yacl/base/buffer.h"
+
+namespace spu {
+
+// Recycles the storage of array buffers.
+//
+// Sizes are rounded up to size classes, 4 per power of two, and freed blocks
+// are kept per class, first in a small per-thread cache then in a shared
+// list, so that the next allocation of a similar size, e.g. the output of the
+// next kernel, reuses the (cache hot) block of the value that was just freed
+// instead of going to the system allocator.
+//
+// Pooling is process wide and active while any Scope is alive. At most
+// `max_cached_bytes` (of the largest alive scope) are kept, the rest is
+// returned to the system. All cached blocks are released when the last scope
+// ends.
+class BufferPool final {
+ public:
+  // Blocks smaller than this are not pooled.
+  static constexpr size_t kMinPooledSize = 4096;
+
+  class Scope final {
+   public:
+    explicit Scope(size_t max_cached_bytes);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    size_t max_cached_bytes_;
+  };
+
+  // Returns a pooled buffer of `size` bytes when pooling is active, a plain
+  // one otherwise.
+  static std::shared_ptr<yacl::Buffer> allocate(int64_t size);
+
+  static BufferPool& instance();
+
+  bool isActive() const {
+    return num_scopes_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // Bytes of blocks kept by the pool, not in use.
+  size_t cachedBytes() const {
+    return cached_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Number of allocations served by cached blocks.
+  size_t numReused() const { return num_reused_.load(); }
+
+  // Returns all cached blocks to the system, including those cached by other
+  // threads.
+  void release();
+
+ private:
+  struct ThreadCache;
+
+  BufferPool();
+
+  static size_t sizeClass(size_t size);
+  static size_t classSize(size_t cls);
+
+  void* acquire(size_t cls);
+  void recycle(void* ptr, size_t cls);
+
+  // Null once the calling thread's cache is destroyed.
+  ThreadCache* threadCache();
+
+  std::atomic<int64_t> num_scopes_{0};
+  std::atomic<size_t> max_cached_bytes_{0};
+  std::atomic<size_t> cached_bytes_{0};
+  std::atomic<size_t> num_reused_{0};
+  std::mutex mutex_;
+  std::vector<std::vector<void*>> free_lists_;
+  std::vector<size_t> scope_budgets_;
+  // Caches of the alive threads, drained by release.
+  std::vector<ThreadCache*> thread_caches_;
+};
+
+}  // namespace spu
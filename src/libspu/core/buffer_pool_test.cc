@@ -0,0 +1,128 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/core/buffer_pool.h"
+
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace spu {
+
+TEST(BufferPoolTest, Inactive) {
+  auto& pool = BufferPool::instance();
+  ASSERT_FALSE(pool.isActive());
+
+  auto reused = pool.numReused();
+  { auto buf = BufferPool::allocate(100000); }
+  auto buf = BufferPool::allocate(100000);
+  EXPECT_EQ(buf->size(), 100000);
+  EXPECT_EQ(pool.numReused(), reused);
+  EXPECT_EQ(pool.cachedBytes(), 0);
+}
+
+TEST(BufferPoolTest, Reuse) {
+  auto& pool = BufferPool::instance();
+  {
+    BufferPool::Scope scope(1 << 20);
+    EXPECT_TRUE(pool.isActive());
+
+    void* ptr = nullptr;
+    {
+      auto buf = BufferPool::allocate(10000);
+      ptr = buf->data();
+    }
+    EXPECT_GT(pool.cachedBytes(), 0);
+
+    // same size class, the freed block is reused.
+    auto reused = pool.numReused();
+    auto buf = BufferPool::allocate(10100);
+    EXPECT_EQ(buf->size(), 10100);
+    EXPECT_EQ(buf->data(), ptr);
+    EXPECT_EQ(pool.numReused(), reused + 1);
+    EXPECT_EQ(pool.cachedBytes(), 0);
+
+    // small buffers are not pooled.
+    { auto small = BufferPool::allocate(100); }
+    EXPECT_EQ(pool.cachedBytes(), 0);
+  }
+  EXPECT_FALSE(pool.isActive());
+  EXPECT_EQ(pool.cachedBytes(), 0);
+}
+
+TEST(BufferPoolTest, Budget) {
+  auto& pool = BufferPool::instance();
+  BufferPool::Scope scope(1 << 16);
+
+  std::vector<std::shared_ptr<yacl::Buffer>> bufs;
+  for (int i = 0; i < 8; ++i) {
+    bufs.push_back(BufferPool::allocate(20000));
+  }
+  bufs.clear();
+  EXPECT_GT(pool.cachedBytes(), 0);
+  EXPECT_LE(pool.cachedBytes(), 1 << 16);
+
+  pool.release();
+  auto reused = pool.numReused();
+  auto buf = BufferPool::allocate(20000);
+  EXPECT_EQ(pool.numReused(), reused);
+  EXPECT_EQ(pool.cachedBytes(), 0);
+}
+
+TEST(BufferPoolTest, DrainThreadCaches) {
+  auto& pool = BufferPool::instance();
+  std::promise<void> freed;
+  std::promise<void> finish;
+  std::thread worker;
+  {
+    BufferPool::Scope scope(1 << 20);
+    worker = std::thread([&] {
+      { auto buf = BufferPool::allocate(10000); }
+      freed.set_value();
+      finish.get_future().wait();
+    });
+    freed.get_future().wait();
+    EXPECT_GT(pool.cachedBytes(), 0);
+  }
+  // the worker is still alive, its cache is drained by the last scope.
+  EXPECT_EQ(pool.cachedBytes(), 0);
+  finish.set_value();
+  worker.join();
+  EXPECT_EQ(pool.cachedBytes(), 0);
+}
+
+TEST(BufferPoolTest, ConcurrentBudget) {
+  auto& pool = BufferPool::instance();
+  constexpr size_t kBudget = 1 << 16;
+  BufferPool::Scope scope(kBudget);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 8; ++t) {
+    workers.emplace_back([] {
+      std::vector<std::shared_ptr<yacl::Buffer>> bufs;
+      for (int i = 0; i < 16; ++i) {
+        bufs.push_back(BufferPool::allocate(20000));
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  EXPECT_GT(pool.cachedBytes(), 0);
+  EXPECT_LE(pool.cachedBytes(), kBudget);
+}
+
+}  // namespace spu
@@ -48,6 +48,9 @@ SPUContext::SPUContext(const RuntimeConfig& config,
     max_cluster_level_concurrency_ = std::min<int32_t>(
         max_cluster_level_concurrency_, config.max_concurrency);
   }
+  if (config.experimental_enable_numa_pinning) {
+    numa_pinning_ = std::make_unique<NumaPinningScope>();
+  }
 
   if (lctx_) {
     auto other_max = yacl::link::AllGather(
@@ -21,6 +21,7 @@
 #include "yacl/link/context.h"
 
 #include "libspu/core/object.h"
+#include "libspu/core/parallel_utils.h"
 #include "libspu/core/prelude.h"
 #include "libspu/core/value.h"
 #include "libspu/spu.h"
@@ -40,6 +41,9 @@ class SPUContext final {
   // Min number of cores in SPU cluster
   int32_t max_cluster_level_concurrency_;
 
+  // Set when the config asks for NUMA pinning, see NumaPinningScope.
+  std::unique_ptr<NumaPinningScope> numa_pinning_;
+
  public:
   explicit SPUContext(const RuntimeConfig& config,
                       const std::shared_ptr<yacl::link::Context>& lctx);
@@ -76,9 +80,11 @@ class SPUContext final {
   bool hasKernel(const std::string& name) const {
     return prot_->hasKernel(name);
   }
+  bool hasKernel(KernelId id) const { return prot_->hasKernel(id); }
   Kernel* getKernel(const std::string& name) const {
     return prot_->getKernel(name);
   }
+  Kernel* getKernel(KernelId id) const { return prot_->getKernel(id); }
   template <typename StateT>
   StateT* getState() {
     return prot_->template getState<StateT>();
@@ -136,6 +142,7 @@ class KernelEvalContext final {
   bool hasKernel(const std::string& name) const {
     return sctx_->prot()->hasKernel(name);
   }
+  bool hasKernel(KernelId id) const { return sctx_->prot()->hasKernel(id); }
 
   size_t numParams() const { return params_.size(); }
   size_t numOutputs() const { return outputs_.size(); }
@@ -189,30 +196,39 @@ void bindParams(KernelEvalContext* ectx, First&& head, Args&&... tail) {
   }
 }
 
-}  // namespace detail
-
-// Dynamic dispatch to a kernel according to a symbol name.
-template <typename Ret = Value, typename... Args>
-Ret dynDispatch(SPUContext* sctx, const std::string& name, Args&&... args) {
-  /// Steps of dynamic dispatch.
-  // 1. find a prop kernel.
-  Kernel* kernel = sctx->prot()->getKernel(name);
-
-  // 2. prep parameters (flatten it into an evaluation context).
+template <typename Ret, typename... Args>
+Ret evalKernel(SPUContext* sctx, Kernel* kernel, Args&&... args) {
+  // 1. prep parameters (flatten it into an evaluation context).
   KernelEvalContext ectx(sctx);
-  detail::bindParams(&ectx, std::forward<Args>(args)...);
+  bindParams(&ectx, std::forward<Args>(args)...);
 
-  // 3. call a visitor, visit a kernel with params.
+  // 2. call a visitor, visit a kernel with params.
   // TODO: use a visitor to call different stage of a kernel
   kernel->evaluate(&ectx);
 
-  // 4. steal the result and return it.
+  // 3. steal the result and return it.
   if (ectx.numOutputs() > 0) {
     return ectx.consumeOutput<Ret>(0);
   }
   return Ret();
 }
 
+}  // namespace detail
+
+// Dynamic dispatch to a kernel according to a symbol name.
+template <typename Ret = Value, typename... Args>
+Ret dynDispatch(SPUContext* sctx, const std::string& name, Args&&... args) {
+  Kernel* kernel = sctx->prot()->getKernel(name);
+  return detail::evalKernel<Ret>(sctx, kernel, std::forward<Args>(args)...);
+}
+
+// Dynamic dispatch to a kernel according to an interned kernel id.
+template <typename Ret = Value, typename... Args>
+Ret dynDispatch(SPUContext* sctx, KernelId id, Args&&... args) {
+  Kernel* kernel = sctx->prot()->getKernel(id);
+  return detail::evalKernel<Ret>(sctx, kernel, std::forward<Args>(args)...);
+}
+
 // helper class
 template <typename T>
 using OptionalAPI = std::optional<T>;
@@ -20,6 +20,8 @@
 #include <set>
 #include <utility>
 
+#include "libspu/core/buffer_pool.h"
+
 namespace spu {
 namespace {
 
@@ -180,11 +182,11 @@ NdArrayRef::NdArrayRef(std::shared_ptr<yacl::Buffer> buf, Type eltype,
 // constructor, create a new buffer of elements and ref to it.
 NdArrayRef::NdArrayRef(const Type& eltype, const Shape& shape)
     : NdArrayRef(
-          std::make_shared<yacl::Buffer>(shape.numel() * eltype.size()),  // buf
-          eltype,                     // eltype
-          shape,                      // shape
-          makeCompactStrides(shape),  // strides
-          0                           // offset
+          BufferPool::allocate(shape.numel() * eltype.size()),  // buf
+          eltype,                                               // eltype
+          shape,                                                // shape
+          makeCompactStrides(shape),                            // strides
+          0                                                     // offset
       ) {}
 
 NdArrayRef NdArrayRef::as(const Type& new_ty, bool force) const {
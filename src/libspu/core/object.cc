@@ -14,7 +14,71 @@
 
 #include "libspu/core/object.h"
 
+#include <algorithm>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace spu {
+namespace {
+
+class KernelNameRegistry final {
+  mutable std::shared_mutex mu_;
+  std::unordered_map<std::string_view, KernelId> ids_;
+  // deque keeps the address of names stable, ids_ refers to them.
+  std::deque<std::string> names_;
+
+ public:
+  static KernelNameRegistry& instance() {
+    static KernelNameRegistry registry;
+    return registry;
+  }
+
+  KernelId intern(std::string_view name) {
+    if (auto id = lookup(name)) {
+      return *id;
+    }
+
+    std::unique_lock lk(mu_);
+    auto itr = ids_.find(name);
+    if (itr != ids_.end()) {
+      return itr->second;
+    }
+    const auto id = static_cast<KernelId>(names_.size());
+    const auto& stored = names_.emplace_back(name);
+    ids_.emplace(stored, id);
+    return id;
+  }
+
+  std::optional<KernelId> lookup(std::string_view name) const {
+    std::shared_lock lk(mu_);
+    auto itr = ids_.find(name);
+    if (itr == ids_.end()) {
+      return std::nullopt;
+    }
+    return itr->second;
+  }
+
+  const std::string& name(KernelId id) const {
+    std::shared_lock lk(mu_);
+    SPU_ENFORCE(id < names_.size(), "invalid kernel id={}", id);
+    return names_[id];
+  }
+};
+
+}  // namespace
+
+KernelId internKernelName(std::string_view name) {
+  return KernelNameRegistry::instance().intern(name);
+}
+
+std::optional<KernelId> lookupKernelName(std::string_view name) {
+  return KernelNameRegistry::instance().lookup(name);
+}
+
+const std::string& getKernelName(KernelId id) {
+  return KernelNameRegistry::instance().name(id);
+}
 
 std::unique_ptr<State> State::fork() {
   SPU_THROW("Not implemented, the sub class should override this");
@@ -39,22 +103,58 @@ bool Object::hasLowCostFork() const {
   return true;
 }
 
+void Object::flush() {
+  for (const auto& [key, val] : states_) {
+    val->flush();
+  }
+}
+
+void Object::hint(const std::vector<KernelHint>& calls) {
+  for (const auto& [key, val] : states_) {
+    val->hint(calls);
+  }
+}
+
+std::vector<std::string> Object::describeStats() const {
+  std::vector<std::string> ret;
+  for (const auto& [key, val] : states_) {
+    for (auto& line : val->describeStats()) {
+      ret.emplace_back(fmt::format("{}: {}", key, line));
+    }
+  }
+  return ret;
+}
+
 void Object::regKernel(const std::string& name,
                        std::unique_ptr<Kernel> kernel) {
-  const auto itr = kernels_.find(name);
-  SPU_ENFORCE(itr == kernels_.end(), "kernel={} already exist", name);
-  kernels_.insert({name, std::move(kernel)});
+  const auto id = internKernelName(name);
+  SPU_ENFORCE(!hasKernel(id), "kernel={} already exist", name);
+  if (id >= kernels_.size()) {
+    kernels_.resize(id + 1);
+  }
+  kernels_[id] = std::move(kernel);
 }
 
 Kernel* Object::getKernel(const std::string& name) const {
-  const auto itr = kernels_.find(name);
-  SPU_ENFORCE(itr != kernels_.end(), "kernel={} not found", name);
-  return itr->second.get();
+  const auto id = lookupKernelName(name);
+  SPU_ENFORCE(id.has_value() && hasKernel(*id), "kernel={} not found", name);
+  return kernels_[*id].get();
 }
 
 bool Object::hasKernel(const std::string& name) const {
-  const auto itr = kernels_.find(name);
-  return itr != kernels_.end();
+  const auto id = lookupKernelName(name);
+  return id.has_value() && hasKernel(*id);
+}
+
+std::vector<std::string> Object::getKernelNames() const {
+  std::vector<std::string> names;
+  for (KernelId id = 0; id < kernels_.size(); ++id) {
+    if (kernels_[id] != nullptr) {
+      names.push_back(getKernelName(id));
+    }
+  }
+  std::sort(names.begin(), names.end());
+  return names;
 }
 
 }  // namespace spu
@@ -16,7 +16,10 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "libspu/core/cexpr.h"
 #include "libspu/core/prelude.h"
@@ -29,6 +32,25 @@ namespace spu {
 // - State: the dynamic member variable.
 // - Object: the dynamic binding object.
 
+// Kernel names are interned to dense ids, so a protocol could keep its kernels
+// in a flat table and dispatching is an index instead of a string lookup.
+//
+// Ids are assigned on first use and stay valid for the lifetime of the
+// process, callers on the hot path are expected to cache them, i.e.
+//
+//   static const KernelId kId = internKernelName("mul_aa");
+//   if (ctx->hasKernel(kId)) { ... }
+using KernelId = uint32_t;
+
+// Return the id of the name, assign a new one if it's never seen.
+KernelId internKernelName(std::string_view name);
+
+// Return the id of the name, or nullopt if it's never interned.
+std::optional<KernelId> lookupKernelName(std::string_view name);
+
+// Return the name of an interned id.
+const std::string& getKernelName(KernelId id);
+
 class KernelEvalContext;
 class Kernel {
  public:
@@ -71,6 +93,15 @@ class Kernel {
   virtual void evaluate(KernelEvalContext* ectx) const = 0;
 };
 
+// A kernel call expected to happen soon, see State::hint.
+struct KernelHint {
+  std::string name;
+  // elements of the output, 1 for matmuls, whose shapes are in params.
+  size_t numel = 0;
+  // kernel specific variables, same as the ones of Kernel::comm, e.g. m/n/k.
+  ce::Params params;
+};
+
 class State {
  public:
   virtual ~State() = default;
@@ -80,13 +111,26 @@ class State {
 
   // TODO: this is a const method.
   virtual std::unique_ptr<State> fork();
+
+  // Completes deferred work, e.g. pending checks of opened values. Called at
+  // the end of an execution and before a forked state is dropped.
+  virtual void flush() {}
+
+  // Announces kernel calls which are likely to come next on this state, in
+  // call order, e.g. so correlated randomness is generated ahead of time.
+  // Only a hint, the actual calls may differ.
+  virtual void hint(const std::vector<KernelHint>& /*calls*/) {}
+
+  // Human readable statistics for the profiling output, one per line.
+  virtual std::vector<std::string> describeStats() const { return {}; }
 };
 
 // A dynamic object contains a set of kernels and a set of states.
 //
 // Class that inherit from this class could do `dynamic binding`.
 class Object final {
-  std::map<std::string, std::shared_ptr<Kernel>> kernels_;
+  // indexed by KernelId, null if the kernel is not registered.
+  std::vector<std::shared_ptr<Kernel>> kernels_;
   std::map<std::string, std::unique_ptr<State>> states_;
 
   std::string id_;   // this object id.
@@ -108,6 +152,15 @@ class Object final {
 
   bool hasLowCostFork() const;
 
+  // Flushes all states, see State::flush.
+  void flush();
+
+  // Hints all states, see State::hint.
+  void hint(const std::vector<KernelHint>& calls);
+
+  // Statistics of all states, prefixed by the state name.
+  std::vector<std::string> describeStats() const;
+
   void regKernel(const std::string& name, std::unique_ptr<Kernel> kernel);
 
   template <typename KernelT>
@@ -129,6 +182,14 @@ class Object final {
   Kernel* getKernel(const std::string& name) const;
   bool hasKernel(const std::string& name) const;
 
+  Kernel* getKernel(KernelId id) const {
+    SPU_ENFORCE(hasKernel(id), "kernel={} not found", getKernelName(id));
+    return kernels_[id].get();
+  }
+  bool hasKernel(KernelId id) const {
+    return id < kernels_.size() && kernels_[id] != nullptr;
+  }
+
   void addState(const std::string& name, std::unique_ptr<State> state) {
     const auto& itr = states_.find(name);
     SPU_ENFORCE(itr == states_.end(), "state={} already exist", name);
@@ -150,14 +211,7 @@ class Object final {
   }
 
   //
-  std::vector<std::string> getKernelNames() const {
-    std::vector<std::string> names;
-    names.reserve(kernels_.size());
-    for (auto const& itr : kernels_) {
-      names.push_back(itr.first);
-    }
-    return names;
-  }
+  std::vector<std::string> getKernelNames() const;
 };
 
 }  // namespace spu
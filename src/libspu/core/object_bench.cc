@@ -0,0 +1,103 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+
+#include "libspu/core/context.h"
+#include "libspu/core/object.h"
+
+namespace spu {
+
+namespace {
+
+// Kernel with negligible body, so the benchmark measures dispatch only, as
+// with small tensors where the protocol work is tiny.
+class NopKernel : public Kernel {
+ public:
+  void evaluate(KernelEvalContext* ectx) const override {
+    ectx->pushOutput(ectx->getParam<int64_t>(0));
+  }
+};
+
+// A protocol registers a couple hundred kernels.
+constexpr size_t kNumKernels = 200;
+
+std::string kernelName(size_t idx) { return fmt::format("bench_k{}", idx); }
+
+std::unique_ptr<Object> makeObject() {
+  auto obj = std::make_unique<Object>("bench");
+  for (size_t idx = 0; idx < kNumKernels; ++idx) {
+    obj->regKernel<NopKernel>(kernelName(idx));
+  }
+  return obj;
+}
+
+// The previous layout, kernels in a string keyed tree, hasKernel followed by
+// getKernel on every call.
+void BMDispatchByNameMap(benchmark::State& state) {
+  std::map<std::string, std::shared_ptr<Kernel>> kernels;
+  for (size_t idx = 0; idx < kNumKernels; ++idx) {
+    kernels.emplace(kernelName(idx), std::make_shared<NopKernel>());
+  }
+  const std::string name = kernelName(kNumKernels / 2);
+
+  for (auto _ : state) {
+    if (kernels.find(name) != kernels.end()) {
+      KernelEvalContext ectx(nullptr);
+      ectx.pushParam(int64_t{1});
+      kernels.find(name)->second->evaluate(&ectx);
+      benchmark::DoNotOptimize(ectx.consumeOutput<int64_t>(0));
+    }
+  }
+}
+BENCHMARK(BMDispatchByNameMap);
+
+// String API on the interned table.
+void BMDispatchByName(benchmark::State& state) {
+  const auto obj = makeObject();
+  const std::string name = kernelName(kNumKernels / 2);
+
+  for (auto _ : state) {
+    if (obj->hasKernel(name)) {
+      KernelEvalContext ectx(nullptr);
+      ectx.pushParam(int64_t{1});
+      obj->getKernel(name)->evaluate(&ectx);
+      benchmark::DoNotOptimize(ectx.consumeOutput<int64_t>(0));
+    }
+  }
+}
+BENCHMARK(BMDispatchByName);
+
+// Id API, as used by mpc dispatch macros.
+void BMDispatchById(benchmark::State& state) {
+  const auto obj = makeObject();
+  const KernelId id = internKernelName(kernelName(kNumKernels / 2));
+
+  for (auto _ : state) {
+    if (obj->hasKernel(id)) {
+      KernelEvalContext ectx(nullptr);
+      ectx.pushParam(int64_t{1});
+      obj->getKernel(id)->evaluate(&ectx);
+      benchmark::DoNotOptimize(ectx.consumeOutput<int64_t>(0));
+    }
+  }
+}
+BENCHMARK(BMDispatchById);
+
+}  // namespace
+
+}  // namespace spu
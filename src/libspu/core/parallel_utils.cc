@@ -14,4 +14,148 @@
 
 #include "libspu/core/parallel_utils.h"
 
-namespace spu {}  // namespace spu
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace spu {
+
+namespace {
+
+#ifdef __linux__
+// Parses a sysfs cpu list, e.g. "0-47,96-143".
+std::vector<int> parseCpuList(const std::string& str) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < str.size()) {
+    auto next = str.find(',', pos);
+    if (next == std::string::npos) {
+      next = str.size();
+    }
+    const auto item = str.substr(pos, next - pos);
+    const auto dash = item.find('-');
+    try {
+      const int first = std::stoi(item.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception&) {
+      return {};
+    }
+    pos = next + 1;
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int>> numaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+  for (size_t node = 0;; ++node) {
+    std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) +
+                      "/cpulist");
+    std::string line;
+    if (!ifs || !std::getline(ifs, line)) {
+      break;
+    }
+    auto cpus = parseCpuList(line);
+    if (!cpus.empty()) {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+  return nodes;
+}
+#endif
+
+}  // namespace
+
+NumaPinningScope::NumaPinningScope() {
+  detail::g_numa_pinning_scopes.fetch_add(1, std::memory_order_relaxed);
+}
+
+NumaPinningScope::~NumaPinningScope() {
+  detail::g_numa_pinning_scopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+namespace detail {
+
+std::atomic<int64_t> g_numa_pinning_scopes{0};
+std::atomic<int64_t> g_pinned_workers{0};
+
+namespace {
+
+struct WorkerAffinity {
+  bool pinned = false;
+#ifdef __linux__
+  // affinity before pinning, restored by unpinWorker.
+  cpu_set_t saved;
+#endif
+
+  ~WorkerAffinity() {
+    if (pinned) {
+      g_pinned_workers.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+};
+
+thread_local WorkerAffinity tls_affinity;
+
+}  // namespace
+
+void pinWorker() {
+  auto& affinity = tls_affinity;
+  if (affinity.pinned) {
+    return;
+  }
+
+#ifdef __linux__
+  static const auto nodes = numaNodeCpus();
+  if (nodes.size() < 2 ||
+      pthread_getaffinity_np(pthread_self(), sizeof(affinity.saved),
+                             &affinity.saved) != 0) {
+    return;
+  }
+  static std::atomic<size_t> next_node{0};
+  const auto& cpus = nodes[next_node.fetch_add(1) % nodes.size()];
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  // Pinning is a hint, the worker keeps its affinity if it fails.
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    affinity.pinned = true;
+    g_pinned_workers.fetch_add(1, std::memory_order_relaxed);
+  }
+#endif
+}
+
+void unpinWorker() {
+  auto& affinity = tls_affinity;
+  if (!affinity.pinned) {
+    return;
+  }
+  affinity.pinned = false;
+  g_pinned_workers.fetch_sub(1, std::memory_order_relaxed);
+#ifdef __linux__
+  pthread_setaffinity_np(pthread_self(), sizeof(affinity.saved),
+                         &affinity.saved);
+#endif
+}
+
+int64_t grainSize(TaskCost cost) {
+  return std::max<int64_t>(
+      1, kMinTaskSize / std::max<int64_t>(1, cost.cycles_per_element));
+}
+
+}  // namespace detail
+
+}  // namespace spu
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <thread>
 
 #include "yacl/utils/parallel.h"
 
@@ -23,21 +25,93 @@ namespace spu {
 
 constexpr int64_t kMinTaskSize = 50000;
 
+// Estimated cost of one element of a pforeach body, in cpu cycles, e.g. one
+// for a ring add and a few hundreds for a PRG expansion. The range is split
+// into tasks of about kMinTaskSize cycles.
+struct TaskCost {
+  int64_t cycles_per_element = 1;
+};
+
+// Spreads the workers of the parallel pool over NUMA nodes, round-robin,
+// while a scope is alive, e.g. one per context that asks for it. Each worker
+// is bound to the cpus of its node the first time it runs a pforeach task, and
+// gets its former affinity back on its first task after the last scope ended.
+// Threads calling pforeach are never pinned. It is a no-op on hosts with a
+// single node.
+class NumaPinningScope final {
+ public:
+  NumaPinningScope();
+  ~NumaPinningScope();
+
+  NumaPinningScope(const NumaPinningScope&) = delete;
+  NumaPinningScope& operator=(const NumaPinningScope&) = delete;
+};
+
+namespace detail {
+
+extern std::atomic<int64_t> g_numa_pinning_scopes;
+extern std::atomic<int64_t> g_pinned_workers;
+
+void pinWorker();
+void unpinWorker();
+
+int64_t grainSize(TaskCost cost);
+
+template <class F>
+void parallelFor(int64_t begin, int64_t end, int64_t grain, F&& f) {
+  const bool pin = g_numa_pinning_scopes.load(std::memory_order_relaxed) > 0;
+  if (!pin && g_pinned_workers.load(std::memory_order_relaxed) == 0) {
+    return yacl::parallel_for(begin, end, grain, f);
+  }
+  const auto caller = std::this_thread::get_id();
+  yacl::parallel_for(begin, end, grain, [&](int64_t begin, int64_t end) {
+    if (std::this_thread::get_id() != caller) {
+      if (pin) {
+        pinWorker();
+      } else {
+        unpinWorker();
+      }
+    }
+    f(begin, end);
+  });
+}
+
+template <class F>
+auto asRange(F& f) {
+  if constexpr (std::is_invocable_v<F&, int64_t, int64_t>) {
+    return [&f](int64_t begin, int64_t end) { f(begin, end); };
+  } else {
+    return [&f](int64_t begin, int64_t end) {
+      for (int64_t idx = begin; idx < end; ++idx) {
+        f(idx);
+      }
+    };
+  }
+}
+
+}  // namespace detail
+
 template <class F>
 inline auto pforeach(int64_t begin, int64_t end, F&& f) -> std::enable_if_t<
     std::is_same_v<decltype(f(int64_t(), int64_t())), void>> {
-  return yacl::parallel_for(begin, end, kMinTaskSize, f);
+  return detail::parallelFor(begin, end, kMinTaskSize, f);
 }
 
 template <class F>
 inline auto pforeach(int64_t begin, int64_t end, F&& f)
     -> std::enable_if_t<std::is_same_v<decltype(f(int64_t())), void>> {
-  return yacl::parallel_for(begin, end, kMinTaskSize,
-                            [&f](int64_t begin, int64_t end) {
-                              for (int64_t idx = begin; idx < end; ++idx) {
-                                f(idx);
-                              }
-                            });
+  return detail::parallelFor(begin, end, kMinTaskSize,
+                             [&f](int64_t begin, int64_t end) {
+                               for (int64_t idx = begin; idx < end; ++idx) {
+                                 f(idx);
+                               }
+                             });
+}
+
+// pforeach with a per element cost hint.
+template <class F>
+inline void pforeach(int64_t begin, int64_t end, TaskCost cost, F&& f) {
+  detail::parallelFor(begin, end, detail::grainSize(cost), detail::asRange(f));
 }
 
 }  // namespace spu
@@ -0,0 +1,99 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "libspu/core/parallel_utils.h"
+
+// Scaling curves of pforeach, over the number of threads, for a cheap body
+// (one round, like a ring add) and an expensive one (hundreds of rounds, like
+// a PRG expansion), with the default and cost hinted grain sizes.
+
+namespace spu {
+
+namespace {
+
+// One round is a dependent multiply-xorshift, a few cycles.
+inline uint64_t mix(uint64_t x, int64_t rounds) {
+  for (int64_t r = 0; r < rounds; ++r) {
+    x = (x ^ (x >> 31)) * 0x9e3779b97f4a7c15ULL;
+  }
+  return x;
+}
+
+void makeArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"numel", "rounds", "threads"});
+  b->ArgsProduct({
+      {1 << 12, 1 << 16, 1 << 20},  // numel
+      {1, 200},                     // rounds per element
+      benchmark::CreateRange(1, 64, /*multi=*/2),
+  });
+  b->UseRealTime();
+}
+
+struct Setup {
+  explicit Setup(const benchmark::State& state)
+      : numel(state.range(0)),
+        rounds(state.range(1)),
+        data(numel),
+        prev_threads(yacl::get_num_threads()) {
+    yacl::set_num_threads(static_cast<int>(state.range(2)));
+    for (int64_t idx = 0; idx < numel; ++idx) {
+      data[idx] = idx;
+    }
+  }
+
+  ~Setup() { yacl::set_num_threads(prev_threads); }
+
+  int64_t numel;
+  int64_t rounds;
+  std::vector<uint64_t> data;
+  int prev_threads;
+};
+
+void BM_PforeachDefault(benchmark::State& state) {
+  Setup s(state);
+  for (auto _ : state) {
+    pforeach(0, s.numel,
+             [&](int64_t idx) { s.data[idx] = mix(s.data[idx], s.rounds); });
+  }
+  state.SetItemsProcessed(state.iterations() * s.numel);
+}
+
+void BM_PforeachCostHint(benchmark::State& state) {
+  Setup s(state);
+  // about three cycles per round.
+  const TaskCost cost{3 * s.rounds};
+  for (auto _ : state) {
+    pforeach(0, s.numel, cost,
+             [&](int64_t idx) { s.data[idx] = mix(s.data[idx], s.rounds); });
+  }
+  state.SetItemsProcessed(state.iterations() * s.numel);
+}
+
+void BM_PforeachCostHintNumaPinned(benchmark::State& state) {
+  NumaPinningScope pinning;
+  BM_PforeachCostHint(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PforeachDefault)->Apply(makeArgs);
+BENCHMARK(BM_PforeachCostHint)->Apply(makeArgs);
+BENCHMARK(BM_PforeachCostHintNumaPinned)->Apply(makeArgs);
+
+}  // namespace spu
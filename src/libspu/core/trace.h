@@ -125,6 +125,9 @@ int64_t genActionUuid();
 #define TR_REC 0x0800               // record the action
 #define TR_LOG (TR_LOGB | TR_LOGE)  // log action begin & end
 #define TR_LAR (TR_LOG | TR_REC)    // log and record the action
+// the action is part of another recorded action of the same module, it is
+// listed in the profile but not added to the module total.
+#define TR_NESTED 0x1000
 
 /////////////////////////////////////////////////////////////
 /// Helper macros for modules.
@@ -16,6 +16,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <map>
+#include <utility>
 
 #include "fmt/format.h"
 
@@ -37,6 +40,69 @@ Visibility getVisibilityFromType(const Type& ty) {
   }
 }
 
+std::pair<Type, Shape> parseMeta(const pb::ValueMetaProto& meta) {
+  auto eltype = Type::fromString(meta.storage_type());
+
+  auto data_type = DataType(meta.data_type());
+  SPU_ENFORCE(data_type != DataType::DT_INVALID, "invalid data type={}",
+              data_type);
+
+  // vtype is deduced from storage_type.
+  auto visibility = Visibility(meta.visibility());
+  SPU_ENFORCE(visibility == getVisibilityFromType(eltype),
+              "visibility {} does not match storage_type {}", visibility,
+              eltype);
+
+  Shape shape(meta.shape().dims().begin(), meta.shape().dims().end());
+  return {std::move(eltype), std::move(shape)};
+}
+
+// Protobuf wire format of pb::ValueChunkProto.
+constexpr uint32_t kTotalBytesField = 1;
+constexpr uint32_t kChunkOffsetField = 2;
+constexpr uint32_t kContentField = 3;
+
+constexpr uint32_t kVarintWireType = 0;
+constexpr uint32_t kFixed64WireType = 1;
+constexpr uint32_t kLengthDelimitedWireType = 2;
+constexpr uint32_t kFixed32WireType = 5;
+
+constexpr uint8_t makeTag(uint32_t field, uint32_t wire_type) {
+  return static_cast<uint8_t>((field << 3) | wire_type);
+}
+
+size_t varintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+uint8_t* writeVarint(uint64_t value, uint8_t* target) {
+  while (value >= 0x80) {
+    *target++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *target++ = static_cast<uint8_t>(value);
+  return target;
+}
+
+const uint8_t* readVarint(const uint8_t* ptr, const uint8_t* end,
+                          uint64_t* value) {
+  *value = 0;
+  for (size_t shift = 0; shift < 64; shift += 7) {
+    SPU_ENFORCE(ptr < end, "truncated ValueChunkProto");
+    const uint8_t byte = *ptr++;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return ptr;
+    }
+  }
+  SPU_THROW("malformed varint in ValueChunkProto");
+}
+
 }  // namespace
 
 Value::Value(NdArrayRef data, DataType dtype)
@@ -70,13 +136,14 @@ size_t Value::chunksCount(size_t max_chunk_size) const {
   return num_chunks;
 }
 
-ValueProto Value::toProto(size_t max_chunk_size) const {
+ValueProtoView Value::toProtoView(size_t max_chunk_size) const {
   SPU_ENFORCE(max_chunk_size > 0);
   SPU_ENFORCE(dtype_ != DT_INVALID && vtype() != VIS_INVALID, "{}", *this);
 
-  ValueProto ret;
+  ValueProtoView ret;
 
-  auto build_chunk = [&](const void* data, size_t size, size_t num_chunks) {
+  auto build_chunk = [&](const std::shared_ptr<yacl::Buffer>& holder,
+                         const void* data, size_t size, size_t num_chunks) {
     if (size == 0) {
       return;
     }
@@ -85,13 +152,12 @@ ValueProto Value::toProto(size_t max_chunk_size) const {
       size_t chunk_size = std::min(max_chunk_size, size - i * max_chunk_size);
 
       size_t offset = i * max_chunk_size;
-      pb::ValueChunkProto chunk;
-      chunk.set_total_bytes(size);
-      chunk.set_chunk_offset(offset);
-      if (chunk_size > 0) {
-        chunk.set_content(static_cast<const uint8_t*>(data) + offset,
-                          chunk_size);
-      }
+      ValueChunkView chunk;
+      chunk.total_bytes = size;
+      chunk.chunk_offset = offset;
+      chunk.content = std::string_view(static_cast<const char*>(data) + offset,
+                                       chunk_size);
+      chunk.holder = holder;
       ret.chunks.emplace_back(std::move(chunk));
     }
   };
@@ -100,12 +166,12 @@ ValueProto Value::toProto(size_t max_chunk_size) const {
 
   auto array_to_chunks = [&](const NdArrayRef& a) {
     if (a.isCompact()) {
-      build_chunk(a.data(), numel() * a.elsize(), num_chunks);
+      build_chunk(a.buf(), a.data(), numel() * a.elsize(), num_chunks);
     } else {
       // Make a compact clone
       auto copy = a.clone();
       SPU_ENFORCE(copy.isCompact(), "Must be a compact copy.");
-      build_chunk(copy.data(), copy.buf()->size(), num_chunks);
+      build_chunk(copy.buf(), copy.data(), copy.buf()->size(), num_chunks);
     }
   };
 
@@ -119,6 +185,23 @@ ValueProto Value::toProto(size_t max_chunk_size) const {
   return ret;
 }
 
+ValueProto Value::toProto(size_t max_chunk_size) const {
+  auto view = toProtoView(max_chunk_size);
+
+  ValueProto ret;
+  ret.chunks.reserve(view.chunks.size());
+  for (const auto& c : view.chunks) {
+    pb::ValueChunkProto chunk;
+    chunk.set_total_bytes(c.total_bytes);
+    chunk.set_chunk_offset(c.chunk_offset);
+    chunk.set_content(c.content.data(), c.content.size());
+    ret.chunks.emplace_back(std::move(chunk));
+  }
+  ret.meta.Swap(&view.meta);
+
+  return ret;
+}
+
 pb::ValueMetaProto Value::toMetaProto() const {
   SPU_ENFORCE(dtype_ != DT_INVALID && vtype() != VIS_INVALID);
 
@@ -134,46 +217,47 @@ pb::ValueMetaProto Value::toMetaProto() const {
 }
 
 Value Value::fromProto(const ValueProto& value) {
+  ValueProtoView view;
+  view.meta = value.meta;
+  view.chunks.reserve(value.chunks.size());
+  for (const auto& c : value.chunks) {
+    ValueChunkView chunk;
+    chunk.total_bytes = c.total_bytes();
+    chunk.chunk_offset = c.chunk_offset();
+    chunk.content = c.content();
+    view.chunks.emplace_back(std::move(chunk));
+  }
+  return fromProtoView(view);
+}
+
+Value Value::fromProtoView(const ValueProtoView& value) {
   const auto& meta = value.meta;
   if (meta.is_complex()) {
     // real
-    pb::ValueMetaProto partial = value.meta;
-    partial.set_is_complex(false);
-    ValueProto partial_proto;
-    partial_proto.meta = partial;
+    ValueProtoView partial_proto;
+    partial_proto.meta = meta;
+    partial_proto.meta.set_is_complex(false);
     auto n = value.chunks.size() / 2;
     std::copy_n(value.chunks.begin(), n,
                 std::back_inserter(partial_proto.chunks));
-    auto rv = fromProto(partial_proto);
+    auto rv = fromProtoView(partial_proto);
 
     partial_proto.chunks.clear();
     std::copy_n(value.chunks.begin() + n, n,
                 std::back_inserter(partial_proto.chunks));
-    auto iv = fromProto(partial_proto);
+    auto iv = fromProtoView(partial_proto);
     return Value(rv.data(), iv.data(), rv.dtype());
   }
 
-  const auto eltype = Type::fromString(meta.storage_type());
-
-  auto data_type = DataType(meta.data_type());
-  SPU_ENFORCE(data_type != DataType::DT_INVALID, "invalid data type={}",
-              data_type);
-
-  // vtype is deduced from storage_type.
-  auto visibility = Visibility(meta.visibility());
-  SPU_ENFORCE(visibility == getVisibilityFromType(eltype),
-              "visibility {} does not match storage_type {}", visibility,
-              eltype);
-
-  Shape shape(meta.shape().dims().begin(), meta.shape().dims().end());
+  const auto [eltype, shape] = parseMeta(meta);
 
   const auto& chunks = value.chunks;
-  const size_t total_bytes = chunks.empty() ? 0 : chunks[0].total_bytes();
+  const size_t total_bytes = chunks.empty() ? 0 : chunks[0].total_bytes;
 
-  std::map<size_t, const pb::ValueChunkProto*> ordered_chunks;
+  std::map<size_t, const ValueChunkView*> ordered_chunks;
   for (const auto& s : chunks) {
-    SPU_ENFORCE(ordered_chunks.insert({s.chunk_offset(), &s}).second,
-                "Repeated chunk_offset {} found", s.chunk_offset());
+    SPU_ENFORCE(ordered_chunks.insert({s.chunk_offset, &s}).second,
+                "Repeated chunk_offset {} found", s.chunk_offset);
   }
 
   NdArrayRef data(eltype, shape);
@@ -183,9 +267,9 @@ Value Value::fromProto(const ValueProto& value) {
   for (const auto& [offset, chunk] : ordered_chunks) {
     SPU_ENFORCE(offset == chunk_end_pos,
                 "offset {} is not match to last chunk's end pos", offset);
-    memcpy(data.data<uint8_t>() + offset, chunk->content().data(),
-           chunk->content().size());
-    chunk_end_pos += chunk->content().size();
+    memcpy(data.data<uint8_t>() + offset, chunk->content.data(),
+           chunk->content.size());
+    chunk_end_pos += chunk->content.size();
   }
 
   SPU_ENFORCE(total_bytes == chunk_end_pos);
@@ -193,6 +277,112 @@ Value Value::fromProto(const ValueProto& value) {
   return Value(data, spu::DataType(meta.data_type()));
 }
 
+Value Value::fromBuffer(const pb::ValueMetaProto& meta,
+                        std::shared_ptr<yacl::Buffer> buf) {
+  SPU_ENFORCE(buf != nullptr);
+  const auto [eltype, shape] = parseMeta(meta);
+
+  const int64_t part_bytes = shape.numel() * eltype.size();
+  const int64_t num_parts = meta.is_complex() ? 2 : 1;
+  SPU_ENFORCE(buf->size() == part_bytes * num_parts,
+              "buffer size mismatch, expect={}, got={}", part_bytes * num_parts,
+              buf->size());
+
+  const auto strides = makeCompactStrides(shape);
+  NdArrayRef real(buf, eltype, shape, strides, 0);
+  if (meta.is_complex()) {
+    NdArrayRef imag(buf, eltype, shape, strides, part_bytes);
+    return Value(real, imag, spu::DataType(meta.data_type()));
+  }
+  return Value(real, spu::DataType(meta.data_type()));
+}
+
+size_t ValueChunkView::serializedSize() const {
+  size_t size = 0;
+  if (total_bytes != 0) {
+    size += 1 + varintSize(total_bytes);
+  }
+  if (chunk_offset != 0) {
+    size += 1 + varintSize(chunk_offset);
+  }
+  if (!content.empty()) {
+    size += 1 + varintSize(content.size()) + content.size();
+  }
+  return size;
+}
+
+void ValueChunkView::serializeToArray(uint8_t* target) const {
+  // Same field order and encoding as pb::ValueChunkProto, zero (default)
+  // fields are omitted.
+  if (total_bytes != 0) {
+    *target++ = makeTag(kTotalBytesField, kVarintWireType);
+    target = writeVarint(total_bytes, target);
+  }
+  if (chunk_offset != 0) {
+    *target++ = makeTag(kChunkOffsetField, kVarintWireType);
+    target = writeVarint(chunk_offset, target);
+  }
+  if (!content.empty()) {
+    *target++ = makeTag(kContentField, kLengthDelimitedWireType);
+    target = writeVarint(content.size(), target);
+    std::memcpy(target, content.data(), content.size());
+  }
+}
+
+std::string ValueChunkView::serializeAsString() const {
+  std::string ret(serializedSize(), '\0');
+  serializeToArray(reinterpret_cast<uint8_t*>(ret.data()));
+  return ret;
+}
+
+ValueChunkView ValueChunkView::parseFrom(std::string_view bytes) {
+  ValueChunkView ret;
+  const auto* ptr = reinterpret_cast<const uint8_t*>(bytes.data());
+  const auto* end = ptr + bytes.size();
+  while (ptr < end) {
+    uint64_t tag = 0;
+    ptr = readVarint(ptr, end, &tag);
+    const uint32_t field = tag >> 3;
+    const uint32_t wire_type = tag & 0x7;
+    uint64_t value = 0;
+    switch (wire_type) {
+      case kVarintWireType: {
+        ptr = readVarint(ptr, end, &value);
+        if (field == kTotalBytesField) {
+          ret.total_bytes = value;
+        } else if (field == kChunkOffsetField) {
+          ret.chunk_offset = value;
+        }
+        break;
+      }
+      case kLengthDelimitedWireType: {
+        ptr = readVarint(ptr, end, &value);
+        SPU_ENFORCE(value <= static_cast<uint64_t>(end - ptr),
+                    "truncated ValueChunkProto");
+        if (field == kContentField) {
+          ret.content = std::string_view(reinterpret_cast<const char*>(ptr),
+                                         value);
+        }
+        ptr += value;
+        break;
+      }
+      case kFixed64WireType: {
+        SPU_ENFORCE(end - ptr >= 8, "truncated ValueChunkProto");
+        ptr += 8;
+        break;
+      }
+      case kFixed32WireType: {
+        SPU_ENFORCE(end - ptr >= 4, "truncated ValueChunkProto");
+        ptr += 4;
+        break;
+      }
+      default:
+        SPU_THROW("invalid wire type {} in ValueChunkProto", wire_type);
+    }
+  }
+  return ret;
+}
+
 Value Value::clone() const {
   if (isComplex()) {
     return Value(data_.clone(), imag_->clone(), dtype());
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <string_view>
 
 #include "fmt/ostream.h"
 
@@ -37,6 +39,33 @@ struct ValueProto {
   std::vector<pb::ValueChunkProto> chunks;
 };
 
+// A chunk that refers to the bytes it carries instead of owning a copy, it is
+// wire compatible with pb::ValueChunkProto.
+struct ValueChunkView {
+  size_t total_bytes = 0;
+  size_t chunk_offset = 0;
+  std::string_view content;
+  // Keeps `content` alive, null when the memory is owned by the caller.
+  std::shared_ptr<yacl::Buffer> holder;
+
+  // Size of the equivalent serialized pb::ValueChunkProto.
+  size_t serializedSize() const;
+
+  // Writes the equivalent serialized pb::ValueChunkProto to `target`, which
+  // should have serializedSize() bytes.
+  void serializeToArray(uint8_t* target) const;
+
+  std::string serializeAsString() const;
+
+  // Parses a serialized pb::ValueChunkProto, `content` refers to `bytes`.
+  static ValueChunkView parseFrom(std::string_view bytes);
+};
+
+struct ValueProtoView {
+  pb::ValueMetaProto meta;
+  std::vector<ValueChunkView> chunks;
+};
+
 class Value final {
   NdArrayRef data_;
   std::optional<NdArrayRef> imag_;
@@ -94,9 +123,21 @@ class Value final {
   size_t chunksCount(size_t max_chunk_size) const;
   pb::ValueMetaProto toMetaProto() const;
 
+  // Same as toProto, but the chunks refer to the buffer of this value (or of a
+  // compact copy when this value is not compact) instead of copying it.
+  ValueProtoView toProtoView(size_t max_chunk_size) const;
+
   // Deserialize from protobuf.
   static Value fromProto(const ValueProto& value);
 
+  // Same as fromProto, the chunks are copied into the result once.
+  static Value fromProtoView(const ValueProtoView& value);
+
+  // Adopts `buf` as the storage of the result without copying, `buf` holds
+  // all serialized bytes of the value, i.e. the concatenated chunks.
+  static Value fromBuffer(const pb::ValueMetaProto& meta,
+                          std::shared_ptr<yacl::Buffer> buf);
+
   Value clone() const;
 };
 
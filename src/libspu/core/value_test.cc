@@ -14,6 +14,9 @@
 
 #include "libspu/core/value.h"
 
+#include <cstring>
+#include <numeric>
+
 #include "gtest/gtest.h"
 
 namespace spu {
@@ -31,6 +34,68 @@ TEST(ValueTest, Empty) {
   EXPECT_FALSE(a.isInt());
 }
 
+namespace {
+
+class TestPubTy : public TypeImpl<TestPubTy, RingTy, Public> {
+  using Base = TypeImpl<TestPubTy, RingTy, Public>;
+
+ public:
+  using Base::Base;
+  explicit TestPubTy(FieldType field) { field_ = field; }
+
+  static std::string_view getStaticId() { return "ValueTest.Pub"; }
+};
+
+}  // namespace
+
+TEST(ValueTest, ProtoView) {
+  TypeContext::getTypeContext()->addTypes<TestPubTy>();
+
+  NdArrayRef arr(makeType<TestPubTy>(FM64), {3, 4});
+  std::iota(arr.data<int64_t>(), arr.data<int64_t>() + arr.numel(), 0);
+  Value a(arr, DT_I64);
+
+  // 7 bytes per chunk, chunks cross elements.
+  auto view = a.toProtoView(7);
+  auto proto = a.toProto(7);
+  ASSERT_EQ(view.chunks.size(), 14U);
+  ASSERT_EQ(proto.chunks.size(), 14U);
+  EXPECT_EQ(view.chunks[0].content.data(), arr.data<char>());
+  EXPECT_EQ(view.chunks[0].holder, arr.buf());
+  for (size_t i = 0; i < view.chunks.size(); ++i) {
+    auto bytes = view.chunks[i].serializeAsString();
+    EXPECT_EQ(bytes, proto.chunks[i].SerializeAsString());
+
+    auto parsed = ValueChunkView::parseFrom(bytes);
+    EXPECT_EQ(parsed.total_bytes, view.chunks[i].total_bytes);
+    EXPECT_EQ(parsed.chunk_offset, view.chunks[i].chunk_offset);
+    EXPECT_EQ(parsed.content, view.chunks[i].content);
+  }
+
+  auto b = Value::fromProtoView(view);
+  EXPECT_NE(b.data().buf(), arr.buf());
+  EXPECT_EQ(std::memcmp(b.data().data(), arr.data(), arr.buf()->size()), 0);
+
+  // adopts the buffer
+  auto c = Value::fromBuffer(view.meta, arr.buf());
+  EXPECT_EQ(c.data().buf(), arr.buf());
+  EXPECT_EQ(c.shape(), arr.shape());
+  EXPECT_EQ(c.dtype(), DT_I64);
+  EXPECT_ANY_THROW(
+      Value::fromBuffer(view.meta, std::make_shared<yacl::Buffer>(8)));
+
+  // non compact values are serialized from a compact copy.
+  Value t(arr.transpose(), DT_I64);
+  auto t_view = t.toProtoView(7);
+  EXPECT_NE(t_view.chunks[0].holder, arr.buf());
+  auto d = Value::fromProtoView(t_view);
+  for (int64_t i = 0; i < 3; ++i) {
+    for (int64_t j = 0; j < 4; ++j) {
+      EXPECT_EQ(d.data().at<int64_t>({j, i}), arr.at<int64_t>({i, j}));
+    }
+  }
+}
+
 // FIXME(jint)
 // TEST(ValueTest, Sanity) {
 //   // default constructor makes a placeholder value.
@@ -17,19 +17,19 @@
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <vector>
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/ErrorHandling.h"
-#include "mlir/Dialect/Func/IR/FuncOps.h"
-#include "mlir/IR/BuiltinOps.h"
-#include "mlir/Parser/Parser.h"
 #include "spdlog/spdlog.h"
 
+#include "libspu/core/buffer_pool.h"
 #include "libspu/core/trace.h"
+#include "libspu/device/cost_model.h"
+#include "libspu/device/executable_cache.h"
+#include "libspu/device/op_scheduler.h"
 #include "libspu/device/utils/debug_dump_constant.h"
-#include "libspu/dialect/pphlo/IR/dialect.h"
-#include "libspu/dialect/utils/utils.h"
-#include "libspu/version.h"
 
 namespace spu::device {
 namespace {
@@ -48,6 +48,23 @@ class TimeitGuard {
   }
 };
 
+// Marks a shared context as used by several threads while the scope lives,
+// it may not be modified, e.g. by loading a dialect, in the meantime.
+class MultiThreadedExecutionScope {
+  mlir::MLIRContext *ctx_;
+
+ public:
+  explicit MultiThreadedExecutionScope(mlir::MLIRContext *ctx) : ctx_(ctx) {
+    ctx_->enterMultiThreadedExecution();
+  }
+
+  ~MultiThreadedExecutionScope() { ctx_->exitMultiThreadedExecution(); }
+
+  MultiThreadedExecutionScope(const MultiThreadedExecutionScope &) = delete;
+  MultiThreadedExecutionScope &operator=(const MultiThreadedExecutionScope &) =
+      delete;
+};
+
 double getSeconds(const Duration &dur) {
   return std::chrono::duration_cast<std::chrono::duration<double>>(dur).count();
 }
@@ -148,7 +165,9 @@ void takeSnapshot(size_t rank, const RuntimeConfig &rt_config,
 
   // Dump inputs
   for (const auto &[name, var] : env) {
-    auto serialized = var.toProto(std::numeric_limits<int>::max());
+    // chunks refer to the buffer of var, they are serialized straight to the
+    // files.
+    auto serialized = var.toProtoView(std::numeric_limits<int>::max());
     {
       std::ofstream meta_file(getMetaFilePath(dump_folder, rank, name),
                               std::ios::binary | std::ios::out);
@@ -159,7 +178,7 @@ void takeSnapshot(size_t rank, const RuntimeConfig &rt_config,
         std::ofstream chunk_file(
             getValueChunkFilePath(dump_folder, rank, name, chunk.index()),
             std::ios::binary | std::ios::out);
-        chunk_file << chunk.value().SerializeAsString();
+        chunk_file << chunk.value().serializeAsString();
       }
     }
   }
@@ -176,6 +195,11 @@ void printProfilingData(spu::SPUContext *sctx, const std::string &name,
       getSeconds(exec_stats.execution_time),
       getSeconds(exec_stats.outfeed_time), getSeconds(exec_stats.total_time()));
 
+  // print protocol states information, e.g. prefetching.
+  for (const auto &line : sctx->prot()->describeStats()) {
+    SPDLOG_INFO("[Profiling] {}", line);
+  }
+
   // print action trace information
   {
     std::map<ActionKey, ActionStats> stats;
@@ -206,7 +230,9 @@ void printProfilingData(spu::SPUContext *sctx, const std::string &name,
       std::vector<ActionKey> sorted_by_time;
       for (const auto &[key, stat] : stats) {
         if ((key.flag & mod_flag) != 0) {
-          total_time += stat.getTotalTimeInSecond();
+          if ((key.flag & TR_NESTED) == 0) {
+            total_time += stat.getTotalTimeInSecond();
+          }
           sorted_by_time.emplace_back(key);
         }
       }
@@ -237,6 +263,28 @@ void printProfilingData(spu::SPUContext *sctx, const std::string &name,
       comm_stats.recv_actions);
 }
 
+void printSchedulingData(const OpScheduler &scheduler) {
+  const auto stats = scheduler.getStats();
+
+  std::vector<std::pair<std::string, OpScheduleStats>> sorted_by_wait(
+      stats.begin(), stats.end());
+  std::sort(sorted_by_wait.begin(), sorted_by_wait.end(),
+            [](const auto &s0, const auto &s1) {
+              return s0.second.queue_time + s0.second.wait_time >
+                     s1.second.queue_time + s1.second.wait_time;
+            });
+
+  SPDLOG_INFO("Inter-op scheduling: {} workers, {} steals",
+              scheduler.numWorkers(), scheduler.numSteals());
+  for (const auto &[name, stat] : sorted_by_wait) {
+    SPDLOG_INFO(
+        "- {}, executed {} times, operand wait {}s, queue wait {}s, duration "
+        "{}s",
+        name, stat.count, getSeconds(stat.wait_time),
+        getSeconds(stat.queue_time), getSeconds(stat.exec_time));
+  }
+}
+
 void SPUErrorHandler(void *use_data, const char *reason, bool gen_crash_diag) {
   (void)use_data;
   (void)gen_crash_diag;
@@ -286,56 +334,56 @@ void executeImpl(OpExecutor *executor, spu::SPUContext *sctx,
 
   // execution
   std::vector<spu::Value> outputs;
+  std::unique_ptr<OpScheduler> scheduler;
+  std::optional<CostModel> cost_model;
   {
     TimeitGuard timeit(exec_stats.execution_time);
 
-    mlir::MLIRContext mlir_ctx;
-    mlir_ctx
-        .loadDialect<mlir::spu::pphlo::PPHloDialect, mlir::func::FuncDialect>();
-
-    auto &engine = mlir_ctx.getDiagEngine();
-    engine.registerHandler(
-        [&](mlir::Diagnostic &diag) { SPDLOG_ERROR(diag.str()); });
-
-    auto moduleOpRef =
-        mlir::parseSourceString<mlir::ModuleOp>(executable.code, &mlir_ctx);
-
-    SPU_ENFORCE(moduleOpRef, "MLIR parser failure");
-
-    if (!moduleOpRef.get()->hasAttr("pphlo.version")) {
-      // There are tests that has no version attributes.
-      // So treats this as a warning
-      SPDLOG_WARN("Missing ir version");
-    } else {
-      auto ir_version = mlir::dyn_cast<mlir::StringAttr>(
-                            moduleOpRef.get()->getAttr("pphlo.version"))
-                            .str();
-      if (ir_version != getVersionStr()) {
-        SPU_THROW(
-            "IR was generted by compiler {} and does not match current runtime "
-            "{}",
-            ir_version, getVersionStr());
-      }
+    // Buffers freed by dead values are reused by the following kernels.
+    std::optional<BufferPool::Scope> pool_scope;
+    if (rt_config.experimental_buffer_pool_size > 0) {
+      pool_scope.emplace(rt_config.experimental_buffer_pool_size);
     }
 
-    auto entry_function = mlir::spu::get_entrypoint(moduleOpRef.get());
-    SPU_ENFORCE(entry_function, "main module not found");
+    auto parsed = rt_config.experimental_enable_executable_cache
+                      ? ExecutableCache::instance().get(executable.code)
+                      : ParsedExecutable::parse(executable.code);
+    auto *mlir_ctx = parsed->context();
 
     ExecutionOptions opts;
     opts.do_type_check = rt_config.enable_type_checker;
     opts.do_log_execution = rt_config.enable_pphlo_trace;
     opts.do_parallel = rt_config.experimental_enable_inter_op_par;
+    const bool critical_path =
+        opts.do_parallel &&
+        rt_config.experimental_enable_critical_path_scheduling;
+    // the prefetcher generates the correlations of hinted kernels.
+    const bool hint_kernels = rt_config.experimental_beaver_prefetch_depth > 0;
+    if (critical_path || hint_kernels) {
+      cost_model.emplace(KernelCostTable::fromContext(sctx));
+    }
+    if (hint_kernels) {
+      opts.hint_model = &*cost_model;
+    }
+    std::optional<MultiThreadedExecutionScope> mt_scope;
     if (opts.do_parallel) {
       opts.concurrency = rt_config.experimental_inter_op_concurrency;
-      mlir_ctx.enableMultithreading();
-      mlir_ctx.enterMultiThreadedExecution();
+      scheduler = std::make_unique<OpScheduler>(
+          opts.concurrency,
+          (getGlobalTraceFlag(sctx->id()) & TR_REC) != 0);
+      opts.scheduler = scheduler.get();
+      if (critical_path) {
+        opts.cost_model = &*cost_model;
+      }
+      if (parsed->ownsContext()) {
+        mlir_ctx->enableMultithreading();
+      }
+      mt_scope.emplace(mlir_ctx);
     }
-    outputs = runRegion(executor, sctx, nullptr, entry_function.getBody(),
+    outputs = runRegion(executor, sctx, nullptr, parsed->entry().getBody(),
                         inputs, opts);
-
-    if (opts.do_parallel) {
-      mlir_ctx.exitMultiThreadedExecution();
-    }
+    // e.g. deferred mac checks, before any output leaves the execution.
+    sctx->prot()->flush();
   }
 
   // sync output to environment.
@@ -349,6 +397,9 @@ void executeImpl(OpExecutor *executor, spu::SPUContext *sctx,
   comm_stats.diff(sctx->lctx());
   if ((getGlobalTraceFlag(sctx->id()) & TR_REC) != 0) {
     printProfilingData(sctx, executable.name, exec_stats, comm_stats);
+    if (scheduler) {
+      printSchedulingData(*scheduler);
+    }
   }
 }
 
@@ -0,0 +1,334 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/cost_model.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#include "libspu/core/context.h"
+#include "libspu/core/type_util.h"
+#include "libspu/dialect/pphlo/IR/ops.h"
+
+namespace spu::device {
+
+namespace {
+
+namespace pphlo = mlir::spu::pphlo;
+
+size_t numelOf(mlir::Value value) {
+  return mlir::cast<mlir::RankedTensorType>(value.getType()).getNumElements();
+}
+
+// Returns the kernels that dominate the communication of `op`, which has at
+// least one secret operand, or null when `op` is not modeled.
+std::optional<std::vector<KernelHint>> collectKernelCalls(
+    mlir::Operation* op, const KernelCostTable& table,
+    const pphlo::TypeTools& tools) {
+  auto is_secret = [&](mlir::Value v) {
+    return tools.isSecretType(v.getType());
+  };
+  auto is_fxp = [&](mlir::Value v) { return tools.isFloatType(v.getType()); };
+
+  std::vector<KernelHint> calls;
+  auto msb = [&](size_t numel) {
+    calls.push_back({table.has("msb_a2b") ? "msb_a2b" : "a2b", numel, {}});
+  };
+  auto mux = [&](size_t numel) {
+    if (table.has("mul_a1b")) {
+      calls.push_back({"mul_a1b", numel, {}});
+    } else {
+      calls.push_back({"b2a", numel, {}});
+      calls.push_back({"mul_aa", numel, {}});
+    }
+  };
+  auto trunc = [&](size_t numel) {
+    calls.push_back(
+        {"trunc_a", numel, {{"n", static_cast<ce::Value>(table.fxpBits())}}});
+  };
+  // Free when all values but the first `n` are public, e.g. indices.
+  auto public_after = [&](size_t n) {
+    return llvm::none_of(op->getOperands().drop_front(n), is_secret);
+  };
+
+  bool modeled =
+      llvm::TypeSwitch<mlir::Operation*, bool>(op)
+          .Case<pphlo::AddOp, pphlo::SubtractOp, pphlo::NegOp, pphlo::XorOp,
+                pphlo::NotOp, pphlo::ShiftLeftOp, pphlo::BroadcastOp,
+                pphlo::ReshapeOp, pphlo::TransposeOp, pphlo::SliceOp,
+                pphlo::ConcatenateOp, pphlo::ReverseOp, pphlo::BitcastConvertOp,
+                pphlo::RealOp, pphlo::ImagOp, pphlo::ComplexOp, pphlo::FreeOp,
+                pphlo::ReturnOp, pphlo::WhileOp, mlir::func::ReturnOp>(
+              [](auto) { return true; })
+          .Case<pphlo::DynamicSliceOp>([&](auto) { return public_after(1); })
+          .Case<pphlo::DynamicUpdateSliceOp>(
+              [&](auto) { return public_after(2); })
+          .Case<pphlo::IfOp, pphlo::CaseOp>([&](mlir::Operation* branch) {
+            // secret predicates are inlined by the compiler.
+            return !is_secret(branch->getOperand(0));
+          })
+          .Case<pphlo::MulOp>([&](pphlo::MulOp mul) {
+            const auto numel = numelOf(mul->getResult(0));
+            const bool aa = is_secret(mul.getLhs()) && is_secret(mul.getRhs());
+            calls.push_back({aa ? "mul_aa" : "mul_ap", numel, {}});
+            if (is_fxp(mul.getLhs()) && is_fxp(mul.getRhs())) {
+              trunc(numel);
+            }
+            return true;
+          })
+          .Case<pphlo::DotOp, pphlo::DotGeneralOp>([&](auto dot) {
+            auto lhs =
+                mlir::cast<mlir::RankedTensorType>(dot.getLhs().getType());
+            auto rhs =
+                mlir::cast<mlir::RankedTensorType>(dot.getRhs().getType());
+            // dot_general is a batch of [m, k] x [k, n].
+            size_t batch = 1;
+            auto lhs_shape = lhs.getShape();
+            auto rhs_shape = rhs.getShape();
+            if (mlir::isa<pphlo::DotGeneralOp>(dot)) {
+              batch = lhs_shape.front();
+              lhs_shape = lhs_shape.drop_front();
+              rhs_shape = rhs_shape.drop_front();
+            }
+            const ce::Params params = {
+                {"m", static_cast<ce::Value>(
+                          lhs_shape.size() == 2 ? lhs_shape[0] : 1)},
+                {"k", static_cast<ce::Value>(lhs_shape.back())},
+                {"n", static_cast<ce::Value>(
+                          rhs_shape.size() == 2 ? rhs_shape[1] : 1)},
+            };
+            const bool aa = is_secret(dot.getLhs()) && is_secret(dot.getRhs());
+            for (size_t idx = 0; idx < batch; ++idx) {
+              calls.push_back({aa ? "mmul_aa" : "mmul_ap", 1, params});
+            }
+            if (is_fxp(dot.getLhs()) && is_fxp(dot.getRhs())) {
+              trunc(numelOf(dot->getResult(0)));
+            }
+            return true;
+          })
+          .Case<pphlo::LessOp, pphlo::LessEqualOp, pphlo::GreaterOp,
+                pphlo::GreaterEqualOp, pphlo::SignOp>(
+              [&](mlir::Operation* cmp) {
+                msb(numelOf(cmp->getResult(0)));
+                return true;
+              })
+          .Case<pphlo::EqualOp, pphlo::NotEqualOp>([&](mlir::Operation* cmp) {
+            const auto numel = numelOf(cmp->getResult(0));
+            const bool aa = llvm::all_of(cmp->getOperands(), is_secret);
+            const char* name = aa ? "equal_aa" : "equal_ap";
+            if (table.has(name)) {
+              calls.push_back({name, numel, {}});
+            } else {
+              // a == b as !(a < b) & !(b < a)
+              msb(numel);
+              msb(numel);
+              calls.push_back({"and_bb", numel, {}});
+            }
+            return true;
+          })
+          .Case<pphlo::MaxOp, pphlo::MinOp, pphlo::AbsOp>(
+              [&](mlir::Operation* minmax) {
+                const auto numel = numelOf(minmax->getResult(0));
+                msb(numel);
+                mux(numel);
+                return true;
+              })
+          .Case<pphlo::ClampOp>([&](pphlo::ClampOp clamp) {
+            const auto numel = numelOf(clamp->getResult(0));
+            for (int idx = 0; idx < 2; ++idx) {
+              msb(numel);
+              mux(numel);
+            }
+            return true;
+          })
+          .Case<pphlo::SelectOp>([&](pphlo::SelectOp select) {
+            if (is_secret(select.getPred())) {
+              mux(numelOf(select->getResult(0)));
+            }
+            return true;
+          })
+          .Case<pphlo::AndOp, pphlo::OrOp>([&](mlir::Operation* logic) {
+            if (llvm::all_of(logic->getOperands(), is_secret)) {
+              calls.push_back({"and_bb", numelOf(logic->getResult(0)), {}});
+            }
+            return true;
+          })
+          .Case<pphlo::ConvertOp>([&](pphlo::ConvertOp convert) {
+            auto in = convert->getOperand(0);
+            auto out = convert->getResult(0);
+            const auto numel = numelOf(out);
+            if (!is_secret(out)) {
+              // reveal
+              const bool boolean = tools.getBaseType(in.getType()).isInteger(1);
+              calls.push_back({boolean ? "b2p" : "a2p", numel, {}});
+            } else if (is_fxp(in) && !is_fxp(out)) {
+              trunc(numel);
+            }
+            return true;
+          })
+          .Default([](mlir::Operation*) { return false; });
+
+  if (!modeled) {
+    return std::nullopt;
+  }
+  return calls;
+}
+
+}  // namespace
+
+const std::vector<std::string>& KernelCostTable::kernelNames() {
+  static const std::vector<std::string> kNames = {
+      "mul_aa",  "mul_ap",   "mmul_aa", "mmul_ap", "trunc_a",
+      "msb_a2b", "a2b",      "b2a",     "mul_a1b", "equal_aa",
+      "equal_ap", "and_bb",  "a2p",     "b2p",
+  };
+  return kNames;
+}
+
+KernelCostTable::KernelCostTable(size_t field_bits, size_t num_parties,
+                                 size_t fxp_bits)
+    : field_bits_(field_bits),
+      num_parties_(num_parties),
+      fxp_bits_(fxp_bits) {}
+
+KernelCostTable KernelCostTable::fromContext(SPUContext* sctx) {
+  const size_t num_parties = sctx->lctx() ? sctx->lctx()->WorldSize() : 1;
+  KernelCostTable table(SizeOf(sctx->getField()) * 8, num_parties,
+                        sctx->getFxpBits());
+
+  for (const auto& name : kernelNames()) {
+    if (!sctx->hasKernel(name)) {
+      continue;
+    }
+    const auto* kernel = sctx->getKernel(name);
+    if (kernel->kind() == Kernel::Kind::Dynamic) {
+      continue;
+    }
+    auto latency = kernel->latency();
+    auto comm = kernel->comm();
+    if (latency && comm) {
+      table.add(name, std::move(latency), std::move(comm));
+    }
+  }
+  return table;
+}
+
+void KernelCostTable::add(const std::string& name, ce::CExpr latency,
+                          ce::CExpr comm) {
+  entries_[name] = Entry{std::move(latency), std::move(comm)};
+}
+
+std::optional<CommCost> KernelCostTable::eval(const std::string& name,
+                                              size_t numel,
+                                              const ce::Params& params) const {
+  auto itr = entries_.find(name);
+  if (itr == entries_.end()) {
+    return std::nullopt;
+  }
+
+  ce::Params bound = params;
+  bound.emplace("K", field_bits_);
+  bound.emplace("N", num_parties_);
+
+  CommCost cost;
+  cost.rounds = itr->second.latency->eval(bound);
+  // comm is in bits.
+  cost.bytes = (itr->second.comm->eval(bound) * numel + 7) / 8;
+  return cost;
+}
+
+std::optional<std::vector<KernelHint>> CostModel::kernelCalls(
+    mlir::Operation* op) const {
+  pphlo::TypeTools tools(op->getContext());
+  auto is_secret = [&](mlir::Value v) {
+    return tools.isSecretType(v.getType());
+  };
+  if (llvm::none_of(op->getOperands(), is_secret)) {
+    return std::vector<KernelHint>{};
+  }
+  return collectKernelCalls(op, table_, tools);
+}
+
+std::optional<CommCost> CostModel::estimate(mlir::Operation* op) const {
+  pphlo::TypeTools tools(op->getContext());
+  auto is_secret = [&](mlir::Value v) {
+    return tools.isSecretType(v.getType());
+  };
+  if (llvm::none_of(op->getOperands(), is_secret)) {
+    return CommCost{};
+  }
+
+  if (mlir::isa<pphlo::ReduceOp, pphlo::ReduceWindowOp>(op)) {
+    // e.g. a sum, free when the body is.
+    for (auto& body_op : op->getRegion(0).front()) {
+      auto cost = estimate(&body_op);
+      if (!cost || cost->rounds != 0 || cost->bytes != 0) {
+        return std::nullopt;
+      }
+    }
+    return CommCost{};
+  }
+
+  auto calls = collectKernelCalls(op, table_, tools);
+  if (!calls) {
+    return std::nullopt;
+  }
+
+  CommCost cost;
+  for (const auto& call : *calls) {
+    auto kernel_cost = table_.eval(call.name, call.numel, call.params);
+    if (!kernel_cost) {
+      return std::nullopt;
+    }
+    cost += *kernel_cost;
+  }
+  return cost;
+}
+
+void CostModel::estimateBlock(mlir::Block& block, CostReport* report) const {
+  for (auto& op : block) {
+    const auto name = op.getName().getStringRef().str();
+    auto cost = estimate(&op);
+    if (!cost) {
+      ++report->unmodeled[name];
+      continue;
+    }
+
+    if (cost->rounds != 0 || cost->bytes != 0) {
+      report->ops.emplace_back(&op, *cost);
+      auto& stats = report->by_kind[name];
+      ++stats.count;
+      stats.cost += *cost;
+      report->total += *cost;
+    }
+
+    if (mlir::isa<pphlo::WhileOp, pphlo::IfOp, pphlo::CaseOp>(op)) {
+      for (auto& region : op.getRegions()) {
+        for (auto& body : region) {
+          estimateBlock(body, report);
+        }
+      }
+    }
+  }
+}
+
+CostReport CostModel::estimate(mlir::func::FuncOp func) const {
+  CostReport report;
+  for (auto& block : func.getBody()) {
+    estimateBlock(block, &report);
+  }
+  return report;
+}
+
+}  // namespace spu::device
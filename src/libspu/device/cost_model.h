@@ -0,0 +1,144 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Operation.h"
+
+#include "libspu/core/cexpr.h"
+#include "libspu/core/object.h"
+
+namespace spu {
+class SPUContext;
+}  // namespace spu
+
+namespace spu::device {
+
+// Communication of one party, in rounds and bytes sent.
+struct CommCost {
+  size_t rounds = 0;
+  size_t bytes = 0;
+
+  CommCost& operator+=(const CommCost& other) {
+    rounds += other.rounds;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
+// Every round pays the latency, bytes go through the bandwidth.
+struct NetworkModel {
+  double latency_ms = 1.0;
+  double bandwidth_mbps = 1000.0;
+
+  // Estimated seconds spent on communication.
+  double seconds(const CommCost& cost) const {
+    return static_cast<double>(cost.rounds) * latency_ms / 1e3 +
+           static_cast<double>(cost.bytes) * 8 / (bandwidth_mbps * 1e6);
+  }
+};
+
+// Cost expressions of the kernels of a protocol, see Kernel::latency/comm.
+class KernelCostTable {
+ public:
+  // The kernels priced by CostModel.
+  static const std::vector<std::string>& kernelNames();
+
+  // `field_bits` and `num_parties` bind the K and N variables.
+  KernelCostTable(size_t field_bits, size_t num_parties, size_t fxp_bits);
+
+  // Collects the expressions of the kernels registered to `sctx`, dynamic
+  // kernels and kernels without expressions are skipped.
+  static KernelCostTable fromContext(SPUContext* sctx);
+
+  void add(const std::string& name, ce::CExpr latency, ce::CExpr comm);
+
+  bool has(const std::string& name) const { return entries_.count(name) > 0; }
+
+  size_t fxpBits() const { return fxp_bits_; }
+
+  // Cost of running the kernel on `numel` elements, comm of a kernel is per
+  // element, except matmuls which are evaluated with numel = 1. `params` binds
+  // the kernel specific variables, e.g. the matmul shapes. Null when the
+  // kernel is unknown.
+  std::optional<CommCost> eval(const std::string& name, size_t numel,
+                               const ce::Params& params = {}) const;
+
+ private:
+  struct Entry {
+    ce::CExpr latency;
+    ce::CExpr comm;
+  };
+
+  std::map<std::string, Entry> entries_;
+  size_t field_bits_;
+  size_t num_parties_;
+  size_t fxp_bits_;
+};
+
+// Aggregated cost of one kind of ops.
+struct OpStats {
+  size_t count = 0;
+  CommCost cost;
+};
+
+struct CostReport {
+  CommCost total;
+  // priced ops in program order.
+  std::vector<std::pair<mlir::Operation*, CommCost>> ops;
+  // by op name.
+  std::map<std::string, OpStats> by_kind;
+  // ops with secret inputs that could not be priced, by op name.
+  std::map<std::string, size_t> unmodeled;
+};
+
+// A static, first order estimation of the communication of a pphlo program.
+//
+// Each op is mapped to the mpc kernels that dominate its communication, e.g. a
+// fixed point secret multiplication to mul_aa + trunc_a, a secret comparison
+// to msb_a2b. Ops on public values and linear ops are free. Non-linear
+// approximations (exp, div, ...), sorts and reduces with non-linear bodies are
+// reported as unmodeled.
+//
+// Rounds of all ops are summed, which ignores ops run concurrently, and
+// region bodies of control flow are counted once, the trip count of loops is
+// not known statically.
+class CostModel {
+ public:
+  explicit CostModel(KernelCostTable table) : table_(std::move(table)) {}
+
+  // Null when `op` could not be priced.
+  std::optional<CommCost> estimate(mlir::Operation* op) const;
+
+  // The kernels `op` is priced with, in call order, empty when `op` is free,
+  // null when it is not modeled. Regions of `op` are not included.
+  std::optional<std::vector<KernelHint>> kernelCalls(mlir::Operation* op) const;
+
+  CostReport estimate(mlir::func::FuncOp func) const;
+
+  const KernelCostTable& table() const { return table_; }
+
+ private:
+  void estimateBlock(mlir::Block& block, CostReport* report) const;
+
+  KernelCostTable table_;
+};
+
+}  // namespace spu::device
@@ -0,0 +1,88 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/cost_model.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/device/executable_cache.h"
+
+namespace spu::device {
+
+namespace {
+
+constexpr char kCode[] = R"(
+func.func @main(%arg0: tensor<2x3x!pphlo.secret<f32>>, %arg1: tensor<3x4x!pphlo.secret<f32>>, %arg2: tensor<2x3xf32>) -> (tensor<2x4x!pphlo.secret<f32>>, tensor<2x4x!pphlo.secret<f32>>) {
+  %0 = pphlo.add %arg0, %arg2 : (tensor<2x3x!pphlo.secret<f32>>, tensor<2x3xf32>) -> tensor<2x3x!pphlo.secret<f32>>
+  %1 = pphlo.multiply %0, %arg0 : tensor<2x3x!pphlo.secret<f32>>
+  %2 = pphlo.dot %1, %arg1 : (tensor<2x3x!pphlo.secret<f32>>, tensor<3x4x!pphlo.secret<f32>>) -> tensor<2x4x!pphlo.secret<f32>>
+  %3 = pphlo.exponential %2 : tensor<2x4x!pphlo.secret<f32>>
+  return %2, %3 : tensor<2x4x!pphlo.secret<f32>>, tensor<2x4x!pphlo.secret<f32>>
+})";
+
+KernelCostTable makeTable() {
+  KernelCostTable table(64, 2, 18);
+  table.add("mul_aa", ce::Const(1), 2 * ce::K());
+  table.add("trunc_a", ce::Const(1), ce::K());
+  table.add("mmul_aa", ce::Const(1),
+            ce::K() * ce::Variable("m", "") * ce::Variable("n", ""));
+  return table;
+}
+
+}  // namespace
+
+TEST(CostModelTest, Table) {
+  auto table = makeTable();
+  EXPECT_TRUE(table.has("mul_aa"));
+  EXPECT_FALSE(table.eval("msb_a2b", 1).has_value());
+
+  auto cost = table.eval("mul_aa", 10);
+  ASSERT_TRUE(cost.has_value());
+  EXPECT_EQ(cost->rounds, 1);
+  EXPECT_EQ(cost->bytes, 10 * 2 * 64 / 8);
+
+  cost = table.eval("mmul_aa", 1, {{"m", 2}, {"n", 3}});
+  ASSERT_TRUE(cost.has_value());
+  EXPECT_EQ(cost->bytes, 2 * 3 * 64 / 8);
+}
+
+TEST(CostModelTest, Estimate) {
+  auto parsed = ParsedExecutable::parse(kCode);
+  CostModel model(makeTable());
+  auto report = model.estimate(parsed->entry());
+
+  // mul_aa + trunc_a on 6 elements
+  ASSERT_EQ(report.by_kind.count("pphlo.multiply"), 1);
+  EXPECT_EQ(report.by_kind["pphlo.multiply"].cost.rounds, 2);
+  EXPECT_EQ(report.by_kind["pphlo.multiply"].cost.bytes, 6 * 3 * 64 / 8);
+
+  // mmul_aa of 2x4 + trunc_a on 8 elements
+  ASSERT_EQ(report.by_kind.count("pphlo.dot"), 1);
+  EXPECT_EQ(report.by_kind["pphlo.dot"].cost.rounds, 2);
+  EXPECT_EQ(report.by_kind["pphlo.dot"].cost.bytes, 2 * 8 * 64 / 8);
+
+  // add is free.
+  EXPECT_EQ(report.by_kind.count("pphlo.add"), 0);
+  EXPECT_EQ(report.ops.size(), 2);
+  EXPECT_EQ(report.unmodeled.at("pphlo.exponential"), 1);
+
+  EXPECT_EQ(report.total.rounds, 4);
+  EXPECT_EQ(report.total.bytes, (18 + 16) * 64 / 8);
+
+  NetworkModel network{10.0, 8.0};
+  EXPECT_DOUBLE_EQ(network.seconds(report.total),
+                   4 * 0.01 + report.total.bytes / 1e6);
+}
+
+}  // namespace spu::device
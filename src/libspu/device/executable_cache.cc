@@ -0,0 +1,159 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/executable_cache.h"
+
+#include <algorithm>
+
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Parser/Parser.h"
+#include "spdlog/spdlog.h"
+
+#include "libspu/core/prelude.h"
+#include "libspu/dialect/pphlo/IR/dialect.h"
+#include "libspu/dialect/utils/utils.h"
+#include "libspu/version.h"
+
+namespace spu::device {
+namespace {
+
+std::shared_ptr<mlir::MLIRContext> makeContext() {
+  auto ctx = std::make_shared<mlir::MLIRContext>();
+  ctx->loadDialect<mlir::spu::pphlo::PPHloDialect, mlir::func::FuncDialect>();
+
+  auto &engine = ctx->getDiagEngine();
+  engine.registerHandler(
+      [&](mlir::Diagnostic &diag) { SPDLOG_ERROR(diag.str()); });
+  return ctx;
+}
+
+// Context of the cache, shared by concurrent executions.
+std::shared_ptr<mlir::MLIRContext> makeSharedContext() {
+  auto ctx = makeContext();
+  ctx->enableMultithreading();
+  return ctx;
+}
+
+}  // namespace
+
+std::shared_ptr<const ParsedExecutable> ParsedExecutable::parse(
+    std::string_view code, std::shared_ptr<mlir::MLIRContext> ctx) {
+  std::shared_ptr<ParsedExecutable> res(new ParsedExecutable());
+  res->owns_ctx_ = ctx == nullptr;
+  res->ctx_ = ctx != nullptr ? std::move(ctx) : makeContext();
+
+  // Textual IR and bytecode are told apart by the parser.
+  res->module_ = mlir::parseSourceString<mlir::ModuleOp>(
+      llvm::StringRef(code.data(), code.size()), res->ctx_.get());
+
+  SPU_ENFORCE(res->module_, "MLIR parser failure");
+
+  if (!res->module_.get()->hasAttr("pphlo.version")) {
+    // There are tests that has no version attributes.
+    // So treats this as a warning
+    SPDLOG_WARN("Missing ir version");
+  } else {
+    auto ir_version = mlir::dyn_cast<mlir::StringAttr>(
+                          res->module_.get()->getAttr("pphlo.version"))
+                          .str();
+    if (ir_version != getVersionStr()) {
+      SPU_THROW(
+          "IR was generted by compiler {} and does not match current runtime "
+          "{}",
+          ir_version, getVersionStr());
+    }
+  }
+
+  res->entry_ = mlir::spu::get_entrypoint(res->module_.get());
+  SPU_ENFORCE(res->entry_, "main module not found");
+
+  return res;
+}
+
+std::string ParsedExecutable::toString() const {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  module_->print(os);
+  return str;
+}
+
+ExecutableCache &ExecutableCache::instance() {
+  // Leaked on purpose, parsed modules may outlive static destruction.
+  static auto *cache = new ExecutableCache();
+  return *cache;
+}
+
+ExecutableCache::ExecutableCache() : ctx_(makeSharedContext()) {}
+
+std::shared_ptr<const ParsedExecutable> ExecutableCache::get(
+    std::string_view code) {
+  std::shared_ptr<mlir::MLIRContext> ctx;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto itr = entries_.find(code);
+    if (itr != entries_.end()) {
+      itr->second.last_use = ++clock_;
+      ++num_hits_;
+      return itr->second.parsed;
+    }
+    ctx = ctx_;
+  }
+
+  // Parse outside the lock, the shared context is thread safe. When the same
+  // code is parsed concurrently the first inserted module wins.
+  auto parsed = ParsedExecutable::parse(code, std::move(ctx));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [itr, inserted] = entries_.try_emplace(std::string(code));
+  if (inserted) {
+    itr->second.parsed = std::move(parsed);
+  }
+  itr->second.last_use = ++clock_;
+
+  auto res = itr->second.parsed;
+  if (entries_.size() > kCapacity) {
+    auto lru = std::min_element(entries_.begin(), entries_.end(),
+                                [](const auto &lhs, const auto &rhs) {
+                                  return lhs.second.last_use <
+                                         rhs.second.last_use;
+                                });
+    entries_.erase(lru);
+    // uniqued types and attributes of evicted modules are only freed with
+    // their context.
+    if (++num_evictions_ >= kRecycleEvictions) {
+      ctx_ = makeSharedContext();
+      num_evictions_ = 0;
+    }
+  }
+  return res;
+}
+
+size_t ExecutableCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t ExecutableCache::numHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+void ExecutableCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  ctx_ = makeSharedContext();
+  num_evictions_ = 0;
+}
+
+}  // namespace spu::device
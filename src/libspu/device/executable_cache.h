@@ -0,0 +1,111 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "absl/container/flat_hash_map.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/OwningOpRef.h"
+
+namespace spu::device {
+
+// A parsed and verified pphlo module, with its entry function.
+class ParsedExecutable final {
+ public:
+  // Parses `code`, either textual IR or MLIR bytecode, into `ctx`, which must
+  // have the pphlo and func dialects loaded, and is kept alive by the result.
+  // A private context is created when `ctx` is null.
+  static std::shared_ptr<const ParsedExecutable> parse(
+      std::string_view code, std::shared_ptr<mlir::MLIRContext> ctx = nullptr);
+
+  mlir::MLIRContext *context() const { return ctx_.get(); }
+
+  bool ownsContext() const { return owns_ctx_; }
+
+  mlir::ModuleOp module() const { return module_.get(); }
+
+  mlir::func::FuncOp entry() const { return entry_; }
+
+  // Textual IR of the module, whichever format it was parsed from.
+  std::string toString() const;
+
+ private:
+  ParsedExecutable() = default;
+
+  // declared first, so destroyed after the module.
+  std::shared_ptr<mlir::MLIRContext> ctx_;
+  bool owns_ctx_ = false;
+  mlir::OwningOpRef<mlir::ModuleOp> module_;
+  mlir::func::FuncOp entry_;
+};
+
+// Process wide cache of parsed executables, keyed by the code.
+//
+// Modules are parsed into a shared (multithreaded) context, a cached module is
+// only read during execution, so it could be run by several executions at the
+// same time. The least recently used modules are dropped once more than
+// kCapacity are cached, executions still running them keep them alive.
+//
+// Memory: types and attributes are uniqued in the context and never freed
+// with the modules using them, so a context shared forever would grow with
+// every distinct executable seen. After kRecycleEvictions evictions, new
+// modules go to a fresh context, the previous one is freed with the last of
+// its modules, cached or in use. So the cache holds the modules of at most
+// kCapacity + kRecycleEvictions executables, in one or a few contexts.
+class ExecutableCache final {
+ public:
+  static constexpr size_t kCapacity = 64;
+  static constexpr size_t kRecycleEvictions = kCapacity;
+
+  static ExecutableCache &instance();
+
+  // Returns the parsed module of `code`, parses it on a miss.
+  std::shared_ptr<const ParsedExecutable> get(std::string_view code);
+
+  size_t size() const;
+
+  // number of lookups that found a parsed module.
+  size_t numHits() const;
+
+  // Drops all modules and starts a fresh context.
+  void clear();
+
+ private:
+  ExecutableCache();
+
+  struct Entry {
+    std::shared_ptr<const ParsedExecutable> parsed;
+    uint64_t last_use = 0;
+  };
+
+  // context new modules are parsed into, guarded by mutex_.
+  std::shared_ptr<mlir::MLIRContext> ctx_;
+  // evicted modules of ctx_.
+  size_t num_evictions_ = 0;
+
+  mutable std::mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  uint64_t clock_ = 0;
+  size_t num_hits_ = 0;
+};
+
+}  // namespace spu::device
@@ -0,0 +1,86 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+
+#include "libspu/device/api.h"
+#include "libspu/device/executable_cache.h"
+#include "libspu/device/pphlo/pphlo_executor.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::device {
+
+namespace {
+
+// A tiny program, so parsing dominates as with small online requests.
+constexpr char kCode[] = R"(
+func.func @main(%arg0: tensor<i32>, %arg1: tensor<i32>) -> (tensor<i32>) {
+  %0 = pphlo.add %arg0, %arg1 : tensor<i32>
+  %1 = pphlo.multiply %0, %arg1 : tensor<i32>
+  %2 = pphlo.subtract %1, %arg0 : tensor<i32>
+  return %2 : tensor<i32>
+})";
+
+std::string toBytecode(const std::string &code) {
+  auto parsed = ParsedExecutable::parse(code);
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  SPU_ENFORCE(mlir::succeeded(mlir::writeBytecodeToFile(parsed->module(), os)));
+  os.flush();
+  return bytecode;
+}
+
+void runExecutable(benchmark::State &state, const std::string &code,
+                   bool enable_cache) {
+  RuntimeConfig config;
+  config.protocol = ProtocolKind::REF2K;
+  config.field = FieldType::FM64;
+  config.experimental_enable_executable_cache = enable_cache;
+  SPUContext sctx = kernel::test::makeSPUContext(config, nullptr);
+
+  SymbolTable env;
+  env.setVar("x", kernel::test::makeValue(&sctx, 1, VIS_PUBLIC));
+  env.setVar("y", kernel::test::makeValue(&sctx, 2, VIS_PUBLIC));
+  ExecutableProto executable("bench", {"x", "y"}, {"z"}, code);
+
+  pphlo::PPHloExecutor executor;
+  ExecutableCache::instance().clear();
+  for (auto _ : state) {
+    execute(&executor, &sctx, executable, &env);
+  }
+}
+
+}  // namespace
+
+// Parses the textual IR on every run.
+void BMExecuteText(benchmark::State &state) {
+  runExecutable(state, kCode, false);
+}
+BENCHMARK(BMExecuteText);
+
+// Parses bytecode on every run.
+void BMExecuteBytecode(benchmark::State &state) {
+  runExecutable(state, toBytecode(kCode), false);
+}
+BENCHMARK(BMExecuteBytecode);
+
+// Parses once, later runs reuse the cached module.
+void BMExecuteCached(benchmark::State &state) {
+  runExecutable(state, kCode, true);
+}
+BENCHMARK(BMExecuteCached);
+
+}  // namespace spu::device
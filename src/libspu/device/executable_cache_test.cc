@@ -0,0 +1,101 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/executable_cache.h"
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+
+namespace spu::device {
+
+namespace {
+
+constexpr char kCode[] = R"(
+func.func @main(%arg0: tensor<i32>, %arg1: tensor<i32>) -> (tensor<i32>) {
+  %0 = pphlo.add %arg0, %arg1 : tensor<i32>
+  return %0 : tensor<i32>
+})";
+
+std::string printModule(mlir::ModuleOp module) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  module.print(os);
+  return os.str();
+}
+
+}  // namespace
+
+TEST(ExecutableCacheTest, Parse) {
+  auto parsed = ParsedExecutable::parse(kCode);
+  EXPECT_TRUE(parsed->ownsContext());
+  EXPECT_EQ(parsed->entry().getName(), "main");
+
+  EXPECT_ANY_THROW(ParsedExecutable::parse("not a module"));
+  EXPECT_ANY_THROW(ParsedExecutable::parse(
+      R"(module attributes {pphlo.version = "0.0.0"} {)" + std::string(kCode) +
+      "}"));
+}
+
+TEST(ExecutableCacheTest, Bytecode) {
+  auto text = ParsedExecutable::parse(kCode);
+
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  ASSERT_TRUE(mlir::succeeded(mlir::writeBytecodeToFile(text->module(), os)));
+  os.flush();
+
+  auto parsed = ParsedExecutable::parse(bytecode);
+  EXPECT_EQ(parsed->entry().getName(), "main");
+  EXPECT_EQ(printModule(parsed->module()), printModule(text->module()));
+}
+
+TEST(ExecutableCacheTest, Get) {
+  auto &cache = ExecutableCache::instance();
+  cache.clear();
+
+  auto hits = cache.numHits();
+  auto first = cache.get(kCode);
+  EXPECT_FALSE(first->ownsContext());
+  EXPECT_EQ(cache.numHits(), hits);
+  EXPECT_EQ(cache.get(kCode), first);
+  EXPECT_EQ(cache.numHits(), hits + 1);
+  EXPECT_EQ(cache.size(), 1);
+
+  // the least recently used one is dropped.
+  for (size_t idx = 0; idx < ExecutableCache::kCapacity; ++idx) {
+    cache.get(fmt::format("{}\n// {}", kCode, idx));
+  }
+  EXPECT_EQ(cache.size(), ExecutableCache::kCapacity);
+  EXPECT_NE(cache.get(kCode), first);
+  // still usable by its holder.
+  EXPECT_EQ(first->entry().getName(), "main");
+
+  // evicted modules free their context once enough of them are evicted, new
+  // modules go to a fresh one.
+  for (size_t idx = 0; idx < ExecutableCache::kRecycleEvictions; ++idx) {
+    cache.get(fmt::format("{}
+// recycled {}", kCode, idx));
+  }
+  auto fresh = cache.get(fmt::format("{}
+// fresh", kCode));
+  EXPECT_NE(fresh->context(), first->context());
+  EXPECT_EQ(first->entry().getName(), "main");
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
+}  // namespace spu::device
@@ -15,8 +15,14 @@
 #include "libspu/device/executor.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <exception>
 #include <mutex>
+#include <numeric>
+#include <optional>
+#include <queue>
 
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/Region.h"
@@ -24,22 +30,140 @@
 #include "libspu/core/context.h"
 #include "libspu/core/prelude.h"
 #include "libspu/core/value.h"
+#include "libspu/device/cost_model.h"
 #include "libspu/device/intrinsic_table.h"
+#include "libspu/device/op_scheduler.h"
 #include "libspu/dialect/pphlo/IR/ops.h"
 
 namespace spu::device {
 
-spu::Value SymbolScope::lookupValue(mlir::Value key) const {
-  {
-    std::shared_lock<std::shared_mutex> lk(mu_);
-    auto itr = symbols_.find(key);
+RegionNumbering::RegionNumbering(mlir::Region &region,
+                                 const OpExecutor *executor) {
+  auto number = [&](mlir::Value v) {
+    const auto slot = static_cast<uint32_t>(slots_.size());
+    return slots_.try_emplace(v, slot).second;
+  };
+
+  for (auto &block : region) {
+    for (const auto &arg : block.getArguments()) {
+      number(arg);
+    }
+    for (auto &op : block) {
+      for (const auto &result : op.getResults()) {
+        number(result);
+      }
+    }
+  }
+
+  // Values defined above, nested regions capture through this scope too.
+  region.walk([&](mlir::Operation *op) {
+    for (const auto &operand : op->getOperands()) {
+      if (!region.isAncestor(operand.getParentRegion()) && number(operand)) {
+        captures_.emplace_back(operand);
+      }
+    }
+  });
+
+  if (executor == nullptr || !region.hasOneBlock()) {
+    return;
+  }
+  auto &block = region.front();
+  auto *term_op = block.getTerminator();
+  if (term_op == nullptr) {
+    return;
+  }
 
-    if (itr != symbols_.end()) {
-      return itr->second;
+  // Operands of ops in the block are either defined in it or captured.
+  LoweredBlock lowered;
+  lowered.executor = executor;
+  lowered.block = &block;
+  for (auto &op : block.without_terminator()) {
+    auto &inst = lowered.instructions.emplace_back();
+    inst.op = &op;
+    for (const auto &operand : op.getOperands()) {
+      inst.operands.emplace_back(slots_.lookup(operand));
     }
+    for (const auto &result : op.getResults()) {
+      inst.results.emplace_back(slots_.lookup(result));
+    }
+    executor->lowerOp(inst);
+  }
+  for (const auto &operand : term_op->getOperands()) {
+    lowered.return_slots.emplace_back(slots_.lookup(operand));
   }
+  lowered_ = std::move(lowered);
+}
 
+ValueNumbering::ValueNumbering(mlir::Region &root, const OpExecutor *executor) {
+  regions_[&root] = std::make_unique<RegionNumbering>(root, executor);
+  root.walk([&](mlir::Operation *op) {
+    for (auto &r : op->getRegions()) {
+      regions_[&r] = std::make_unique<RegionNumbering>(r, executor);
+    }
+  });
+
+  // A nested region captures from its enclosing region, which numbers the
+  // captured values too, as they are used by its nested ops.
+  root.walk([&](mlir::Operation *op) {
+    const auto *parent = getRegion(op->getParentRegion());
+    for (auto &r : op->getRegions()) {
+      auto &numbering = *regions_[&r];
+      numbering.parent_ = parent;
+      for (const auto &key : numbering.captures_) {
+        numbering.parent_slots_.emplace_back(
+            static_cast<uint32_t>(parent->getSlot(key)));
+      }
+    }
+  });
+}
+
+SymbolScope::SymbolScope(mlir::Region &region, SymbolScope *parent,
+                         const OpExecutor *executor)
+    : parent_(parent) {
   if (parent_ != nullptr) {
+    region_ = parent_->numbering_->getRegion(&region);
+    if (region_ != nullptr) {
+      numbering_ = parent_->numbering_;
+    }
+  }
+
+  if (region_ == nullptr) {
+    numbering_ = std::make_shared<ValueNumbering>(region, executor);
+    region_ = numbering_->getRegion(&region);
+  }
+
+  slots_ = std::make_unique<Slot[]>(region_->numSlots());
+
+  const auto captures = region_->getCaptures();
+  if (captures.empty()) {
+    return;
+  }
+  SPU_ENFORCE(parent_ != nullptr,
+              "region uses values defined above, but has no parent scope");
+
+  // Scopes of loop bodies are created on every iteration, copy by slot when
+  // the parent runs the enclosing region.
+  const auto parent_slots = parent_->numbering_ == numbering_
+                                ? region_->getCaptureSlots(parent_->region_)
+                                : llvm::ArrayRef<uint32_t>();
+  for (size_t idx = 0; idx < captures.size(); ++idx) {
+    addValue(captures[idx], parent_slots.empty()
+                                ? parent_->lookupValue(captures[idx])
+                                : parent_->lookupSlot(parent_slots[idx]));
+  }
+}
+
+SymbolScope::Slot *SymbolScope::findSlot(mlir::Value key) const {
+  const auto slot = region_->getSlot(key);
+  return slot < 0 ? nullptr : &slots_[slot];
+}
+
+spu::Value SymbolScope::lookupValue(mlir::Value key) const {
+  if (const auto *slot = findSlot(key)) {
+    if (slot->ready.load(std::memory_order_acquire)) {
+      return slot->value;
+    }
+  } else if (parent_ != nullptr) {
     return parent_->lookupValue(key);
   }
 
@@ -50,11 +174,28 @@ spu::Value SymbolScope::lookupValue(mlir::Value key) const {
   //            mlirObjectToString(*v.getDefiningOp()));
 }
 
-bool SymbolScope::hasValueUnsafe(mlir::Value key) const {
-  auto itr = symbols_.find(key);
+spu::Value SymbolScope::lookupSlot(uint32_t slot) const {
+  const auto &s = slots_[slot];
+  SPU_ENFORCE(s.ready.load(std::memory_order_acquire),
+              "Should not be here, symbol not found");
+  return s.value;
+}
+
+void SymbolScope::addSlot(uint32_t slot, spu::Value &&val) {
+  auto &s = slots_[slot];
+  s.value = std::move(val);
+  s.ready.store(true, std::memory_order_release);
+}
+
+void SymbolScope::removeSlot(uint32_t slot) {
+  auto &s = slots_[slot];
+  s.ready.store(false, std::memory_order_release);
+  s.value = spu::Value();
+}
 
-  if (itr != symbols_.end()) {
-    return true;
+bool SymbolScope::hasValue(mlir::Value key) const {
+  if (const auto *slot = findSlot(key)) {
+    return slot->ready.load(std::memory_order_acquire);
   }
 
   if (parent_ != nullptr) {
@@ -65,40 +206,34 @@ bool SymbolScope::hasValueUnsafe(mlir::Value key) const {
 }
 
 bool SymbolScope::hasValues(mlir::OperandRange keys) const {
-  std::shared_lock<std::shared_mutex> lk(mu_);
   return std::all_of(keys.begin(), keys.end(), [this](const mlir::Value &key) {
-    return hasValueUnsafe(key);
+    return hasValue(key);
   });
 }
 
 bool SymbolScope::hasValues(llvm::ArrayRef<mlir::Value> keys) const {
-  if (keys.empty()) {
-    return true;
-  }
-  std::shared_lock<std::shared_mutex> lk(mu_);
   return std::all_of(keys.begin(), keys.end(), [this](const mlir::Value &key) {
-    return hasValueUnsafe(key);
+    return hasValue(key);
   });
 }
 
-bool SymbolScope::hasValue(mlir::Value key) const {
-  std::shared_lock<std::shared_mutex> lk(mu_);
-  return hasValueUnsafe(key);
-}
-
 void SymbolScope::addValue(mlir::Value key, const spu::Value &val) {
-  std::lock_guard<std::shared_mutex> lk(mu_);
-  symbols_[key] = val;
+  addValue(key, spu::Value(val));
 }
 
 void SymbolScope::addValue(mlir::Value key, spu::Value &&val) {
-  std::lock_guard<std::shared_mutex> lk(mu_);
-  symbols_[key] = std::move(val);
+  auto *slot = findSlot(key);
+  SPU_ENFORCE(slot != nullptr, "value is not defined in this region");
+  // SSA values are defined once, so nobody reads the slot before it's ready.
+  slot->value = std::move(val);
+  slot->ready.store(true, std::memory_order_release);
 }
 
 void SymbolScope::removeValue(mlir::Value key) {
-  std::lock_guard<std::shared_mutex> lk(mu_);
-  symbols_.erase(key);
+  if (auto *slot = findSlot(key)) {
+    slot->ready.store(false, std::memory_order_release);
+    slot->value = spu::Value();
+  }
 }
 
 std::vector<spu::Value> runRegion(OpExecutor *executor,                 //
@@ -107,19 +242,22 @@ std::vector<spu::Value> runRegion(OpExecutor *executor,                 //
                                   mlir::Region &region,                 //
                                   absl::Span<spu::Value const> params,  //
                                   const ExecutionOptions &opts) {
+  // the arguments below are those of the entry block.
+  SPU_ENFORCE(region.hasOneBlock());
   SPU_ENFORCE(region.getNumArguments() == params.size(),
               "region requires {} arguments while got number of params {}",
               region.getRegionNumber(), params.size());
 
   // create a new scope for this region.
-  SymbolScope sscope(parent_scope);
+  SymbolScope sscope(region, parent_scope, executor);
 
-  // inject the parameters to region's symbol table.
+  // inject the parameters to region's symbol table, block arguments are
+  // numbered first.
   for (const auto &blkarg : region.getArguments()) {
-    sscope.addValue(blkarg, params[blkarg.getArgNumber()]);
+    sscope.addSlot(blkarg.getArgNumber(),
+                   spu::Value(params[blkarg.getArgNumber()]));
   }
 
-  SPU_ENFORCE(region.hasOneBlock());
   if (opts.do_parallel) {
     return runBlockParallel(executor, sctx, &sscope, region.front(), params,
                             opts);
@@ -128,11 +266,72 @@ std::vector<spu::Value> runRegion(OpExecutor *executor,                 //
   }
 }
 
+namespace {
+
+// Announces the kernels of a block to the protocol while it runs, one segment
+// at a time: the ops up to the next op with regions, whose nested blocks
+// announce their own kernels before the rest of this block runs.
+class BlockHinter {
+  const CostModel *model_;
+  SPUContext *sctx_;
+  // ops left in the announced segment.
+  size_t remaining_ = 0;
+
+ public:
+  BlockHinter(const CostModel *model, SPUContext *sctx)
+      : model_(model), sctx_(sctx) {}
+
+  // Called before running each op of the block, in order.
+  void before(mlir::Operation &op) {
+    if (model_ == nullptr) {
+      return;
+    }
+    if (remaining_ == 0) {
+      std::vector<KernelHint> calls;
+      for (auto *cur = &op; cur != nullptr; cur = cur->getNextNode()) {
+        ++remaining_;
+        if (auto op_calls = model_->kernelCalls(cur)) {
+          calls.insert(calls.end(), op_calls->begin(), op_calls->end());
+        }
+        if (cur->getNumRegions() > 0) {
+          break;
+        }
+      }
+      if (!calls.empty()) {
+        sctx_->prot()->hint(calls);
+      }
+    }
+    --remaining_;
+  }
+};
+
+}  // namespace
+
 std::vector<spu::Value> runBlock(OpExecutor *executor, SPUContext *sctx,
                                  SymbolScope *symbols, mlir::Block &block,
                                  absl::Span<spu::Value const> /*params*/,
                                  const ExecutionOptions &opts) {
+  BlockHinter hinter(opts.hint_model, sctx);
+  if (const auto *lowered = symbols->getLowered(executor, &block)) {
+    for (const auto &inst : lowered->instructions) {
+      hinter.before(*inst.op);
+      if (inst.kernel != nullptr) {
+        inst.kernel(executor, sctx, symbols, inst, opts);
+      } else {
+        executor->runKernel(sctx, symbols, *inst.op, opts);
+      }
+    }
+
+    std::vector<spu::Value> results;
+    results.reserve(lowered->return_slots.size());
+    for (const auto slot : lowered->return_slots) {
+      results.emplace_back(symbols->lookupSlot(slot));
+    }
+    return results;
+  }
+
   for (auto &op : block.without_terminator()) {
+    hinter.before(op);
     executor->runKernel(sctx, symbols, op, opts);
   }
 
@@ -150,93 +349,221 @@ std::vector<spu::Value> runBlock(OpExecutor *executor, SPUContext *sctx,
   SPU_THROW("Should not be here");
 }
 
-struct SymbolTableEvent {
-  std::condition_variable cv;
-  std::mutex mutex;
-};
+namespace {
+
+// Rounds assumed for ops the cost model can not price, e.g. non-linear
+// approximations, which take tens of rounds.
+constexpr size_t kUnmodeledRounds = 16;
 
-class OpExecTask final {
-  std::unique_ptr<SPUContext> sctx_ = nullptr;
+// Rounds of an op, including the ops of its regions.
+size_t estimateRounds(const CostModel &model, mlir::Operation &op) {
+  size_t rounds = 0;
+  op.walk([&](mlir::Operation *nested) {
+    auto cost = model.estimate(nested);
+    rounds += cost.has_value() ? cost->rounds : kUnmodeledRounds;
+  });
+  return rounds;
+}
+
+}  // namespace
+
+// Tasks of a block keep its runner alive, those left in the scheduler once the
+// block is done only find claimed ops and return.
+class BlockParallelRunner final
+    : public std::enable_shared_from_this<BlockParallelRunner> {
+  struct OpNode {
+    mlir::Operation *op = nullptr;
+    // the op with its kernel resolved, if the block is lowered.
+    const LoweredOp *inst = nullptr;
+    // all parties get a 'corresponding' context for the same op.
+    std::unique_ptr<SPUContext> sctx;
+    // number of unfinished ops this op depends on.
+    std::atomic<int64_t> pending{0};
+    // set by the first thread which takes this op.
+    std::atomic<bool> claimed{false};
+    // guarded by runner's mutex.
+    bool done = false;
+    // ops depending on this op.
+    llvm::SmallVector<size_t> successors;
+    std::atomic<TimePoint> ready_at;
+    // rounds on the longest path from this op to the end of the block.
+    size_t priority = 0;
+  };
+
+  SPUContext *sctx_ = nullptr;
   // here we assume executor is thread-safe (stateless)
   OpExecutor *executor_ = nullptr;
   SymbolScope *sscope_ = nullptr;
-  mlir::Operation *op_ = nullptr;
-  SymbolTableEvent *event_ = nullptr;
-  llvm::SmallVector<mlir::Value> extra_dependencies_;
+  ExecutionOptions opts_;
+  OpScheduler *scheduler_ = nullptr;
+  // nullptr if the block is not lowered.
+  const LoweredBlock *lowered_ = nullptr;
+
+  std::vector<std::unique_ptr<OpNode>> nodes_;
+  // order in which the driving thread takes ops, a topological order.
+  std::vector<size_t> order_;
+  TimePoint start_;
+
+  std::mutex mu_;
+  // only the thread driving this block waits on it.
+  std::condition_variable cv_;
+  // number of ops being executed, by any thread. Pending tasks are not
+  // counted, a driver running on a pool worker would otherwise wait for tasks
+  // queued on its own deque, which no other thread may ever steal.
+  int64_t running_ = 0;
+  std::exception_ptr error_;
+  // with a cost model, ready ops as (priority, -index), the most critical one
+  // first.
+  std::priority_queue<std::pair<size_t, int64_t>> ready_;
 
  public:
-  OpExecTask() = default;
-  explicit OpExecTask(std::unique_ptr<SPUContext> sctx, OpExecutor *executor,
-                      SymbolScope *sscope, mlir::Operation *op,
-                      SymbolTableEvent *event,
-                      const llvm::SmallVector<mlir::Value> &extra_dependencies)
-      : sctx_(std::move(sctx)),
+  explicit BlockParallelRunner(SPUContext *sctx, OpExecutor *executor,
+                               SymbolScope *sscope,
+                               const ExecutionOptions &opts,
+                               OpScheduler *scheduler)
+      : sctx_(sctx),
         executor_(executor),
         sscope_(sscope),
-        op_(op),
-        event_(event),
-        extra_dependencies_(extra_dependencies.begin(),
-                            extra_dependencies.end()) {
-    // If a op has nested regions, it may depend on more values than operands
-    // FIXME: (azheng) Implement a better notify mechanism
-    if (op->getNumRegions() > 0) {
-      const auto *current_region = op->getParentRegion();
-      for (auto &r : op->getRegions()) {
-        r.walk([&](mlir::Operation *nested_op) {
-          for (const auto &o : nested_op->getOperands()) {
-            if ((o.getDefiningOp() != nullptr) &&
-                o.getDefiningOp()->getParentRegion() == current_region) {
-              extra_dependencies_.emplace_back(o);
-            }
-          }
+        opts_(opts),
+        scheduler_(scheduler) {
+    opts_.scheduler = scheduler;
+  }
+
+  std::vector<spu::Value> run(mlir::Block &block) {
+    start_ = std::chrono::high_resolution_clock::now();
+    buildGraph(block);
+
+    for (size_t idx = 0; idx < nodes_.size(); ++idx) {
+      if (nodes_[idx]->pending.load() == 0) {
+        schedule(idx);
+      }
+    }
+
+    // This thread drives ops in order_, the same on every party: it takes the
+    // op itself unless a worker already did. Workers only run ops ahead of the
+    // driver, so the first unfinished op is always running on every party,
+    // otherwise workers blocked on communication of later ops could starve it
+    // across parties.
+    for (auto idx : order_) {
+      auto &node = *nodes_[idx];
+      {
+        std::unique_lock lk(mu_);
+        cv_.wait(lk, [&] {
+          return error_ || node.done || node.pending.load() == 0;
         });
+        if (error_) {
+          break;
+        }
+      }
+
+      execute(idx);
+
+      std::unique_lock lk(mu_);
+      cv_.wait(lk, [&] { return error_ || node.done; });
+      if (error_) {
+        break;
       }
     }
-  }
 
-  bool ready() {
-    return sscope_->hasValues(op_->getOperands()) &&
-           sscope_->hasValues(extra_dependencies_);
-  }
+    // Ops taken by workers may still run after an error.
+    {
+      std::unique_lock lk(mu_);
+      cv_.wait(lk, [&] { return running_ == 0; });
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+    }
 
-  void run(const ExecutionOptions &opts) {
-    // wait for this operation ready.
-    if (op_->getNumOperands() > 0) {
-      std::unique_lock lk(event_->mutex);
-      event_->cv.wait(lk, [this] { return ready(); });
+    if (lowered_ != nullptr) {
+      std::vector<spu::Value> results;
+      results.reserve(lowered_->return_slots.size());
+      for (const auto slot : lowered_->return_slots) {
+        results.emplace_back(sscope_->lookupSlot(slot));
+      }
+      return results;
     }
 
-    executor_->runKernel(sctx_.get(), sscope_, *op_, opts);
-    std::unique_lock lk(event_->mutex);
-    event_->cv.notify_all();
+    if (auto *termOp = block.getTerminator()) {
+      // TODO: enforce ReturnLike
+      std::vector<spu::Value> results;
+      results.reserve(termOp->getNumOperands());
+      for (const auto operand : termOp->getOperands()) {
+        results.emplace_back(sscope_->lookupValue(operand));
+      }
+      return results;
+    }
+
+    // No terminator
+    SPU_THROW("Should not be here");
   }
-};
 
-class BlockParallelRunner final {
-  std::mutex queue_mtx_;
+ private:
+  void buildGraph(mlir::Block &block) {
+    lowered_ = sscope_->getLowered(executor_, &block);
+    llvm::DenseMap<mlir::Operation *, size_t> op_index;
+    for (auto &op : block.without_terminator()) {
+      op_index[&op] = nodes_.size();
+      auto node = std::make_unique<OpNode>();
+      node->op = &op;
+      if (lowered_ != nullptr) {
+        node->inst = &lowered_->instructions[nodes_.size()];
+      }
+      // fork in program order, so all parties agree on the sub-links.
+      node->sctx = sctx_->fork();
+      node->ready_at = start_;
+      nodes_.emplace_back(std::move(node));
+    }
 
-  std::vector<std::thread> threads_;
-  std::queue<OpExecTask> task_queue_;
+    std::optional<size_t> last_side_effect;
+    for (size_t idx = 0; idx < nodes_.size(); ++idx) {
+      auto &op = *nodes_[idx]->op;
+      llvm::SmallVector<size_t> deps;
+
+      auto addDep = [&](mlir::Value v) {
+        auto *def = v.getDefiningOp();
+        if (def == nullptr || def->getBlock() != &block) {
+          // block arguments and values of parent scopes are already there.
+          return;
+        }
+        deps.emplace_back(op_index.lookup(def));
+      };
+
+      for (const auto &operand : op.getOperands()) {
+        addDep(operand);
+      }
 
-  SPUContext *sctx_ = nullptr;
-  // here we assume executor is thread-safe (stateless)
-  OpExecutor *executor_ = nullptr;
-  SymbolScope *sscope_ = nullptr;
-  ExecutionOptions opts_;
+      // If a op has nested regions, it may depend on more values than operands
+      for (auto &r : op.getRegions()) {
+        r.walk([&](mlir::Operation *nested_op) {
+          for (const auto &o : nested_op->getOperands()) {
+            addDep(o);
+          }
+        });
+      }
 
- public:
-  BlockParallelRunner() = default;
-  explicit BlockParallelRunner(SPUContext *sctx, OpExecutor *executor,
-                               SymbolScope *sscope,
-                               const ExecutionOptions &opts)
-      : sctx_(sctx), executor_(executor), sscope_(sscope), opts_(opts) {}
+      if (last_side_effect.has_value()) {
+        deps.emplace_back(*last_side_effect);
+      }
+
+      // FreeOp has an implicit requirement that it needs to be invoked after
+      // all other uses are done.
+      if (auto free_op = llvm::dyn_cast<mlir::spu::pphlo::FreeOp>(op)) {
+        for (auto *user : free_op.getOperand().getUsers()) {
+          auto *ancestor = block.findAncestorOpInBlock(*user);
+          auto itr = op_index.find(ancestor);
+          if (itr != op_index.end() && itr->second < idx) {
+            deps.emplace_back(itr->second);
+          }
+        }
+      }
+
+      std::sort(deps.begin(), deps.end());
+      deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+      for (auto dep : deps) {
+        nodes_[dep]->successors.emplace_back(idx);
+      }
+      nodes_[idx]->pending = static_cast<int64_t>(deps.size());
 
-  std::vector<spu::Value> run(mlir::Block &block) {
-    SymbolTableEvent st_event;
-    llvm::SmallVector<mlir::Value> extra_dependencies;
-    for (auto &op : block.without_terminator()) {
-      task_queue_.emplace(sctx_->fork(), executor_, sscope_, &op, &st_event,
-                          extra_dependencies);
       // FIXME(jimi): DBG_PRINT has side effect but has no outputs. We should
       // use more formal scheduling policy
       if (auto custom_call = llvm::dyn_cast<mlir::spu::pphlo::CustomCallOp>(op);
@@ -245,55 +572,151 @@ class BlockParallelRunner final {
       }
       auto hasSideEffect = op.getAttrOfType<mlir::BoolAttr>("has_side_effect");
       if (hasSideEffect && hasSideEffect.getValue()) {
-        extra_dependencies.append(op.getResults().begin(),
-                                  op.getResults().end());
+        last_side_effect = idx;
       }
     }
 
-    threads_.reserve(opts_.concurrency);
-    for (uint64_t i = 0; i < opts_.concurrency; i++) {
-      threads_.emplace_back(&BlockParallelRunner::run_task, this);
+    order_.resize(nodes_.size());
+    std::iota(order_.begin(), order_.end(), 0);
+    if (opts_.cost_model == nullptr) {
+      return;
     }
 
-    for (uint64_t i = 0; i < opts_.concurrency; i++) {
-      if (threads_[i].joinable()) {
-        threads_[i].join();
+    // Successors come later in program order.
+    for (size_t idx = nodes_.size(); idx-- > 0;) {
+      auto &node = *nodes_[idx];
+      size_t tail = 0;
+      for (auto succ : node.successors) {
+        tail = std::max(tail, nodes_[succ]->priority);
       }
+      node.priority = estimateRounds(*opts_.cost_model, *node.op) + tail;
     }
+    // An op's priority is at least the one of its successors and ties keep
+    // program order, so this is still a topological order.
+    std::stable_sort(order_.begin(), order_.end(), [&](size_t lhs, size_t rhs) {
+      return nodes_[lhs]->priority > nodes_[rhs]->priority;
+    });
+  }
 
-    if (auto *termOp = block.getTerminator()) {
-      // TODO: enforce ReturnLike
-      std::vector<spu::Value> results;
-      results.reserve(termOp->getNumOperands());
-      for (const auto operand : termOp->getOperands()) {
-        results.emplace_back(sscope_->lookupValue(operand));
+  void schedule(size_t idx) {
+    nodes_[idx]->ready_at = std::chrono::high_resolution_clock::now();
+    if (opts_.hint_model != nullptr) {
+      // each op runs in its own fork, which prefetches while the op is queued.
+      auto calls = opts_.hint_model->kernelCalls(nodes_[idx]->op);
+      if (calls.has_value() && !calls->empty()) {
+        nodes_[idx]->sctx->prot()->hint(*calls);
       }
-      return results;
     }
+    if (opts_.cost_model != nullptr) {
+      std::unique_lock lk(mu_);
+      ready_.emplace(nodes_[idx]->priority, -static_cast<int64_t>(idx));
+    }
+    scheduler_->submit([self = shared_from_this(), idx] {
+      if (self->opts_.cost_model != nullptr) {
+        // Each ready op submits a task, which takes the most critical one.
+        self->executeMostCritical();
+      } else {
+        self->execute(idx);
+      }
+    });
+  }
 
-    // No terminator
-    SPU_THROW("Should not be here");
+  void executeMostCritical() {
+    while (true) {
+      size_t idx = 0;
+      {
+        std::unique_lock lk(mu_);
+        if (ready_.empty()) {
+          return;
+        }
+        idx = static_cast<size_t>(-ready_.top().second);
+        ready_.pop();
+      }
+      // skip ops already taken by the driving thread.
+      if (!nodes_[idx]->claimed.load()) {
+        execute(idx);
+        return;
+      }
+    }
   }
 
-  void run_task() {
-    std::unique_lock queue_lock(queue_mtx_);
+  void execute(size_t idx) {
+    auto &node = *nodes_[idx];
+    if (node.claimed.exchange(true)) {
+      return;
+    }
 
-    while (!task_queue_.empty()) {
-      auto op = std::move(task_queue_.front());
-      task_queue_.pop();
-      queue_lock.unlock();
-      op.run(opts_);
-      queue_lock.lock();
+    {
+      // after an error, the driver only waits for running ops.
+      std::unique_lock lk(mu_);
+      if (error_) {
+        return;
+      }
+      running_++;
+    }
+
+    const auto started = std::chrono::high_resolution_clock::now();
+    try {
+      if (node.inst != nullptr && node.inst->kernel != nullptr) {
+        node.inst->kernel(executor_, node.sctx.get(), sscope_, *node.inst,
+                          opts_);
+      } else {
+        executor_->runKernel(node.sctx.get(), sscope_, *node.op, opts_);
+      }
+      // the forked context ends with the op.
+      node.sctx->prot()->flush();
+    } catch (...) {
+      std::unique_lock lk(mu_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      running_--;
+      cv_.notify_all();
+      return;
     }
+    const auto finished = std::chrono::high_resolution_clock::now();
+
+    if (scheduler_->isStatsEnabled()) {
+      const TimePoint ready_at = node.ready_at;
+      scheduler_->recordOp(node.op->getName().getStringRef().str(),
+                           ready_at - start_, started - ready_at,
+                           finished - started);
+    }
+
+    for (auto succ : node.successors) {
+      if (nodes_[succ]->pending.fetch_sub(1) == 1) {
+        schedule(succ);
+      }
+    }
+
+    std::unique_lock lk(mu_);
+    node.done = true;
+    running_--;
+    cv_.notify_all();
   }
 };
 
 std::vector<spu::Value> runBlockParallel(
     OpExecutor *executor, SPUContext *sctx, SymbolScope *symbols,
-    mlir::Block &block, absl::Span<spu::Value const> /*params*/,
+    mlir::Block &block, absl::Span<spu::Value const> params,
     const ExecutionOptions &opts) {
-  BlockParallelRunner runner(sctx, executor, symbols, opts);
-  return runner.run(block);
+  if (opts.scheduler != nullptr) {
+    if (opts.scheduler->numWorkers() == 0) {
+      return runBlock(executor, sctx, symbols, block, params, opts);
+    }
+    auto runner = std::make_shared<BlockParallelRunner>(sctx, executor, symbols,
+                                                        opts, opts.scheduler);
+    return runner->run(block);
+  }
+
+  if (opts.concurrency <= 1) {
+    return runBlock(executor, sctx, symbols, block, params, opts);
+  }
+  // No pool from the caller, use one for this block and its nested regions.
+  OpScheduler scheduler(opts.concurrency);
+  auto runner = std::make_shared<BlockParallelRunner>(sctx, executor, symbols,
+                                                      opts, &scheduler);
+  return runner->run(block);
 }
 
 }  // namespace spu::device
@@ -14,10 +14,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
-#include <shared_mutex>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "llvm/ADT/DenseMap.h"
+#include "mlir/IR/Region.h"
 #include "mlir/IR/Value.h"
 #include "mlir/IR/ValueRange.h"
 
@@ -26,21 +30,161 @@
 
 namespace spu::device {
 
+class CostModel;
+class OpExecutor;
+class OpScheduler;
+class SymbolScope;
+struct ExecutionOptions;
+
+struct LoweredOp;
+
+// A kernel resolved once ahead of execution, see OpExecutor::lowerOp.
+using KernelFn = void (*)(OpExecutor *executor, SPUContext *sctx,
+                          SymbolScope *sscope, const LoweredOp &inst,
+                          const ExecutionOptions &opts);
+
+// Attributes of an op decoded when it is lowered, e.g. shapes and axes, so its
+// kernel does not read them from the mlir op on every run.
+struct LoweredAttrs {
+  virtual ~LoweredAttrs() = default;
+};
+
+// An op lowered for one executor.
+struct LoweredOp {
+  mlir::Operation *op = nullptr;
+  // slots of the operands and results of the op in its region, see
+  // SymbolScope::lookupSlot.
+  llvm::SmallVector<uint32_t, 4> operands;
+  llvm::SmallVector<uint32_t, 2> results;
+  // nullptr if the op is dispatched by OpExecutor::runKernel.
+  KernelFn kernel = nullptr;
+  // set by the executor for kernels which have attributes.
+  std::shared_ptr<const LoweredAttrs> attrs;
+
+  template <typename T>
+  const T &getAttrs() const {
+    return static_cast<const T &>(*attrs);
+  }
+};
+
+// A block lowered to a flat instruction stream for one executor: its ops in
+// program order with their kernels resolved, and the slots of the values it
+// returns.
+struct LoweredBlock {
+  const OpExecutor *executor = nullptr;
+  const mlir::Block *block = nullptr;
+  std::vector<LoweredOp> instructions;
+  llvm::SmallVector<uint32_t> return_slots;
+};
+
+// Dense numbering of the SSA values visible in a region.
+//
+// Block arguments and op results of the region are numbered, as well as values
+// defined above the region but used by its ops (or by ops of nested regions),
+// so a scope can capture them once at entry and never walk its parents.
+//
+// When an executor is given, the block of the region is also lowered for it,
+// so running the region again, e.g. each iteration of a loop body, does not
+// dispatch on the mlir ops again.
+class RegionNumbering final {
+  llvm::DenseMap<mlir::Value, uint32_t> slots_;
+  llvm::SmallVector<mlir::Value> captures_;
+  // slots of the captures in the parent region, set by ValueNumbering.
+  const RegionNumbering *parent_ = nullptr;
+  llvm::SmallVector<uint32_t> parent_slots_;
+  std::optional<LoweredBlock> lowered_;
+
+  friend class ValueNumbering;
+
+ public:
+  explicit RegionNumbering(mlir::Region &region,
+                           const OpExecutor *executor = nullptr);
+
+  size_t numSlots() const { return slots_.size(); }
+
+  // return nullptr if the block was not lowered for the executor.
+  const LoweredBlock *getLowered(const OpExecutor *executor,
+                                 const mlir::Block *block) const {
+    if (lowered_.has_value() && lowered_->executor == executor &&
+        lowered_->block == block) {
+      return &*lowered_;
+    }
+    return nullptr;
+  }
+
+  // return the slot of the value, or -1 if the value is not visible.
+  int64_t getSlot(mlir::Value key) const {
+    auto itr = slots_.find(key);
+    return itr == slots_.end() ? -1 : itr->second;
+  }
+
+  llvm::ArrayRef<mlir::Value> getCaptures() const { return captures_; }
+
+  // return the slots of the captures in `parent`, empty if `parent` is not
+  // the numbering of the enclosing region.
+  llvm::ArrayRef<uint32_t> getCaptureSlots(
+      const RegionNumbering *parent) const {
+    if (parent != parent_) {
+      return {};
+    }
+    return parent_slots_;
+  }
+};
+
+// Numbering of a region and all regions nested inside, computed once before
+// execution and read-only afterwards.
+class ValueNumbering final {
+  llvm::DenseMap<mlir::Region *, std::unique_ptr<RegionNumbering>> regions_;
+
+ public:
+  explicit ValueNumbering(mlir::Region &root,
+                          const OpExecutor *executor = nullptr);
+
+  // return nullptr if the region is not nested in root.
+  const RegionNumbering *getRegion(mlir::Region *region) const {
+    auto itr = regions_.find(region);
+    return itr == regions_.end() ? nullptr : itr->second.get();
+  }
+};
+
 //
 class SymbolScope final {
   // The parent region, null if this region is isolated from above.
   SymbolScope *parent_;
 
-  // Local symbols inside this value.
-  mutable std::shared_mutex mu_;
-  llvm::DenseMap<mlir::Value, spu::Value> symbols_;
+  // Numbering shared by all scopes of the same function.
+  std::shared_ptr<const ValueNumbering> numbering_;
+  const RegionNumbering *region_ = nullptr;
+
+  // Local symbols inside this value, a value is published by setting `ready`
+  // after it's written, so lookup does not need a lock.
+  struct Slot {
+    std::atomic<bool> ready{false};
+    spu::Value value;
+  };
+  std::unique_ptr<Slot[]> slots_;
 
  public:
-  explicit SymbolScope(SymbolScope *parent = nullptr) : parent_(parent) {}
+  // Captured values are copied from parent when the scope is created, so all
+  // values used by the region must be defined by then. The regions are
+  // lowered for `executor` when the scope creates their numbering.
+  explicit SymbolScope(mlir::Region &region, SymbolScope *parent = nullptr,
+                       const OpExecutor *executor = nullptr);
 
   // return true if this is the root scope.
   bool isRoot() const { return parent_ == nullptr; }
 
+  // return nullptr if the block was not lowered for the executor.
+  const LoweredBlock *getLowered(const OpExecutor *executor,
+                                 const mlir::Block *block) const {
+    return region_->getLowered(executor, block);
+  }
+
+  // lookup or define a value by its slot in this region, see LoweredOp.
+  spu::Value lookupSlot(uint32_t slot) const;
+  void addSlot(uint32_t slot, spu::Value &&val);
+  void removeSlot(uint32_t slot);
+
   //
   bool hasValue(mlir::Value key) const;
   bool hasValues(mlir::OperandRange keys) const;
@@ -51,7 +195,8 @@ class SymbolScope final {
   void removeValue(::mlir::Value key);
 
  protected:
-  bool hasValueUnsafe(mlir::Value key) const;
+  // return nullptr if the value is not numbered in this scope.
+  Slot *findSlot(mlir::Value key) const;
 };
 
 // This class encapsulate execution states used during the evaluation.
@@ -60,6 +205,15 @@ struct ExecutionOptions {
   bool do_log_execution = false;
   bool do_parallel = false;
   uint64_t concurrency = 0;
+  // Worker pool shared by parallel blocks, not owned. When not set,
+  // runBlockParallel creates one for the block being run.
+  OpScheduler *scheduler = nullptr;
+  // When set, parallel blocks run the ops on the longest path of communication
+  // rounds first, instead of in program order. Not owned.
+  const CostModel *cost_model = nullptr;
+  // When set, the kernels of the ops about to run are announced to the
+  // protocol, see State::hint. Not owned.
+  const CostModel *hint_model = nullptr;
 };
 
 class OpExecutor {
@@ -75,6 +229,12 @@ class OpExecutor {
   // return true if the operation has a corresponding kernel.
   virtual bool hasKernel(mlir::Operation &op) const = 0;
 
+  // Resolve the kernel of `inst.op` once, and decode the attributes it needs,
+  // so lowered blocks call it directly instead of dispatching in runKernelImpl
+  // on every run. The slots of `inst` are already assigned. Leave the kernel
+  // unset to keep dispatching.
+  virtual void lowerOp(LoweredOp & /*inst*/) const {}
+
   // run a kernel in a given region.
   virtual void runKernelImpl(SPUContext *sctx, SymbolScope *sscope,
                              mlir::Operation &op,
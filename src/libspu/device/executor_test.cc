@@ -0,0 +1,152 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/executor.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "libspu/core/type.h"
+#include "libspu/device/executable_cache.h"
+
+namespace spu::device {
+
+namespace {
+
+// %0 is defined above the loop and used by both of its regions.
+constexpr char kCode[] = R"(
+func.func @main(%arg0: tensor<i32>) -> (tensor<i32>) {
+  %0 = pphlo.constant dense<3> : tensor<i32>
+  %1 = pphlo.while(%arg1 = %arg0): tensor<i32>
+  cond {
+    %2 = pphlo.less %arg1, %0 : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    pphlo.return %2 : tensor<i1>
+  } do {
+    %2 = pphlo.add %arg1, %0 : tensor<i32>
+    pphlo.return %2 : tensor<i32>
+  }
+  return %1 : tensor<i32>
+})";
+
+struct Program {
+  std::shared_ptr<const ParsedExecutable> parsed;
+  mlir::Region *entry;
+  mlir::Operation *constant;
+  mlir::Operation *loop;
+  mlir::Operation *body_add;
+};
+
+Program parseProgram() {
+  Program p;
+  p.parsed = ParsedExecutable::parse(kCode);
+  p.entry = &p.parsed->entry().getBody();
+  auto it = p.entry->front().begin();
+  p.constant = &*it++;
+  p.loop = &*it;
+  p.body_add = &p.loop->getRegion(1).front().front();
+  return p;
+}
+
+Value makeValue() {
+  return Value(NdArrayRef(makeType<RingTy>(FM32), {1}), DT_I32);
+}
+
+}  // namespace
+
+TEST(ValueNumberingTest, Captures) {
+  auto p = parseProgram();
+  ValueNumbering numbering(*p.entry);
+
+  const auto *root = numbering.getRegion(p.entry);
+  ASSERT_NE(root, nullptr);
+  // arguments first, then results in program order.
+  EXPECT_EQ(root->getSlot(p.entry->getArgument(0)), 0);
+  EXPECT_EQ(root->getSlot(p.constant->getResult(0)), 1);
+  EXPECT_EQ(root->getSlot(p.loop->getResult(0)), 2);
+  EXPECT_EQ(root->numSlots(), 3);
+  EXPECT_TRUE(root->getCaptures().empty());
+
+  const auto constant = p.constant->getResult(0);
+  for (auto &region : p.loop->getRegions()) {
+    const auto *nested = numbering.getRegion(&region);
+    ASSERT_NE(nested, nullptr);
+    EXPECT_EQ(nested->getSlot(region.getArgument(0)), 0);
+    // the constant is numbered in the loop regions, and copied by slot.
+    EXPECT_THAT(nested->getCaptures(), testing::ElementsAre(constant));
+    EXPECT_GE(nested->getSlot(constant), 0);
+    EXPECT_THAT(nested->getCaptureSlots(root), testing::ElementsAre(1));
+    EXPECT_TRUE(nested->getCaptureSlots(nested).empty());
+  }
+
+  // values of a sibling region are not visible.
+  const auto *body = numbering.getRegion(&p.loop->getRegion(1));
+  const auto cond_result = p.loop->getRegion(0).front().front().getResult(0);
+  EXPECT_EQ(body->getSlot(cond_result), -1);
+}
+
+TEST(SymbolScopeTest, CopiesCaptures) {
+  auto p = parseProgram();
+  const auto arg = p.entry->getArgument(0);
+  const auto constant = p.constant->getResult(0);
+
+  SymbolScope root(*p.entry);
+  EXPECT_TRUE(root.isRoot());
+  EXPECT_FALSE(root.hasValue(arg));
+  root.addValue(arg, makeValue());
+  const auto captured = makeValue();
+  root.addValue(constant, captured);
+  EXPECT_TRUE(root.hasValues(llvm::ArrayRef<mlir::Value>{arg, constant}));
+
+  // created per iteration, the capture is copied at entry.
+  auto &body_region = p.loop->getRegion(1);
+  SymbolScope body(body_region, &root);
+  EXPECT_FALSE(body.isRoot());
+  ASSERT_TRUE(body.hasValue(constant));
+  EXPECT_EQ(body.lookupValue(constant).data().data(), captured.data().data());
+
+  // values of the parent that are not captured are still found.
+  EXPECT_TRUE(body.hasValue(arg));
+
+  const auto sum = p.body_add->getResult(0);
+  EXPECT_FALSE(body.hasValue(sum));
+  const auto value = makeValue();
+  body.addValue(sum, value);
+  ASSERT_TRUE(body.hasValue(sum));
+  EXPECT_EQ(body.lookupValue(sum).data().data(), value.data().data());
+  // defined in the body only.
+  EXPECT_FALSE(root.hasValue(sum));
+  EXPECT_THROW(root.addValue(sum, makeValue()), RuntimeError);
+
+  body.removeValue(sum);
+  EXPECT_FALSE(body.hasValue(sum));
+  EXPECT_THROW(body.lookupValue(sum), RuntimeError);
+}
+
+TEST(SymbolScopeTest, Slots) {
+  auto p = parseProgram();
+  SymbolScope root(*p.entry);
+
+  const auto value = makeValue();
+  root.addSlot(0, Value(value));
+  EXPECT_TRUE(root.hasValue(p.entry->getArgument(0)));
+  EXPECT_EQ(root.lookupSlot(0).data().data(), value.data().data());
+  EXPECT_EQ(root.lookupValue(p.entry->getArgument(0)).data().data(),
+            value.data().data());
+
+  root.removeSlot(0);
+  EXPECT_FALSE(root.hasValue(p.entry->getArgument(0)));
+  EXPECT_THROW(root.lookupSlot(0), RuntimeError);
+}
+
+}  // namespace spu::device
@@ -14,6 +14,9 @@
 
 #include "libspu/device/io.h"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include <utility>
 
 #include "yacl/link/algorithm/allgather.h"
@@ -174,6 +177,257 @@ void IoClient::combineShares(absl::Span<Value const> values,
   decodeFromRing(encoded, dtype, fxp_bits, out);
 }
 
+namespace {
+
+// Complex, bitset and scalar (or empty) buffers are not sliced.
+bool isSlicable(PtType pt_type, const Shape &shape, bool is_bitset) {
+  return pt_type != PT_CF32 && pt_type != PT_CF64 && !is_bitset &&
+         shape.ndim() > 0 && shape[0] > 1 && shape.numel() > 0;
+}
+
+// Number of outermost rows of a slab, so that its share is about one chunk.
+int64_t slabRows(const Shape &shape, size_t elsize, size_t max_chunk_size) {
+  const size_t row_bytes = shape.numel() / shape[0] * elsize;
+  return std::clamp<int64_t>(max_chunk_size / row_bytes, 1, shape[0]);
+}
+
+// Rows [row_start, row_end) of `bv`.
+PtBufferView slabOf(const PtBufferView &bv, int64_t row_start,
+                    int64_t row_end) {
+  Shape shape = bv.shape;
+  shape[0] = row_end - row_start;
+  auto *ptr = static_cast<std::byte *>(bv.ptr) +
+              row_start * bv.strides[0] * SizeOf(bv.pt_type);
+  return PtBufferView(ptr, bv.pt_type, shape, bv.strides);
+}
+
+// Cuts a stream of bytes into chunks of `max_chunk_size` at the same offsets
+// as Value::toProto does.
+class ChunkWriter {
+  std::vector<pb::ValueChunkProto> *chunks_;
+  const size_t total_bytes_;
+  const size_t max_chunk_size_;
+  std::string pending_;
+  size_t offset_ = 0;
+
+  void emit(const uint8_t *data, size_t size) {
+    pb::ValueChunkProto chunk;
+    chunk.set_total_bytes(total_bytes_);
+    chunk.set_chunk_offset(offset_);
+    chunk.set_content(data, size);
+    chunks_->emplace_back(std::move(chunk));
+    offset_ += size;
+  }
+
+ public:
+  ChunkWriter(std::vector<pb::ValueChunkProto> *chunks, size_t total_bytes,
+              size_t max_chunk_size)
+      : chunks_(chunks),
+        total_bytes_(total_bytes),
+        max_chunk_size_(max_chunk_size) {
+    chunks_->reserve((total_bytes + max_chunk_size - 1) / max_chunk_size);
+  }
+
+  void append(const uint8_t *data, size_t size) {
+    if (!pending_.empty()) {
+      const size_t n = std::min(size, max_chunk_size_ - pending_.size());
+      pending_.append(reinterpret_cast<const char *>(data), n);
+      data += n;
+      size -= n;
+      if (pending_.size() < max_chunk_size_) {
+        return;
+      }
+      emit(reinterpret_cast<const uint8_t *>(pending_.data()),
+           pending_.size());
+      pending_.clear();
+    }
+    for (; size >= max_chunk_size_; size -= max_chunk_size_) {
+      emit(data, max_chunk_size_);
+      data += max_chunk_size_;
+    }
+    pending_.assign(reinterpret_cast<const char *>(data), size);
+  }
+
+  void finish() {
+    if (!pending_.empty()) {
+      emit(reinterpret_cast<const uint8_t *>(pending_.data()),
+           pending_.size());
+      pending_.clear();
+    }
+    SPU_ENFORCE(offset_ == total_bytes_, "expect {} bytes, got {}",
+                total_bytes_, offset_);
+  }
+};
+
+// Reads the chunks of a ValueProto as one stream of bytes.
+class ChunkReader {
+  std::vector<const pb::ValueChunkProto *> chunks_;
+  size_t chunk_idx_ = 0;
+  size_t chunk_pos_ = 0;
+
+ public:
+  explicit ChunkReader(const ValueProto &value, size_t total_bytes) {
+    chunks_.reserve(value.chunks.size());
+    for (const auto &c : value.chunks) {
+      chunks_.push_back(&c);
+    }
+    std::sort(chunks_.begin(), chunks_.end(), [](const auto *a, const auto *b) {
+      return a->chunk_offset() < b->chunk_offset();
+    });
+    size_t chunk_end_pos = 0;
+    for (const auto *c : chunks_) {
+      SPU_ENFORCE(c->chunk_offset() == chunk_end_pos,
+                  "offset {} is not match to last chunk's end pos",
+                  c->chunk_offset());
+      SPU_ENFORCE(c->total_bytes() == total_bytes);
+      chunk_end_pos += c->content().size();
+    }
+    SPU_ENFORCE(chunk_end_pos == total_bytes, "expect {} bytes, got {}",
+                total_bytes, chunk_end_pos);
+  }
+
+  void read(uint8_t *dst, size_t size) {
+    while (size > 0) {
+      SPU_ENFORCE(chunk_idx_ < chunks_.size());
+      const auto &content = chunks_[chunk_idx_]->content();
+      const size_t n = std::min(size, content.size() - chunk_pos_);
+      std::memcpy(dst, content.data() + chunk_pos_, n);
+      dst += n;
+      size -= n;
+      chunk_pos_ += n;
+      if (chunk_pos_ == content.size()) {
+        ++chunk_idx_;
+        chunk_pos_ = 0;
+      }
+    }
+  }
+};
+
+}  // namespace
+
+std::vector<ValueProto> IoClient::makeShareProtos(const PtBufferView &bv,
+                                                  Visibility vtype,
+                                                  int owner_rank,
+                                                  size_t max_chunk_size) {
+  SPU_ENFORCE(max_chunk_size > 0);
+
+  const bool bit_secret = bv.pt_type == PT_I1 && vtype == VIS_SECRET &&
+                          base_io_->hasBitSecretSupport();
+  if (bit_secret || !isSlicable(bv.pt_type, bv.shape, bv.is_bitset)) {
+    auto shares = makeShares(bv, vtype, owner_rank);
+    std::vector<ValueProto> result;
+    result.reserve(shares.size());
+    for (const auto &share : shares) {
+      result.emplace_back(share.toProto(max_chunk_size));
+    }
+    return result;
+  }
+
+  if (!config_.experimental_enable_colocated_optimization) {
+    owner_rank = -1;
+  }
+  const size_t total_bytes = getShareSize(bv, vtype, owner_rank);
+  const size_t elsize = total_bytes / bv.shape.numel();
+  const int64_t rows = bv.shape[0];
+  const int64_t rows_per_slab = slabRows(bv.shape, elsize, max_chunk_size);
+
+  std::vector<ValueProto> result(world_size_);
+  std::vector<ChunkWriter> writers;
+  writers.reserve(world_size_);
+  for (auto &proto : result) {
+    writers.emplace_back(&proto.chunks, total_bytes, max_chunk_size);
+  }
+
+  for (int64_t row = 0; row < rows; row += rows_per_slab) {
+    const int64_t row_end = std::min(row + rows_per_slab, rows);
+    auto shares = makeShares(slabOf(bv, row, row_end), vtype, owner_rank);
+    SPU_ENFORCE(shares.size() == world_size_);
+
+    for (size_t idx = 0; idx < world_size_; ++idx) {
+      auto share = shares[idx].data();
+      if (!share.isCompact()) {
+        share = share.clone();
+      }
+      SPU_ENFORCE(static_cast<size_t>(share.elsize()) == elsize,
+                  "share size mismatch, expect={}, got={}", elsize,
+                  share.elsize());
+      writers[idx].append(share.data<uint8_t>(), share.numel() * elsize);
+
+      if (row == 0) {
+        result[idx].meta = shares[idx].toMetaProto();
+        result[idx].meta.mutable_shape()->clear_dims();
+        for (const auto &d : bv.shape) {
+          result[idx].meta.mutable_shape()->add_dims(d);
+        }
+      }
+    }
+  }
+
+  for (auto &writer : writers) {
+    writer.finish();
+  }
+  return result;
+}
+
+void IoClient::combineShareProtos(absl::Span<ValueProto const> values,
+                                  PtBufferView *out) {
+  SPU_ENFORCE(values.size() == world_size_,
+              "wrong number of shares, got={}, expect={}", values.size(),
+              world_size_);
+
+  const auto &meta = values.front().meta;
+  const Shape shape(meta.shape().dims().begin(), meta.shape().dims().end());
+  if (meta.is_complex() ||
+      !isSlicable(out->pt_type, out->shape, out->is_bitset)) {
+    std::vector<Value> shares;
+    shares.reserve(values.size());
+    for (const auto &val : values) {
+      shares.emplace_back(Value::fromProto(val));
+    }
+    combineShares(shares, out);
+    return;
+  }
+
+  SPU_ENFORCE(shape == out->shape, "shape mismatch, share={}, out={}", shape,
+              out->shape);
+
+  const size_t fxp_bits = config_.fxp_fraction_bits;
+  SPU_ENFORCE(fxp_bits != 0, "fxp should never be zero, please check default");
+
+  const auto dtype = static_cast<DataType>(meta.data_type());
+  std::vector<Type> eltypes;
+  std::vector<ChunkReader> readers;
+  eltypes.reserve(world_size_);
+  readers.reserve(world_size_);
+  for (const auto &val : values) {
+    SPU_ENFORCE(val.meta.data_type() == meta.data_type(),
+                "data type mismatch");
+    eltypes.push_back(Type::fromString(val.meta.storage_type()));
+    readers.emplace_back(val, shape.numel() * eltypes.back().size());
+  }
+
+  const int64_t rows = shape[0];
+  const size_t slab_bytes = config_.share_max_chunk_size > 0
+                                ? config_.share_max_chunk_size
+                                : RuntimeConfig::kDefaultShareMaxChunkSize;
+  const int64_t rows_per_slab =
+      slabRows(shape, eltypes.front().size(), slab_bytes);
+  for (int64_t row = 0; row < rows; row += rows_per_slab) {
+    const int64_t row_end = std::min(row + rows_per_slab, rows);
+    auto slab = slabOf(*out, row, row_end);
+
+    std::vector<NdArrayRef> shares;
+    shares.reserve(world_size_);
+    for (size_t idx = 0; idx < world_size_; ++idx) {
+      NdArrayRef share(eltypes[idx], slab.shape);
+      readers[idx].read(share.data<uint8_t>(), share.buf()->size());
+      shares.push_back(std::move(share));
+    }
+
+    decodeFromRing(base_io_->fromShares(shares), dtype, fxp_bits, &slab);
+  }
+}
+
 ColocatedIo::ColocatedIo(SPUContext *sctx) : sctx_(sctx) {}
 
 void ColocatedIo::hostSetVar(const std::string &name, const PtBufferView &bv,
@@ -224,8 +478,11 @@ bool ColocatedIo::deviceHasVar(const std::string &name) const {
 //   Carol: {x2, y2, z2}
 
 using SymbolTableProto = std::unordered_map<std::string, ValueProto>;
+using SymbolTableValues = std::unordered_map<std::string, Value>;
 
-static std::vector<SymbolTableProto> all2all(
+// The chunk contents are sent as raw bytes, so the receiver can adopt them as
+// the storage of the value without parsing or copying.
+static std::vector<SymbolTableValues> all2all(
     const std::shared_ptr<yacl::link::Context> &lctx,
     const std::vector<SymbolTableProto> &rows) {
   std::vector<size_t> party_var_count;
@@ -253,42 +510,60 @@ static std::vector<SymbolTableProto> all2all(
       lctx->SendAsync(idx, std::to_string(value.chunks.size()),
                       "all2all_var_chunks_count");
       for (const auto &s : value.chunks) {
-        // send chunks
-        lctx->SendAsync(idx, s.SerializeAsString(), "all2all_var_chunk");
+        // send chunks, they are ordered by offset.
+        lctx->SendAsync(idx, s.content(), "all2all_var_chunk");
       }
     }
   }
 
-  std::vector<SymbolTableProto> cols;
+  std::vector<SymbolTableValues> cols;
   for (size_t idx = 0; idx < lctx->WorldSize(); idx++) {
     if (idx == lctx->Rank()) {
-      cols.push_back(rows[idx]);
+      SymbolTableValues st;
+      for (const auto &[key, value] : rows[idx]) {
+        st.insert({key, Value::fromProto(value)});
+      }
+      cols.push_back(std::move(st));
       continue;
     }
-    SymbolTableProto st_proto;
+    SymbolTableValues st;
     for (size_t msg_idx = 0; msg_idx < party_var_count[idx]; msg_idx++) {
       auto key = lctx->Recv(idx, "all2all_var_key");
-      ValueProto proto;
+      pb::ValueMetaProto meta;
       {
         auto data = lctx->Recv(idx, "all2all_var_meta");
-        SPU_ENFORCE(proto.meta.ParseFromArray(data.data(), data.size()));
+        SPU_ENFORCE(meta.ParseFromArray(data.data(), data.size()));
       }
       size_t chunk_count = 0;
       {
         auto data = lctx->Recv(idx, "all2all_var_chunks_count");
         SPU_ENFORCE(absl::SimpleAtoi(data, &chunk_count));
       }
-      proto.chunks.resize(chunk_count);
-      for (size_t s_idx = 0; s_idx < chunk_count; s_idx++) {
-        auto data = lctx->Recv(idx, "all2all_var_chunk");
-        SPU_ENFORCE(
-            proto.chunks[s_idx].ParseFromArray(data.data(), data.size()));
+      std::shared_ptr<yacl::Buffer> buf;
+      if (chunk_count == 1) {
+        // adopt the received buffer directly.
+        buf = std::make_shared<yacl::Buffer>(
+            lctx->Recv(idx, "all2all_var_chunk"));
+      } else {
+        std::vector<yacl::Buffer> chunks(chunk_count);
+        int64_t total_bytes = 0;
+        for (size_t s_idx = 0; s_idx < chunk_count; s_idx++) {
+          chunks[s_idx] = lctx->Recv(idx, "all2all_var_chunk");
+          total_bytes += chunks[s_idx].size();
+        }
+        buf = std::make_shared<yacl::Buffer>(total_bytes);
+        int64_t offset = 0;
+        for (const auto &chunk : chunks) {
+          std::memcpy(buf->data<std::byte>() + offset, chunk.data(),
+                      chunk.size());
+          offset += chunk.size();
+        }
       }
-      st_proto.insert(
+      st.insert(
           {std::string(static_cast<const char *>(key.data()), key.size()),
-           std::move(proto)});
+           Value::fromBuffer(meta, std::move(buf))});
     }
-    cols.push_back(std::move(st_proto));
+    cols.push_back(std::move(st));
   }
 
   return cols;
@@ -326,16 +601,16 @@ void ColocatedIo::sync() {
     PtBufferView bv(arr.data(), arr.eltype().as<PtTy>()->pt_type(), arr.shape(),
                     arr.strides());
 
-    auto shares = io.makeShares(bv, priv.vtype, priv.owner_rank);
+    auto shares = io.makeShareProtos(bv, priv.vtype, priv.owner_rank,
+                                     128UL * 1024 * 1024);
     SPU_ENFORCE(shares.size() == lctx->WorldSize());
 
     for (size_t idx = 0; idx < shares.size(); idx++) {
-      shares_per_party[idx].insert(
-          {name, shares[idx].toProto(128UL * 1024 * 1024)});
+      shares_per_party[idx].insert({name, std::move(shares[idx])});
     }
   }
 
-  std::vector<SymbolTableProto> values_per_party =
+  std::vector<SymbolTableValues> values_per_party =
       all2all(lctx, shares_per_party);
 
   std::set<std::string> all_names;
@@ -348,8 +623,8 @@ void ColocatedIo::sync() {
   }
 
   for (const auto &values : values_per_party) {
-    for (const auto &[name, proto] : values) {
-      symbols_.setVar(name, spu::Value::fromProto(proto));
+    for (const auto &[name, value] : values) {
+      symbols_.setVar(name, value);
     }
   }
 
@@ -115,6 +115,22 @@ class IoClient {
   // Combine shares to a plaintext buffer.
   void combineShares(absl::Span<spu::Value const> values, PtBufferView *out);
 
+  // Make shares and serialize them into chunks of at most `max_chunk_size`
+  // bytes, the result is the same as calling toProto on each share of
+  // makeShares.
+  //
+  // The input is encoded and split slab by slab (along the outermost axis),
+  // each slab is appended to the chunks right away, so beside the result only
+  // a few chunks of temporaries are alive at a time.
+  std::vector<ValueProto> makeShareProtos(const PtBufferView &bv,
+                                          Visibility vtype, int owner_rank,
+                                          size_t max_chunk_size);
+
+  // The reverse of makeShareProtos, reconstructs serialized shares slab by
+  // slab into `out`.
+  void combineShareProtos(absl::Span<ValueProto const> values,
+                          PtBufferView *out);
+
   PtType getPtType(absl::Span<spu::Value const> values);
 };
 
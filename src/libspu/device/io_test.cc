@@ -69,6 +69,43 @@ TEST_P(IoClientTest, Int) {
   EXPECT_EQ(in_data, out_data);
 }
 
+TEST_P(IoClientTest, Chunked) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+  const Visibility kVisibility = std::get<3>(GetParam());
+
+  RuntimeConfig hconf;
+  hconf.protocol = std::get<1>(GetParam());
+  hconf.field = std::get<2>(GetParam());
+  // a few rows per slab
+  hconf.share_max_chunk_size = 100;
+  IoClient io(kWorldSize, hconf);
+
+  xt::xarray<float> in_data = xt::arange<float>(-60, 60);
+  in_data.reshape({20, 2, 3});
+  // 7 bytes per chunk, chunks cross elements and slabs.
+  auto protos = io.makeShareProtos(in_data, kVisibility, -1, 7);
+  EXPECT_EQ(protos.size(), kWorldSize);
+
+  std::vector<Value> shares;
+  for (const auto &proto : protos) {
+    EXPECT_EQ(proto.chunks.size(),
+              (io.getShareSize(in_data, kVisibility) + 6) / 7);
+    shares.push_back(Value::fromProto(proto));
+    EXPECT_EQ(shares.back().shape(), Shape({20, 2, 3}));
+  }
+
+  xt::xarray<float> out_data(in_data.shape());
+  PtBufferView out_pv(out_data);
+  io.combineShares(shares, &out_pv);
+  EXPECT_EQ(in_data, out_data);
+
+  // non compact output
+  xt::xarray<float, xt::layout_type::column_major> out_cm(in_data.shape());
+  PtBufferView out_cm_pv(out_cm);
+  io.combineShareProtos(protos, &out_cm_pv);
+  EXPECT_EQ(in_data, out_cm);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     IoClientTestInstance, IoClientTest,
     testing::Combine(
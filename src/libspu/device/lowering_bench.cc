@@ -0,0 +1,99 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+
+#include "libspu/device/api.h"
+#include "libspu/device/executor.h"
+#include "libspu/device/pphlo/pphlo_executor.h"
+#include "libspu/kernel/test_util.h"
+
+namespace spu::device {
+
+namespace {
+
+// A loop over small public tensors, so running the body is dominated by the
+// executor rather than by the kernels.
+constexpr char kCode[] = R"(
+func.func @main(%arg0: tensor<2x2xi32>, %arg1: tensor<i32>) -> (tensor<2x2xi32>) {
+  %0 = pphlo.constant dense<1> : tensor<i32>
+  %1 = pphlo.constant dense<0> : tensor<i32>
+  %2:2 = pphlo.while(%arg2 = %1, %arg3 = %arg0): tensor<i32>, tensor<2x2xi32>
+  cond {
+    %3 = pphlo.less %arg2, %arg1 : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    pphlo.return %3 : tensor<i1>
+  } do {
+    %3 = pphlo.add %arg2, %0 : tensor<i32>
+    %4 = pphlo.transpose %arg3, dims = [1, 0] : (tensor<2x2xi32>) -> tensor<2x2xi32>
+    %5 = pphlo.slice %4 [0:1:1, 0:1:2] : (tensor<2x2xi32>) -> tensor<1x2xi32>
+    %6 = pphlo.reshape %5 : (tensor<1x2xi32>) -> tensor<2xi32>
+    %7 = pphlo.broadcast %6, dims = [1] : (tensor<2xi32>) -> tensor<2x2xi32>
+    %8 = pphlo.maximum %4, %7 : tensor<2x2xi32>
+    %9 = pphlo.subtract %8, %arg3 : tensor<2x2xi32>
+    %10 = pphlo.less %9, %7 : (tensor<2x2xi32>, tensor<2x2xi32>) -> tensor<2x2xi1>
+    %11 = pphlo.select %10, %9, %arg3 : (tensor<2x2xi1>, tensor<2x2xi32>, tensor<2x2xi32>) -> tensor<2x2xi32>
+    %12 = pphlo.negate %11 : tensor<2x2xi32>
+    %13 = pphlo.add %12, %8 : tensor<2x2xi32>
+    pphlo.return %3, %13 : tensor<i32>, tensor<2x2xi32>
+  }
+  return %2#1 : tensor<2x2xi32>
+})";
+
+// Keeps every op dispatched by runKernel, with values looked up by mlir value,
+// as before blocks were lowered.
+class DispatchingExecutor final : public pphlo::PPHloExecutor {
+ public:
+  void lowerOp(LoweredOp & /*inst*/) const override {}
+};
+
+void runLoop(benchmark::State &state, pphlo::PPHloExecutor *executor) {
+  RuntimeConfig config;
+  config.protocol = ProtocolKind::REF2K;
+  config.field = FieldType::FM64;
+  // parse once, so the runs measure the loop.
+  config.experimental_enable_executable_cache = true;
+  SPUContext sctx = kernel::test::makeSPUContext(config, nullptr);
+
+  xt::xarray<int32_t> x = {{1, 2}, {3, 4}};
+  const auto n = static_cast<int32_t>(state.range(0));
+
+  SymbolTable env;
+  env.setVar("x", kernel::test::makeValue(&sctx, x, VIS_PUBLIC));
+  env.setVar("n", kernel::test::makeValue(&sctx, n, VIS_PUBLIC));
+  ExecutableProto executable("bench", {"x", "n"}, {"y"}, kCode);
+
+  for (auto _ : state) {
+    execute(executor, &sctx, executable, &env);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// Lowered blocks: kernels resolved, values accessed by slot.
+void BMLoopLowered(benchmark::State &state) {
+  pphlo::PPHloExecutor executor;
+  runLoop(state, &executor);
+}
+BENCHMARK(BMLoopLowered)->Arg(10)->Arg(100)->Arg(1000);
+
+// Every op dispatched and every value hashed on each iteration.
+void BMLoopDispatched(benchmark::State &state) {
+  DispatchingExecutor executor;
+  runLoop(state, &executor);
+}
+BENCHMARK(BMLoopDispatched)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace spu::device
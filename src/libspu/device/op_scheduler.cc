@@ -0,0 +1,153 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/op_scheduler.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::device {
+namespace {
+
+// The pool and the worker index the current thread belongs to.
+thread_local const OpScheduler *tls_scheduler = nullptr;
+thread_local size_t tls_worker_index = 0;
+
+}  // namespace
+
+OpScheduler::OpScheduler(size_t concurrency, bool enable_stats)
+    : enable_stats_(enable_stats) {
+  SPU_ENFORCE(concurrency > 0, "inter op concurrency should be positive");
+  const size_t num_workers = concurrency - 1;
+
+  workers_.reserve(num_workers);
+  for (size_t idx = 0; idx < num_workers; ++idx) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  // Start threads after all deques exist, since workers steal from each other.
+  for (size_t idx = 0; idx < num_workers; ++idx) {
+    workers_[idx]->thread = std::thread(&OpScheduler::workerLoop, this, idx);
+  }
+}
+
+OpScheduler::~OpScheduler() {
+  {
+    std::unique_lock lk(mu_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void OpScheduler::submit(Task task) {
+  if (tls_scheduler == this) {
+    auto &worker = *workers_[tls_worker_index];
+    std::unique_lock lk(worker.mu);
+    worker.tasks.emplace_back(std::move(task));
+  } else {
+    std::unique_lock lk(mu_);
+    injected_.emplace_back(std::move(task));
+  }
+
+  {
+    // Publish under the lock so a worker cannot miss the wakeup between its
+    // predicate check and going to sleep.
+    std::unique_lock lk(mu_);
+    num_pending_++;
+  }
+  cv_.notify_one();
+}
+
+bool OpScheduler::popLocal(size_t index, Task &task) {
+  auto &worker = *workers_[index];
+  std::unique_lock lk(worker.mu);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  num_pending_--;
+  return true;
+}
+
+bool OpScheduler::popInjected(Task &task) {
+  std::unique_lock lk(mu_);
+  if (injected_.empty()) {
+    return false;
+  }
+  task = std::move(injected_.front());
+  injected_.pop_front();
+  num_pending_--;
+  return true;
+}
+
+bool OpScheduler::steal(size_t index, Task &task) {
+  const size_t num_workers = workers_.size();
+  for (size_t offset = 1; offset < num_workers; ++offset) {
+    auto &victim = *workers_[(index + offset) % num_workers];
+    std::unique_lock lk(victim.mu);
+    if (victim.tasks.empty()) {
+      continue;
+    }
+    task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    num_pending_--;
+    num_steals_++;
+    return true;
+  }
+  return false;
+}
+
+void OpScheduler::workerLoop(size_t index) {
+  tls_scheduler = this;
+  tls_worker_index = index;
+
+  while (true) {
+    Task task;
+    if (popLocal(index, task) || popInjected(task) || steal(index, task)) {
+      task();
+      continue;
+    }
+
+    std::unique_lock lk(mu_);
+    cv_.wait(lk, [this] { return stopped_ || num_pending_.load() > 0; });
+    if (stopped_ && num_pending_.load() <= 0) {
+      return;
+    }
+  }
+}
+
+void OpScheduler::recordOp(const std::string &name, Duration wait,
+                           Duration queue, Duration exec) {
+  if (!enable_stats_) {
+    return;
+  }
+  std::unique_lock lk(stats_mu_);
+  auto &stat = stats_[name];
+  stat.count++;
+  stat.wait_time += wait;
+  stat.queue_time += queue;
+  stat.exec_time += exec;
+}
+
+std::map<std::string, OpScheduleStats> OpScheduler::getStats() const {
+  std::unique_lock lk(stats_mu_);
+  return stats_;
+}
+
+}  // namespace spu::device
@@ -0,0 +1,110 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libspu/core/trace.h"
+
+namespace spu::device {
+
+// Timing of ops executed by the inter-op scheduler, aggregated per op name.
+struct OpScheduleStats {
+  // number of ops executed.
+  size_t count = 0;
+  // time from block start until all operands are ready.
+  Duration wait_time = {};
+  // time from ready until a thread picks the op up.
+  Duration queue_time = {};
+  // time spent in the kernel.
+  Duration exec_time = {};
+};
+
+// A persistent work-stealing thread pool used by inter-op parallel execution.
+//
+// Each worker owns a local deque, tasks submitted from a worker thread are
+// pushed to its own deque (LIFO, so successors of an op run on the thread that
+// produced their operands), tasks submitted from other threads go to a shared
+// injection queue. Idle workers steal from the front of other deques.
+//
+// The pool is created once per execution and shared by every (nested) block
+// run in parallel, so threads are not re-spawned per block.
+class OpScheduler final {
+ public:
+  using Task = std::function<void()>;
+
+  // `concurrency` is the total number of threads executing ops, including the
+  // thread driving the block, so the pool spawns `concurrency - 1` workers.
+  explicit OpScheduler(size_t concurrency, bool enable_stats = false);
+  ~OpScheduler();
+
+  OpScheduler(const OpScheduler &) = delete;
+  OpScheduler &operator=(const OpScheduler &) = delete;
+
+  size_t numWorkers() const { return workers_.size(); }
+
+  // Enqueue a task, never blocks.
+  void submit(Task task);
+
+  bool isStatsEnabled() const { return enable_stats_; }
+
+  void recordOp(const std::string &name, Duration wait, Duration queue,
+                Duration exec);
+
+  std::map<std::string, OpScheduleStats> getStats() const;
+
+  // number of tasks taken from another worker's deque.
+  size_t numSteals() const { return num_steals_.load(); }
+
+ private:
+  struct Worker {
+    std::mutex mu;
+    std::deque<Task> tasks;
+    std::thread thread;
+  };
+
+  void workerLoop(size_t index);
+
+  bool popLocal(size_t index, Task &task);
+  bool popInjected(Task &task);
+  bool steal(size_t index, Task &task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // shared queue for tasks submitted outside the pool.
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Task> injected_;
+  bool stopped_ = false;
+
+  // number of tasks submitted but not picked up yet.
+  std::atomic<int64_t> num_pending_{0};
+  std::atomic<size_t> num_steals_{0};
+
+  const bool enable_stats_;
+  mutable std::mutex stats_mu_;
+  std::map<std::string, OpScheduleStats> stats_;
+};
+
+}  // namespace spu::device
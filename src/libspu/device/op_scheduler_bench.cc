@@ -0,0 +1,107 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+
+#include "libspu/device/api.h"
+#include "libspu/device/pphlo/pphlo_executor.h"
+#include "libspu/kernel/test_util.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::device {
+
+namespace {
+
+constexpr int64_t kNumHeads = 8;
+constexpr int64_t kDim = 32;
+
+// A wide attention-like block: every head projects the input, then runs a
+// chain of secret multiplications (and a comparison) whose length grows with
+// the head index, so the heads written last are the most critical ones.
+std::string makeWideBlock() {
+  const auto type = fmt::format("tensor<{0}x{0}x!pphlo.secret<f32>>", kDim);
+  std::string body;
+  std::string sum;
+  for (int64_t head = 0; head < kNumHeads; ++head) {
+    body += fmt::format(
+        "  %q{0} = pphlo.dot %arg0, %arg1 : ({1}, {1}) -> {1}\n"
+        "  %c{0}_0 = pphlo.maximum %q{0}, %arg0 : {1}\n",
+        head, type);
+    for (int64_t step = 1; step <= head + 1; ++step) {
+      body += fmt::format(
+          "  %c{0}_{1} = pphlo.multiply %c{0}_{2}, %q{0} : {3}\n", head, step,
+          step - 1, type);
+    }
+    const auto out = fmt::format("%c{}_{}", head, head + 1);
+    if (sum.empty()) {
+      sum = out;
+    } else {
+      body += fmt::format("  %s{0} = pphlo.add {1}, {2} : {3}\n", head, sum,
+                          out, type);
+      sum = fmt::format("%s{}", head);
+    }
+  }
+  return fmt::format(
+      "func.func @main(%arg0: {0}, %arg1: {0}) -> ({0}) {{\n{1}  return {2} : "
+      "{0}\n}}",
+      type, body, sum);
+}
+
+void runWideBlock(benchmark::State &state, bool critical_path) {
+  const auto code = makeWideBlock();
+  ExecutableProto executable("bench", {"x", "w"}, {"y"}, code);
+
+  for (auto _ : state) {
+    mpc::utils::simulate(
+        2, [&](const std::shared_ptr<yacl::link::Context> &lctx) {
+          RuntimeConfig config;
+          config.protocol = ProtocolKind::SEMI2K;
+          config.field = FieldType::FM64;
+          config.experimental_enable_inter_op_par = true;
+          config.experimental_inter_op_concurrency = state.range(0);
+          config.experimental_enable_critical_path_scheduling = critical_path;
+          SPUContext sctx = kernel::test::makeSPUContext(config, lctx);
+
+          xt::xarray<float> input =
+              xt::ones<float>({kDim, kDim}) / static_cast<float>(kDim);
+          SymbolTable env;
+          env.setVar("x", kernel::test::makeValue(&sctx, input, VIS_SECRET));
+          env.setVar("w", kernel::test::makeValue(&sctx, input, VIS_SECRET));
+
+          pphlo::PPHloExecutor executor;
+          execute(&executor, &sctx, executable, &env);
+        });
+  }
+}
+
+}  // namespace
+
+// Ready ops run in program order.
+void BMWideBlockProgramOrder(benchmark::State &state) {
+  runWideBlock(state, false);
+}
+BENCHMARK(BMWideBlockProgramOrder)->Arg(2)->Arg(4)->Arg(8);
+
+// Ready ops run by longest remaining path of rounds.
+void BMWideBlockCriticalPath(benchmark::State &state) {
+  runWideBlock(state, true);
+}
+BENCHMARK(BMWideBlockCriticalPath)->Arg(2)->Arg(4)->Arg(8);
+
+}  // namespace spu::device
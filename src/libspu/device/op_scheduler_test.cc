@@ -0,0 +1,94 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/device/op_scheduler.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+
+namespace spu::device {
+
+namespace {
+
+void waitFor(std::mutex &mu, std::condition_variable &cv,
+             const std::atomic<int64_t> &counter, int64_t expected) {
+  std::unique_lock lk(mu);
+  cv.wait(lk, [&] { return counter.load() == expected; });
+}
+
+}  // namespace
+
+TEST(OpSchedulerTest, Submit) {
+  OpScheduler scheduler(4);
+  EXPECT_EQ(scheduler.numWorkers(), 3);
+
+  constexpr int64_t kNumTasks = 1000;
+  std::mutex mu;
+  std::condition_variable cv;
+  std::atomic<int64_t> counter{0};
+
+  for (int64_t idx = 0; idx < kNumTasks; ++idx) {
+    scheduler.submit([&] {
+      std::unique_lock lk(mu);
+      counter++;
+      cv.notify_all();
+    });
+  }
+
+  waitFor(mu, cv, counter, kNumTasks);
+  EXPECT_EQ(counter.load(), kNumTasks);
+}
+
+TEST(OpSchedulerTest, SubmitFromWorker) {
+  OpScheduler scheduler(3);
+
+  // Each task fans out into two until the depth is reached, which exercises
+  // local deques and stealing.
+  constexpr int64_t kDepth = 10;
+  std::mutex mu;
+  std::condition_variable cv;
+  std::atomic<int64_t> counter{0};
+
+  std::function<void(int64_t)> spawn = [&](int64_t depth) {
+    if (depth < kDepth) {
+      scheduler.submit([&, depth] { spawn(depth + 1); });
+      scheduler.submit([&, depth] { spawn(depth + 1); });
+    }
+    std::unique_lock lk(mu);
+    counter++;
+    cv.notify_all();
+  };
+  scheduler.submit([&] { spawn(0); });
+
+  waitFor(mu, cv, counter, (int64_t{1} << (kDepth + 1)) - 1);
+  EXPECT_EQ(counter.load(), (int64_t{1} << (kDepth + 1)) - 1);
+}
+
+TEST(OpSchedulerTest, Stats) {
+  OpScheduler scheduler(2, /*enable_stats*/ true);
+
+  scheduler.recordOp("pphlo.add", Duration(10), Duration(20), Duration(30));
+  scheduler.recordOp("pphlo.add", Duration(1), Duration(2), Duration(3));
+
+  const auto stats = scheduler.getStats();
+  ASSERT_EQ(stats.size(), 1);
+  const auto &stat = stats.at("pphlo.add");
+  EXPECT_EQ(stat.count, 2);
+  EXPECT_EQ(stat.wait_time, Duration(11));
+  EXPECT_EQ(stat.queue_time, Duration(22));
+  EXPECT_EQ(stat.exec_time, Duration(33));
+}
+
+}  // namespace spu::device
@@ -14,6 +14,10 @@
 
 #include "libspu/device/pphlo/pphlo_executor.h"
 
+#include <memory>
+#include <optional>
+#include <tuple>
+
 #include "mlir/IR/BuiltinAttributes.h"
 
 #include "libspu/core/encoding.h"
@@ -234,6 +238,36 @@ void removeValue(SymbolScope *scope, mlir::Value key,
   scope->removeValue(key);
 }
 
+spu::Value lookupOperand(SymbolScope *scope, const LoweredOp &inst, size_t idx,
+                         const ExecutionOptions &opts) {
+  auto val = scope->lookupSlot(inst.operands[idx]);
+  do_type_checker(inst.op->getOperand(idx), val, opts);
+  return val;
+}
+
+void addResult(SymbolScope *scope, const LoweredOp &inst, size_t idx,
+               spu::Value &&val, const ExecutionOptions &opts) {
+  do_type_checker(inst.op->getResult(idx), val, opts);
+  scope->addSlot(inst.results[idx], std::move(val));
+}
+
+// Kernel of an op in a lowered block, where operands and results are accessed
+// by slot and attributes are decoded once by `lower`. Ops without a
+// specialization run their execute function.
+//
+// A specialization defines:
+//   static std::shared_ptr<const LoweredAttrs> lower(OpT op);
+//   static void run(SPUContext *sctx, SymbolScope *sscope,
+//                   const LoweredOp &inst, const ExecutionOptions &opts);
+template <typename OpT>
+struct LoweredKernel {
+  static constexpr bool kEnabled = false;
+};
+
+struct ShapeAttrs : LoweredAttrs {
+  Shape shape;
+};
+
 //
 #define STANDARD_UNARY_OP_EXEC_IMPL(OpName, KernelName)                      \
   void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,          \
@@ -241,7 +275,23 @@ void removeValue(SymbolScope *scope, mlir::Value key,
     const auto in = lookupValue(sscope, op.getOperand(), opts);              \
     auto ret = kernel::hlo::KernelName(sctx, in);                            \
     addValue(sscope, op.getResult(), std::move(ret), opts);                  \
-  }
+  }                                                                          \
+                                                                             \
+  template <>                                                                \
+  struct LoweredKernel<mlir::spu::pphlo::OpName> {                           \
+    static constexpr bool kEnabled = true;                                   \
+    static std::shared_ptr<const LoweredAttrs> lower(                        \
+        mlir::spu::pphlo::OpName) {                                          \
+      return nullptr;                                                        \
+    }                                                                        \
+    static void run(SPUContext *sctx, SymbolScope *sscope,                   \
+                    const LoweredOp &inst, const ExecutionOptions &opts) {   \
+      addResult(sscope, inst, 0,                                             \
+                kernel::hlo::KernelName(                                     \
+                    sctx, lookupOperand(sscope, inst, 0, opts)),             \
+                opts);                                                       \
+    }                                                                        \
+  };
 
 STANDARD_UNARY_OP_EXEC_IMPL(ReciprocalOp, Reciprocal)
 STANDARD_UNARY_OP_EXEC_IMPL(NegOp, Neg)
@@ -272,7 +322,24 @@ STANDARD_UNARY_OP_EXEC_IMPL(CosineOp, Cosine)
         kernel::hlo::KernelName(sctx, lookupValue(sscope, op.getLhs(), opts), \
                                 lookupValue(sscope, op.getRhs(), opts)),      \
         opts);                                                                \
-  }
+  }                                                                           \
+                                                                              \
+  template <>                                                                 \
+  struct LoweredKernel<mlir::spu::pphlo::OpName> {                            \
+    static constexpr bool kEnabled = true;                                    \
+    static std::shared_ptr<const LoweredAttrs> lower(                         \
+        mlir::spu::pphlo::OpName) {                                           \
+      return nullptr;                                                         \
+    }                                                                         \
+    static void run(SPUContext *sctx, SymbolScope *sscope,                    \
+                    const LoweredOp &inst, const ExecutionOptions &opts) {    \
+      addResult(sscope, inst, 0,                                              \
+                kernel::hlo::KernelName(                                      \
+                    sctx, lookupOperand(sscope, inst, 0, opts),               \
+                    lookupOperand(sscope, inst, 1, opts)),                    \
+                opts);                                                        \
+    }                                                                         \
+  };
 
 STANDARD_BINARY_OP_EXEC_IMPL(AddOp, Add)
 STANDARD_BINARY_OP_EXEC_IMPL(Atan2Op, Atan2)
@@ -296,52 +363,76 @@ STANDARD_BINARY_OP_EXEC_IMPL(ShiftRightLogicalOp, Rshift)
 
 #undef STANDARD_BINARY_OP_EXEC_IMPL
 
-void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
-             mlir::spu::pphlo::MulOp &op, const ExecutionOptions &opts) {
-  auto smallConst = op.getRhs().getDefiningOp<mlir::spu::pphlo::ConstantOp>();
-  auto multiplier = op.getLhs();
-  if (!smallConst) {
-    // Try lhs
-    smallConst = op.getLhs().getDefiningOp<mlir::spu::pphlo::ConstantOp>();
-    multiplier = op.getRhs();
+// The splat floating point constant multiplied by a MulOp, and the index of
+// the other operand.
+std::optional<std::pair<double, size_t>> getSplatMultiplier(
+    mlir::spu::pphlo::MulOp op) {
+  for (size_t idx : {1, 0}) {
+    auto smallConst = op->getOperand(idx)
+                          .getDefiningOp<mlir::spu::pphlo::ConstantOp>();
+    if (!smallConst) {
+      continue;
+    }
+    if (!smallConst.getValue().isSplat()) {
+      return std::nullopt;
+    }
+    auto elType = smallConst.getValue().getElementType();
+    if (!elType.isF32() && !elType.isF64()) {
+      return std::nullopt;
+    }
+    return std::make_pair(std::abs(smallConst.getValue()
+                                       .getSplatValue<mlir::APFloat>()
+                                       .convertToDouble()),
+                          1 - idx);
+  }
+  return std::nullopt;
+}
+
+// x * c for a constant c smaller than the fixed point precision, null if c is
+// not that small.
+std::optional<spu::Value> mulSmallConst(SPUContext *sctx, const spu::Value &kv,
+                                        double fValue, const Shape &shape) {
+  auto eps = kernel::hal::dump_public_as<float>(
+      sctx, kernel::hlo::Epsilon(sctx, DT_F32))[0];
+
+  // Amplify eps to 1/(2^(fxp_bits-2))
+  // TODO: Maybe make it configurable?
+  eps = eps * 4;
+
+  if (fValue >= eps || fValue <= 0) {
+    return std::nullopt;
   }
 
-  if (smallConst && smallConst.getValue().isSplat()) {
-    auto elType = smallConst.getValue().getElementType();
-    if (elType.isF32() || elType.isF64()) {
-      auto fValue = std::abs(smallConst.getValue()
-                                 .getSplatValue<mlir::APFloat>()
-                                 .convertToDouble());
-      auto eps = kernel::hal::dump_public_as<float>(
-          sctx, kernel::hlo::Epsilon(sctx, DT_F32))[0];
-
-      // Amplify eps to 1/(2^(fxp_bits-2))
-      // TODO: Maybe make it configurable?
-      eps = eps * 4;
-
-      if (fValue < eps && fValue > 0) {
-        // Handle x * (very_small_const)
-        // return truncate(x * n/N, k); n = 2^k
-        // Compute N -> 1/fValue
-        auto N = 1 / fValue;
-        auto k = findTwoK(N);
-        auto n = std::pow(2, k);
-
-        // n/N
-        auto newRhs = kernel::hlo::Constant(sctx, static_cast<float>(n) / N,
-                                            smallConst.getType().getShape());
-        // x*n/N
-        auto kv = lookupValue(sscope, multiplier, opts);
-        // To merge truncation in multiply with next k-bits one, we
-        // deliberately pick the ring mul to do a mul *without* truncation
-        auto mulRet = kernel::hal::_mul(sctx, kv, newRhs).setDtype(kv.dtype());
-        // truncate(x*n/N, k)
-        addValue(sscope, op.getResult(),
-                 kernel::hal::_trunc(sctx, mulRet, sctx->getFxpBits() + k)
-                     .setDtype(mulRet.dtype()),
-                 opts);
-        return;
-      }
+  // Handle x * (very_small_const)
+  // return truncate(x * n/N, k); n = 2^k
+  // Compute N -> 1/fValue
+  auto N = 1 / fValue;
+  auto k = findTwoK(N);
+  auto n = std::pow(2, k);
+
+  // n/N
+  auto newRhs = kernel::hlo::Constant(sctx, static_cast<float>(n) / N, shape);
+  // x*n/N
+  // To merge truncation in multiply with next k-bits one, we
+  // deliberately pick the ring mul to do a mul *without* truncation
+  auto mulRet = kernel::hal::_mul(sctx, kv, newRhs).setDtype(kv.dtype());
+  // truncate(x*n/N, k)
+  return kernel::hal::_trunc(sctx, mulRet, sctx->getFxpBits() + k)
+      .setDtype(mulRet.dtype());
+}
+
+void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
+             mlir::spu::pphlo::MulOp &op, const ExecutionOptions &opts) {
+  if (auto multiplier = getSplatMultiplier(op)) {
+    const auto &[fValue, idx] = *multiplier;
+    const auto const_type = mlir::dyn_cast<mlir::RankedTensorType>(
+        op->getOperand(1 - idx).getType());
+    const Shape shape = const_type.getShape();
+    auto ret = mulSmallConst(
+        sctx, lookupValue(sscope, op->getOperand(idx), opts), fValue, shape);
+    if (ret.has_value()) {
+      addValue(sscope, op.getResult(), std::move(*ret), opts);
+      return;
     }
   }
 
@@ -351,6 +442,51 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::MulOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    double multiplier;
+    // index of the operand multiplied by the constant.
+    size_t operand;
+    Shape shape;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::MulOp op) {
+    auto multiplier = getSplatMultiplier(op);
+    if (!multiplier.has_value()) {
+      return nullptr;
+    }
+    auto attrs = std::make_shared<Attrs>();
+    std::tie(attrs->multiplier, attrs->operand) = *multiplier;
+    attrs->shape = mlir::dyn_cast<mlir::RankedTensorType>(
+                       op->getOperand(1 - attrs->operand).getType())
+                       .getShape();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    if (inst.attrs != nullptr) {
+      const auto &attrs = inst.getAttrs<Attrs>();
+      auto ret = mulSmallConst(sctx,
+                               lookupOperand(sscope, inst, attrs.operand, opts),
+                               attrs.multiplier, attrs.shape);
+      if (ret.has_value()) {
+        addResult(sscope, inst, 0, std::move(*ret), opts);
+        return;
+      }
+    }
+
+    addResult(sscope, inst, 0,
+              kernel::hlo::Mul(sctx, lookupOperand(sscope, inst, 0, opts),
+                               lookupOperand(sscope, inst, 1, opts)),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::DotOp &op, const ExecutionOptions &opts) {
   auto ret = kernel::hlo::Dot(sctx, lookupValue(sscope, op.getLhs(), opts),
@@ -363,6 +499,27 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::DotOp> {
+  static constexpr bool kEnabled = true;
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::DotOp op) {
+    auto attrs = std::make_shared<ShapeAttrs>();
+    attrs->shape =
+        mlir::dyn_cast<mlir::TensorType>(op.getResult().getType()).getShape();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    auto ret = kernel::hlo::Dot(sctx, lookupOperand(sscope, inst, 0, opts),
+                                lookupOperand(sscope, inst, 1, opts));
+    const auto &shape = inst.getAttrs<ShapeAttrs>().shape;
+    addResult(sscope, inst, 0, kernel::hlo::Reshape(sctx, ret, shape), opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::DotGeneralOp &op, const ExecutionOptions &opts) {
   auto dnum = op.getDotDimensionNumbers();
@@ -751,6 +908,30 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::TransposeOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    Axes permutation;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::TransposeOp op) {
+    auto attrs = std::make_shared<Attrs>();
+    attrs->permutation = op.getPermutation();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    addResult(sscope, inst, 0,
+              kernel::hlo::Transpose(sctx, lookupOperand(sscope, inst, 0, opts),
+                                     inst.getAttrs<Attrs>().permutation),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::BroadcastOp &op, const ExecutionOptions &opts) {
   auto to_shape =
@@ -763,6 +944,34 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
       opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::BroadcastOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    Shape to_shape;
+    Axes in_dims;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::BroadcastOp op) {
+    auto attrs = std::make_shared<Attrs>();
+    attrs->to_shape =
+        mlir::dyn_cast<mlir::RankedTensorType>(op.getType()).getShape();
+    attrs->in_dims = op.getBroadcastDimensions();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    const auto &attrs = inst.getAttrs<Attrs>();
+    addResult(sscope, inst, 0,
+              kernel::hlo::Broadcast(sctx, lookupOperand(sscope, inst, 0, opts),
+                                     attrs.to_shape, attrs.in_dims),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::ReshapeOp &op, const ExecutionOptions &opts) {
   auto to_shape =
@@ -773,6 +982,27 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::ReshapeOp> {
+  static constexpr bool kEnabled = true;
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::ReshapeOp op) {
+    auto attrs = std::make_shared<ShapeAttrs>();
+    attrs->shape =
+        mlir::dyn_cast<mlir::RankedTensorType>(op.getType()).getShape();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    addResult(sscope, inst, 0,
+              kernel::hlo::Reshape(sctx, lookupOperand(sscope, inst, 0, opts),
+                                   inst.getAttrs<ShapeAttrs>().shape),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::ConcatenateOp &op,
              const ExecutionOptions &opts) {
@@ -787,6 +1017,34 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            kernel::hlo::Concatenate(sctx, values, op.getDimension()), opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::ConcatenateOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    int64_t dimension;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::ConcatenateOp op) {
+    auto attrs = std::make_shared<Attrs>();
+    attrs->dimension = op.getDimension();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    std::vector<spu::Value> values(inst.operands.size());
+    for (size_t idx = 0; idx < values.size(); ++idx) {
+      values[idx] = lookupOperand(sscope, inst, idx, opts);
+    }
+    addResult(sscope, inst, 0,
+              kernel::hlo::Concatenate(sctx, values,
+                                       inst.getAttrs<Attrs>().dimension),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::SliceOp &op, const ExecutionOptions &opts) {
   Index start = op.getStartIndices();
@@ -798,6 +1056,35 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::SliceOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    Index start;
+    Index end;
+    Strides strides;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::SliceOp op) {
+    auto attrs = std::make_shared<Attrs>();
+    attrs->start = op.getStartIndices();
+    attrs->end = op.getLimitIndices();
+    attrs->strides = op.getStrides();
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    const auto &attrs = inst.getAttrs<Attrs>();
+    addResult(sscope, inst, 0,
+              kernel::hlo::Slice(sctx, lookupOperand(sscope, inst, 0, opts),
+                                 attrs.start, attrs.end, attrs.strides),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::PadOp &op, const ExecutionOptions &opts) {
   const auto &operand = lookupValue(sscope, op.getOperand(), opts);
@@ -975,6 +1262,24 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
            kernel::hlo::Select(sctx, pred, on_true, on_false), opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::SelectOp> {
+  static constexpr bool kEnabled = true;
+
+  static std::shared_ptr<const LoweredAttrs> lower(mlir::spu::pphlo::SelectOp) {
+    return nullptr;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    addResult(sscope, inst, 0,
+              kernel::hlo::Select(sctx, lookupOperand(sscope, inst, 0, opts),
+                                  lookupOperand(sscope, inst, 1, opts),
+                                  lookupOperand(sscope, inst, 2, opts)),
+              opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::RngOp &op, const ExecutionOptions &opts) {
   auto to_shape =
@@ -1006,6 +1311,42 @@ void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
   addValue(sscope, op.getResult(), casted, opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::ConvertOp> {
+  static constexpr bool kEnabled = true;
+
+  struct Attrs : LoweredAttrs {
+    DataType dst_dtype;
+    spu::Visibility dst_vtype;
+    bool to_complex;
+  };
+
+  static std::shared_ptr<const LoweredAttrs> lower(
+      mlir::spu::pphlo::ConvertOp op) {
+    mlir::spu::pphlo::TypeTools tool(op->getContext());
+    auto attrs = std::make_shared<Attrs>();
+    attrs->dst_dtype = getDtypeFromMlirType(op.getType());
+    attrs->dst_vtype = convertVisibility(tool.getTypeVisibility(op.getType()));
+    attrs->to_complex =
+        !mlir::isa<mlir::ComplexType>(
+            tool.getExpressedType(op.getOperand().getType())) &&
+        mlir::isa<mlir::ComplexType>(tool.getExpressedType(op.getType()));
+    return attrs;
+  }
+
+  static void run(SPUContext *sctx, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &opts) {
+    const auto &attrs = inst.getAttrs<Attrs>();
+    auto casted = kernel::hlo::Cast(sctx, lookupOperand(sscope, inst, 0, opts),
+                                    attrs.dst_vtype, attrs.dst_dtype);
+    if (attrs.to_complex) {
+      auto imag = kernel::hlo::Imag(sctx, casted);
+      casted = kernel::hlo::Complex(sctx, casted, imag);
+    }
+    addResult(sscope, inst, 0, std::move(casted), opts);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::SignOp &op, const ExecutionOptions &opts) {
   auto in = lookupValue(sscope, op.getOperand(), opts);
@@ -1139,23 +1480,25 @@ void execute(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
 
 void execute(OpExecutor *, SPUContext *, SymbolScope *sscope,
              mlir::spu::pphlo::FreeOp &op, const ExecutionOptions &opts) {
-  if (opts.do_parallel) {
-    // Think about the following case
-    // %a = def
-    // use(%a)
-    // use(%a)
-    // free(%a)
-    // Here free is also a consider a use...so under parallel execution free
-    // will be invoked once a is defined.
-    // This will make %a randomly deallocated after defined.
-    // FreeOp has an implicit requirement that it needs to be invoked after all
-    // other uses are done.
-    // FIXME(xiaochen): Enable this...
-    return;
-  }
+  // Under parallel execution, the scheduler orders FreeOp after all other uses
+  // of the operand.
   removeValue(sscope, op.getOperand(), opts);
 }
 
+template <>
+struct LoweredKernel<mlir::spu::pphlo::FreeOp> {
+  static constexpr bool kEnabled = true;
+
+  static std::shared_ptr<const LoweredAttrs> lower(mlir::spu::pphlo::FreeOp) {
+    return nullptr;
+  }
+
+  static void run(SPUContext *, SymbolScope *sscope, const LoweredOp &inst,
+                  const ExecutionOptions &) {
+    sscope->removeSlot(inst.operands[0]);
+  }
+};
+
 void execute(OpExecutor *, SPUContext *sctx, SymbolScope *sscope,
              mlir::spu::pphlo::RealOp &op, const ExecutionOptions &opts) {
   auto v = lookupValue(sscope, op.getOperand(), opts);
@@ -1216,71 +1559,82 @@ bool PPHloExecutor::hasKernel(mlir::Operation &op) const {
       >(op);
 }
 
-template <typename OpT, typename... MoreOpT>
-static void dispatchOp(OpExecutor *executor, SPUContext *sctx,
-                       SymbolScope *sscope, mlir::Operation &op,
-                       const ExecutionOptions &opts) {
-  if (auto casted = llvm::dyn_cast<OpT>(op)) {
-    // Execute op
-    {
-      const auto fn_name = op.getName().getStringRef().str();
-
-      if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::CustomCallOp>) {
-        // trace action holds RAII, we can not put it in a single scope
-        SPU_TRACE_ACTION(
-            GET_TRACER(sctx), sctx->lctx(), (TR_HLO | TR_LAR), ~TR_HLO,
-            fmt::format("{}: {}", fn_name, casted.getCallTargetName().str()));
-        execute(executor, sctx, sscope, casted, opts);
-      } else {
-        SPU_TRACE_ACTION(GET_TRACER(sctx), sctx->lctx(), (TR_HLO | TR_LAR),
-                         ~TR_HLO, fn_name);
-        execute(executor, sctx, sscope, casted, opts);
-      }
-    }
+template <typename OpT>
+static void runOp(OpExecutor *executor, SPUContext *sctx, SymbolScope *sscope,
+                  mlir::Operation &op, const ExecutionOptions &opts) {
+  if (opts.do_log_execution) {
+    SPDLOG_INFO("PPHLO {}", mlir::spu::mlirObjectToString(op));
+  }
 
-    // currently we only support config verifier statically.
-    constexpr bool kEnableXlaVerifier = false;
-    if (kEnableXlaVerifier) {
-      PPHloVerifier verifier(sctx);
-      // handle mixed (int, fxp) multiplication
-      if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::MulOp> or
-                    std::is_same_v<OpT, mlir::spu::pphlo::DotOp> or
-                    std::is_same_v<OpT, mlir::spu::pphlo::DotGeneralOp>) {
-        spu::Value lhs = sscope->lookupValue(casted.getLhs());
-        spu::Value rhs = sscope->lookupValue(casted.getRhs());
-        spu::Value ret = sscope->lookupValue(casted.getResult());
-        mlir::spu::pphlo::TypeTools type_tool(op.getContext());
-        auto lhs_type = type_tool.getType(casted.getLhs().getType(),
-                                          mlir::spu::pphlo::Visibility::PUBLIC);
-        auto rhs_type = type_tool.getType(casted.getRhs().getType(),
-                                          mlir::spu::pphlo::Visibility::PUBLIC);
-        auto ret_type = type_tool.getType(casted.getResult().getType(),
-                                          mlir::spu::pphlo::Visibility::PUBLIC);
-
-        if (lhs_type != ret_type) {
-          lhs = kernel::hlo::Cast(sctx, lhs, lhs.vtype(), ret.dtype());
-        }
-        if (rhs_type != ret_type) {
-          rhs = kernel::hlo::Cast(sctx, rhs, rhs.vtype(), ret.dtype());
-        }
+  auto casted = llvm::cast<OpT>(op);
+  // Execute op
+  {
+    const auto fn_name = op.getName().getStringRef().str();
+
+    if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::CustomCallOp>) {
+      // trace action holds RAII, we can not put it in a single scope
+      SPU_TRACE_ACTION(
+          GET_TRACER(sctx), sctx->lctx(), (TR_HLO | TR_LAR), ~TR_HLO,
+          fmt::format("{}: {}", fn_name, casted.getCallTargetName().str()));
+      execute(executor, sctx, sscope, casted, opts);
+    } else {
+      SPU_TRACE_ACTION(GET_TRACER(sctx), sctx->lctx(), (TR_HLO | TR_LAR),
+                       ~TR_HLO, fn_name);
+      execute(executor, sctx, sscope, casted, opts);
+    }
+  }
 
-        verifier.verify(casted, {lhs, rhs}, {ret});
-      } else if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::FreeOp>) {
-        SPDLOG_INFO("Skip Free Op");
-      } else {
-        // Collect inputs
-        std::vector<spu::Value> ins;
-        for (auto operand : op.getOperands()) {
-          ins.emplace_back(sscope->lookupValue(operand));
-        }
-        std::vector<spu::Value> outs;
-        for (auto operand : op.getResults()) {
-          outs.emplace_back(sscope->lookupValue(operand));
-        }
+  // currently we only support config verifier statically.
+  constexpr bool kEnableXlaVerifier = false;
+  if (kEnableXlaVerifier) {
+    PPHloVerifier verifier(sctx);
+    // handle mixed (int, fxp) multiplication
+    if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::MulOp> or
+                  std::is_same_v<OpT, mlir::spu::pphlo::DotOp> or
+                  std::is_same_v<OpT, mlir::spu::pphlo::DotGeneralOp>) {
+      spu::Value lhs = sscope->lookupValue(casted.getLhs());
+      spu::Value rhs = sscope->lookupValue(casted.getRhs());
+      spu::Value ret = sscope->lookupValue(casted.getResult());
+      mlir::spu::pphlo::TypeTools type_tool(op.getContext());
+      auto lhs_type = type_tool.getType(casted.getLhs().getType(),
+                                        mlir::spu::pphlo::Visibility::PUBLIC);
+      auto rhs_type = type_tool.getType(casted.getRhs().getType(),
+                                        mlir::spu::pphlo::Visibility::PUBLIC);
+      auto ret_type = type_tool.getType(casted.getResult().getType(),
+                                        mlir::spu::pphlo::Visibility::PUBLIC);
+
+      if (lhs_type != ret_type) {
+        lhs = kernel::hlo::Cast(sctx, lhs, lhs.vtype(), ret.dtype());
+      }
+      if (rhs_type != ret_type) {
+        rhs = kernel::hlo::Cast(sctx, rhs, rhs.vtype(), ret.dtype());
+      }
 
-        verifier.verify(casted, ins, outs);
+      verifier.verify(casted, {lhs, rhs}, {ret});
+    } else if constexpr (std::is_same_v<OpT, mlir::spu::pphlo::FreeOp>) {
+      SPDLOG_INFO("Skip Free Op");
+    } else {
+      // Collect inputs
+      std::vector<spu::Value> ins;
+      for (auto operand : op.getOperands()) {
+        ins.emplace_back(sscope->lookupValue(operand));
+      }
+      std::vector<spu::Value> outs;
+      for (auto operand : op.getResults()) {
+        outs.emplace_back(sscope->lookupValue(operand));
       }
+
+      verifier.verify(casted, ins, outs);
     }
+  }
+}
+
+template <typename OpT, typename... MoreOpT>
+static void dispatchOp(OpExecutor *executor, SPUContext *sctx,
+                       SymbolScope *sscope, mlir::Operation &op,
+                       const ExecutionOptions &opts) {
+  if (llvm::isa<OpT>(op)) {
+    runOp<OpT>(executor, sctx, sscope, op, opts);
   } else {
     if constexpr (!sizeof...(MoreOpT)) {
       SPU_THROW("Unhandled mlir op {} at {}", mlir::spu::mlirObjectToString(op),
@@ -1291,18 +1645,59 @@ static void dispatchOp(OpExecutor *executor, SPUContext *sctx,
   }
 }
 
+template <typename OpT>
+static void runLowered(OpExecutor *executor, SPUContext *sctx,
+                       SymbolScope *sscope, const LoweredOp &inst,
+                       const ExecutionOptions &opts) {
+  if constexpr (LoweredKernel<OpT>::kEnabled) {
+    if (opts.do_log_execution) {
+      SPDLOG_INFO("PPHLO {}", mlir::spu::mlirObjectToString(*inst.op));
+    }
+
+    const auto fn_name = inst.op->getName().getStringRef().str();
+    SPU_TRACE_ACTION(GET_TRACER(sctx), sctx->lctx(), (TR_HLO | TR_LAR),
+                     ~TR_HLO, fn_name);
+    LoweredKernel<OpT>::run(sctx, sscope, inst, opts);
+  } else {
+    runOp<OpT>(executor, sctx, sscope, *inst.op, opts);
+  }
+}
+
+template <typename OpT>
+static void lowerOpImpl(LoweredOp &inst) {
+  inst.kernel = &runLowered<OpT>;
+  if constexpr (LoweredKernel<OpT>::kEnabled) {
+    inst.attrs = LoweredKernel<OpT>::lower(llvm::cast<OpT>(inst.op));
+  }
+}
+
+template <typename... OpT>
+static llvm::DenseMap<mlir::TypeID, void (*)(LoweredOp &)> makeLoweringTable() {
+  llvm::DenseMap<mlir::TypeID, void (*)(LoweredOp &)> table;
+  (table.try_emplace(mlir::TypeID::get<OpT>(), &lowerOpImpl<OpT>), ...);
+  return table;
+}
+
 void PPHloExecutor::runKernelImpl(SPUContext *sctx, SymbolScope *sscope,
                                   mlir::Operation &op,
                                   const ExecutionOptions &opts) {
-  if (opts.do_log_execution) {
-    SPDLOG_INFO("PPHLO {}", mlir::spu::mlirObjectToString(op));
-  }
   dispatchOp<
 #define GET_OP_LIST
 #include "libspu/dialect/pphlo/IR/ops.cc.inc"
       >(this, sctx, sscope, op, opts);
 }
 
+void PPHloExecutor::lowerOp(LoweredOp &inst) const {
+  static const auto kLowerings = makeLoweringTable<
+#define GET_OP_LIST
+#include "libspu/dialect/pphlo/IR/ops.cc.inc"
+      >();
+  auto itr = kLowerings.find(inst.op->getName().getTypeID());
+  if (itr != kLowerings.end()) {
+    itr->second(inst);
+  }
+}
+
 void PPHloExecutor::checkType(mlir::Type, const spu::Value &) const {}
 
 }  // namespace spu::device::pphlo
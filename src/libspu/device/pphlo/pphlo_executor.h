@@ -29,6 +29,11 @@ class PPHloExecutor : public OpExecutor {
   // return true if the operation has a corresponding kernel.
   bool hasKernel(mlir::Operation &op) const override;
 
+  // resolve the kernel of a pphlo op by op type once, the ops which make up
+  // most loop bodies (elementwise, shape and dot ops) also get kernels which
+  // access values by slot with their attributes decoded.
+  void lowerOp(LoweredOp &inst) const override;
+
   // run a kernel in a given region.
   void runKernelImpl(SPUContext *sctx, SymbolScope *sscope, mlir::Operation &op,
                      const ExecutionOptions &opts) override;
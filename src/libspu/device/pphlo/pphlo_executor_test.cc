@@ -22,6 +22,9 @@
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 
+#include "libspu/device/executable_cache.h"
+#include "libspu/device/executor.h"
+#include "libspu/device/pphlo/pphlo_executor.h"
 #include "libspu/device/utils/pphlo_executor_test_runner.h"
 
 namespace spu::device::pphlo::test {
@@ -2785,6 +2788,221 @@ func.func @main(%arg0: tensor<20xi32>) -> (tensor<20xi32>, tensor<20xi32>) {
   r.verifyOutput(expected_ret1.data(), 1);
 }
 
+TEST_P(ExecutorTest, InterOpParallel) {
+  xt::xarray<int32_t> x = {1, 2, 3, 4};
+  xt::xarray<int32_t> y = {5, 6, 7, 8};
+  xt::xarray<int32_t> expected = {31, 92, 199, 364};
+
+  Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+           std::get<2>(GetParam()));
+  r.getConfig().experimental_enable_inter_op_par = true;
+  r.getConfig().experimental_inter_op_concurrency = 4;
+
+  r.addInput(x, VIS_SECRET);
+  r.addInput(y, VIS_SECRET);
+
+  // Compiled program contains frees, which must wait for all other uses.
+  r.run(r.compileMHlo(R"(
+func.func @main(%arg0: tensor<4xi32>, %arg1: tensor<4xi32>) -> (tensor<4xi32>) {
+  %0 = stablehlo.multiply %arg0, %arg1 : tensor<4xi32>
+  %1 = stablehlo.add %arg0, %arg1 : tensor<4xi32>
+  %2 = stablehlo.multiply %0, %1 : tensor<4xi32>
+  %3 = stablehlo.subtract %1, %0 : tensor<4xi32>
+  %4 = stablehlo.add %2, %3 : tensor<4xi32>
+  return %4 : tensor<4xi32>
+})",
+                      {VIS_SECRET, VIS_SECRET}));
+
+  r.verifyOutput(expected.data());
+}
+
+TEST_P(ExecutorTest, InterOpCriticalPath) {
+  xt::xarray<int32_t> x = {1, 2, 3, 4};
+  xt::xarray<int32_t> y = {5, 6, 7, 8};
+  xt::xarray<int32_t> expected = {16, 68, 220, 556};
+
+  Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+           std::get<2>(GetParam()));
+  r.getConfig().experimental_enable_inter_op_par = true;
+  r.getConfig().experimental_inter_op_concurrency = 4;
+  r.getConfig().experimental_enable_critical_path_scheduling = true;
+
+  r.addInput(x, VIS_SECRET);
+  r.addInput(y, VIS_SECRET);
+
+  // The chain of multiplications is run before the first add, which is not on
+  // the critical path.
+  r.run(r.compileMHlo(R"(
+func.func @main(%arg0: tensor<4xi32>, %arg1: tensor<4xi32>) -> (tensor<4xi32>) {
+  %0 = stablehlo.add %arg0, %arg1 : tensor<4xi32>
+  %1 = stablehlo.multiply %arg0, %arg1 : tensor<4xi32>
+  %2 = stablehlo.multiply %1, %arg0 : tensor<4xi32>
+  %3 = stablehlo.multiply %2, %arg0 : tensor<4xi32>
+  %4 = stablehlo.add %0, %3 : tensor<4xi32>
+  %5 = stablehlo.add %4, %1 : tensor<4xi32>
+  return %5 : tensor<4xi32>
+})",
+                      {VIS_SECRET, VIS_SECRET}));
+
+  r.verifyOutput(expected.data());
+}
+
+TEST_P(ExecutorTest, BeaverPrefetchHints) {
+  xt::xarray<int32_t> x = {1, 2, 3, 4};
+  xt::xarray<int32_t> y = {5, 6, 7, 8};
+  xt::xarray<int32_t> expected = {16, 68, 220, 556};
+
+  for (bool parallel : {false, true}) {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+    // semi2k prefetches the correlations of the hinted multiplications.
+    r.getConfig().experimental_beaver_prefetch_depth = 2;
+    r.getConfig().experimental_enable_inter_op_par = parallel;
+
+    r.addInput(x, VIS_SECRET);
+    r.addInput(y, VIS_SECRET);
+
+    r.run(r.compileMHlo(R"(
+func.func @main(%arg0: tensor<4xi32>, %arg1: tensor<4xi32>) -> (tensor<4xi32>) {
+  %0 = stablehlo.add %arg0, %arg1 : tensor<4xi32>
+  %1 = stablehlo.multiply %arg0, %arg1 : tensor<4xi32>
+  %2 = stablehlo.multiply %1, %arg0 : tensor<4xi32>
+  %3 = stablehlo.multiply %2, %arg0 : tensor<4xi32>
+  %4 = stablehlo.add %0, %3 : tensor<4xi32>
+  %5 = stablehlo.add %4, %1 : tensor<4xi32>
+  return %5 : tensor<4xi32>
+})",
+                        {VIS_SECRET, VIS_SECRET}));
+
+    r.verifyOutput(expected.data());
+  }
+}
+
+TEST_P(ExecutorTest, LoweredLoopBody) {
+  xt::xarray<int32_t> expected = {{94863, 312144}, {312670, 1032066}};
+
+  for (bool parallel : {false, true}) {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+    r.getConfig().experimental_enable_inter_op_par = parallel;
+
+    r.addInput(xt::xarray<int32_t>({{1, 2}, {3, 4}}));
+    r.addInput(3);
+
+    // The body reads %0 and %1 from the enclosing scope on every iteration.
+    r.run(R"(
+func.func @main(%arg0: tensor<2x2xi32>, %arg1: tensor<i32>) -> (tensor<2x2xi32>) {
+  %0 = pphlo.constant dense<1> : tensor<i32>
+  %1 = pphlo.constant dense<[[1, -1], [2, 1]]> : tensor<2x2xi32>
+  %2 = pphlo.constant dense<0> : tensor<i32>
+  %3:2 = pphlo.while(%arg2 = %2, %arg3 = %arg0): tensor<i32>, tensor<2x2xi32>
+  cond {
+    %4 = pphlo.less %arg2, %arg1 : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    pphlo.return %4 : tensor<i1>
+  } do {
+    %4 = pphlo.add %arg2, %0 : tensor<i32>
+    %5 = pphlo.transpose %arg3, dims = [1, 0] : (tensor<2x2xi32>) -> tensor<2x2xi32>
+    %6 = pphlo.slice %5 [0:1:1, 0:1:2] : (tensor<2x2xi32>) -> tensor<1x2xi32>
+    %7 = pphlo.reshape %6 : (tensor<1x2xi32>) -> tensor<2xi32>
+    %8 = pphlo.broadcast %7, dims = [1] : (tensor<2xi32>) -> tensor<2x2xi32>
+    %9 = pphlo.dot %arg3, %5 : (tensor<2x2xi32>, tensor<2x2xi32>) -> tensor<2x2xi32>
+    %10 = pphlo.less %9, %8 : (tensor<2x2xi32>, tensor<2x2xi32>) -> tensor<2x2xi1>
+    %11 = pphlo.select %10, %9, %8 : (tensor<2x2xi1>, tensor<2x2xi32>, tensor<2x2xi32>) -> tensor<2x2xi32>
+    %12 = pphlo.slice %11 [0:1:1, 0:1:2] : (tensor<2x2xi32>) -> tensor<1x2xi32>
+    %13 = pphlo.slice %11 [1:1:2, 0:1:2] : (tensor<2x2xi32>) -> tensor<1x2xi32>
+    %14 = pphlo.concatenate %13, %12 dim = 0 : (tensor<1x2xi32>, tensor<1x2xi32>) -> tensor<2x2xi32>
+    %15 = pphlo.multiply %14, %1 : tensor<2x2xi32>
+    %16 = pphlo.add %15, %9 : tensor<2x2xi32>
+    pphlo.return %4, %16 : tensor<i32>, tensor<2x2xi32>
+  }
+  return %3#1 : tensor<2x2xi32>
+})");
+
+    r.verifyOutput(expected.data());
+  }
+}
+
+TEST_P(ExecutorTest, NestedRegionsOnOneWorker) {
+  xt::xarray<int32_t> expected = {{24, 48}, {72, 96}};
+
+  for (bool critical_path : {false, true}) {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+    // A single worker, which runs some of the loops and their bodies.
+    r.getConfig().experimental_enable_inter_op_par = true;
+    r.getConfig().experimental_inter_op_concurrency = 2;
+    r.getConfig().experimental_enable_critical_path_scheduling = critical_path;
+
+    r.addInput(xt::xarray<int32_t>({{1, 2}, {3, 4}}));
+    r.addInput(3);
+
+    std::string loops;
+    for (int idx = 0; idx < 3; ++idx) {
+      loops += fmt::format(R"(
+  %l{0}:2 = pphlo.while(%i = %0, %x = %arg0): tensor<i32>, tensor<2x2xi32>
+  cond {{
+    %c = pphlo.less %i, %arg1 : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    pphlo.return %c : tensor<i1>
+  }} do {{
+    %n = pphlo.add %i, %1 : tensor<i32>
+    %y = pphlo.add %x, %x : tensor<2x2xi32>
+    pphlo.return %n, %y : tensor<i32>, tensor<2x2xi32>
+  }})",
+                           idx);
+    }
+
+    r.run(fmt::format(R"(
+func.func @main(%arg0: tensor<2x2xi32>, %arg1: tensor<i32>) -> (tensor<2x2xi32>) {{
+  %0 = pphlo.constant dense<0> : tensor<i32>
+  %1 = pphlo.constant dense<1> : tensor<i32>{}
+  %2 = pphlo.add %l0#1, %l1#1 : tensor<2x2xi32>
+  %3 = pphlo.add %2, %l2#1 : tensor<2x2xi32>
+  return %3 : tensor<2x2xi32>
+}})",
+                      loops));
+
+    r.verifyOutput(expected.data());
+  }
+}
+
+TEST(LoweringTest, SlotsAndAttrs) {
+  auto parsed = ParsedExecutable::parse(R"(
+func.func @main(%arg0: tensor<2x3xi32>) -> (tensor<3x2xi32>) {
+  %0 = pphlo.transpose %arg0, dims = [1, 0] : (tensor<2x3xi32>) -> tensor<3x2xi32>
+  %1 = pphlo.negate %0 : tensor<3x2xi32>
+  %2 = pphlo.add %1, %0 : tensor<3x2xi32>
+  return %2 : tensor<3x2xi32>
+})");
+  auto &region = parsed->entry().getBody();
+
+  PPHloExecutor executor;
+  SymbolScope scope(region, nullptr, &executor);
+  const auto *lowered = scope.getLowered(&executor, &region.front());
+  ASSERT_NE(lowered, nullptr);
+  ASSERT_EQ(lowered->instructions.size(), 3);
+
+  const auto &transpose = lowered->instructions[0];
+  const auto &negate = lowered->instructions[1];
+  const auto &add = lowered->instructions[2];
+  for (const auto &inst : lowered->instructions) {
+    EXPECT_NE(inst.kernel, nullptr);
+    EXPECT_EQ(inst.operands.size(), inst.op->getNumOperands());
+    EXPECT_EQ(inst.results.size(), inst.op->getNumResults());
+  }
+
+  // block arguments are numbered first.
+  EXPECT_EQ(transpose.operands[0], 0);
+  EXPECT_EQ(negate.operands[0], transpose.results[0]);
+  EXPECT_EQ(add.operands[0], negate.results[0]);
+  EXPECT_EQ(add.operands[1], transpose.results[0]);
+  EXPECT_THAT(lowered->return_slots, testing::ElementsAre(add.results[0]));
+
+  // only ops with attributes decode them.
+  EXPECT_NE(transpose.attrs, nullptr);
+  EXPECT_EQ(negate.attrs, nullptr);
+  EXPECT_EQ(add.attrs, nullptr);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ExecutorTestInstances, ExecutorTest,
     testing::Combine(testing::Values(4, 3, 2),
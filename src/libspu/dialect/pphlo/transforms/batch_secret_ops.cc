@@ -0,0 +1,230 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <tuple>
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/MapVector.h"
+#include "mlir/Pass/Pass.h"
+
+#include "libspu/dialect/pphlo/IR/ops.h"
+#include "libspu/dialect/pphlo/transforms/pass_details.h"
+#include "libspu/dialect/pphlo/transforms/passes.h"
+
+namespace mlir::spu::pphlo {
+
+namespace {
+
+// Larger ops are bandwidth bound, batching them saves little and copies a lot.
+constexpr int64_t kMaxBatchedNumel = 1 << 16;
+
+// Idea here:
+//   z0 = op(x0, y0)                     x = concat(flatten(x0), flatten(x1))
+//   ...                         into    y = concat(flatten(y0), flatten(y1))
+//   z1 = op(x1, y1)                     z = op(x, y)
+//                                       z0 = reshape(slice(z, 0)), ...
+// Rational:
+// Each secret multiplication/comparison costs a few communication rounds no
+// matter its size, independent ops of the same kind issued as one op pay
+// these rounds once.
+//
+// Ops are independent when they have the same depth in the dependency graph
+// of their block. The batched op is placed at the last op of a group, ops in
+// between depending on the group are moved after it.
+struct BatchSecretOps : public BatchSecretOpsBase<BatchSecretOps> {
+  void runOnOperation() override {
+    llvm::SmallVector<Block *> blocks;
+    getOperation().walk([&](Block *block) { blocks.emplace_back(block); });
+
+    for (auto *block : blocks) {
+      batchBlock(*block);
+    }
+  }
+
+ private:
+  // Returns true for binary elementwise ops that communicate.
+  static bool isBatchable(Operation *op, const TypeTools &tools) {
+    if (!mlir::isa<MulOp, AndOp, OrOp, MaxOp, MinOp, LessOp, LessEqualOp,
+                   GreaterOp, GreaterEqualOp, EqualOp, NotEqualOp>(op)) {
+      return false;
+    }
+
+    const bool lhs_secret = tools.isSecretType(op->getOperand(0).getType());
+    const bool rhs_secret = tools.isSecretType(op->getOperand(1).getType());
+    if (mlir::isa<MulOp, AndOp, OrOp>(op)) {
+      // with a public operand it's local.
+      if (!lhs_secret || !rhs_secret) {
+        return false;
+      }
+    } else if (!lhs_secret && !rhs_secret) {
+      return false;
+    }
+
+    auto type = mlir::dyn_cast<RankedTensorType>(op->getResult(0).getType());
+    if (!type || !type.hasStaticShape()) {
+      return false;
+    }
+    const auto numel = type.getNumElements();
+    return numel > 0 && numel <= kMaxBatchedNumel;
+  }
+
+  void batchBlock(Block &block) {
+    TypeTools tools(&getContext());
+
+    // depth of an op, ops of the same depth do not depend on each other.
+    llvm::DenseMap<Operation *, int64_t> depth;
+    using Key = std::tuple<int64_t, void *, Type, Type, Type>;
+    llvm::MapVector<Key, llvm::SmallVector<Operation *>> groups;
+
+    for (auto &op : block) {
+      int64_t d = 0;
+      op.walk([&](Operation *nested) {
+        for (const auto &operand : nested->getOperands()) {
+          auto *def = operand.getDefiningOp();
+          if (def != nullptr && def->getBlock() == &block) {
+            d = std::max(d, depth.lookup(def) + 1);
+          }
+        }
+      });
+      depth[&op] = d;
+
+      if (isBatchable(&op, tools)) {
+        Key key(d, op.getName().getAsOpaquePointer(),
+                getElementTypeOrSelf(op.getOperand(0).getType()),
+                getElementTypeOrSelf(op.getOperand(1).getType()),
+                getElementTypeOrSelf(op.getResult(0).getType()));
+        groups[key].emplace_back(&op);
+      }
+    }
+
+    for (auto &[key, ops] : groups) {
+      if (ops.size() > 1) {
+        batchGroup(ops);
+      }
+    }
+  }
+
+  static void batchGroup(llvm::SmallVector<Operation *> &ops) {
+    std::sort(ops.begin(), ops.end(), [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+    auto *first = ops.front();
+    auto *last = ops.back();
+
+    // Ops between the first and the last of the group which use the results
+    // of the group, directly or not.
+    llvm::DenseSet<Operation *> group(ops.begin(), ops.end());
+    llvm::DenseSet<Value> tainted;
+    for (auto *op : ops) {
+      tainted.insert(op->getResult(0));
+    }
+    llvm::SmallVector<Operation *> to_move;
+    for (auto *op = first->getNextNode(); op != last; op = op->getNextNode()) {
+      if (group.contains(op)) {
+        continue;
+      }
+      bool uses_group = false;
+      op->walk([&](Operation *nested) {
+        for (const auto &operand : nested->getOperands()) {
+          uses_group |= tainted.contains(operand);
+        }
+      });
+      if (!uses_group) {
+        continue;
+      }
+      // Do not reorder side effects, e.g. debug prints.
+      if (mlir::isa<CustomCallOp>(op)) {
+        return;
+      }
+      to_move.emplace_back(op);
+      for (const auto &result : op->getResults()) {
+        tainted.insert(result);
+      }
+    }
+
+    OpBuilder builder(last);
+    builder.setInsertionPointAfter(last);
+    llvm::SmallVector<Location> locs;
+    for (auto *op : ops) {
+      locs.emplace_back(op->getLoc());
+    }
+    auto loc = builder.getFusedLoc(locs);
+
+    int64_t total = 0;
+    for (auto *op : ops) {
+      total += mlir::cast<RankedTensorType>(op->getResult(0).getType())
+                   .getNumElements();
+    }
+
+    auto concat = [&](size_t operand_idx) -> Value {
+      llvm::SmallVector<Value> flattened;
+      for (auto *op : ops) {
+        auto operand = op->getOperand(operand_idx);
+        auto type = mlir::cast<RankedTensorType>(operand.getType());
+        flattened.emplace_back(builder.create<ReshapeOp>(
+            loc,
+            RankedTensorType::get({type.getNumElements()},
+                                  type.getElementType()),
+            operand));
+      }
+      auto el_type = getElementTypeOrSelf(flattened.front().getType());
+      return builder.create<ConcatenateOp>(
+          loc, RankedTensorType::get({total}, el_type), flattened,
+          builder.getI64IntegerAttr(0));
+    };
+    auto lhs = concat(0);
+    auto rhs = concat(1);
+
+    OperationState state(loc, first->getName());
+    state.addOperands({lhs, rhs});
+    state.addTypes(RankedTensorType::get(
+        {total}, getElementTypeOrSelf(first->getResult(0).getType())));
+    auto *batched = builder.create(state);
+
+    Operation *anchor = batched;
+    int64_t offset = 0;
+    for (auto *op : ops) {
+      auto type = mlir::cast<RankedTensorType>(op->getResult(0).getType());
+      const auto numel = type.getNumElements();
+      auto slice = builder.create<SliceOp>(
+          op->getLoc(),
+          RankedTensorType::get({numel}, type.getElementType()),
+          batched->getResult(0),
+          DenseI64ArrayAttr::get(builder.getContext(), {offset}),
+          DenseI64ArrayAttr::get(builder.getContext(), {offset + numel}),
+          DenseI64ArrayAttr::get(builder.getContext(), {1}));
+      auto reshape = builder.create<ReshapeOp>(op->getLoc(), type, slice);
+      op->getResult(0).replaceAllUsesWith(reshape.getResult());
+      anchor = reshape;
+      offset += numel;
+    }
+
+    for (auto *op : to_move) {
+      op->moveAfter(anchor);
+      anchor = op;
+    }
+    for (auto *op : ops) {
+      op->erase();
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>> createBatchSecretOpsPass() {
+  return std::make_unique<BatchSecretOps>();
+}
+
+}  // namespace mlir::spu::pphlo
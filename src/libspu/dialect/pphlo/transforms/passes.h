@@ -53,6 +53,9 @@ std::unique_ptr<OperationPass<func::FuncOp>> createOptimizeMaxPoolingPass();
 // Optimize SelectOp
 std::unique_ptr<OperationPass<func::FuncOp>> createOptimizeSelectPass();
 
+// Merge independent secret ops of the same kind into one op
+std::unique_ptr<OperationPass<func::FuncOp>> createBatchSecretOpsPass();
+
 // Optimize sqrt(x) + very_small_const) -> sqrt(x + eps)
 std::unique_ptr<OperationPass<func::FuncOp>> createOptimizeSqrtPlusEps();
 
@@ -20,34 +20,39 @@
 
 namespace spu::mpc {
 
-#define FORCE_DISPATCH(CTX, ...)                      \
-  {                                                   \
-    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);             \
-    return dynDispatch((CTX), __func__, __VA_ARGS__); \
+// Kernel ids are interned once per call site, see api.cc.
+#define FORCE_DISPATCH(CTX, ...)                                  \
+  {                                                               \
+    static const KernelId kKernelId = internKernelName(__func__); \
+    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);                         \
+    return dynDispatch((CTX), kKernelId, __VA_ARGS__);            \
   }
 
-#define TRY_NAMED_DISPATCH(CTX, FNAME, ...)        \
-  if ((CTX)->hasKernel(__func__)) {                \
-    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);          \
-    return dynDispatch((CTX), FNAME, __VA_ARGS__); \
+#define TRY_NAMED_DISPATCH(CTX, FNAME, ...)                    \
+  {                                                            \
+    static const KernelId kKernelId = internKernelName(FNAME); \
+    if ((CTX)->hasKernel(kKernelId)) {                         \
+      SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);                    \
+      return dynDispatch((CTX), kKernelId, __VA_ARGS__);       \
+    }                                                          \
   }
 
 #define TRY_DISPATCH(CTX, ...) TRY_NAMED_DISPATCH(CTX, __func__, __VA_ARGS__)
 
 template <typename... Args>
-Value tiledDynDispatch(const std::string& fn_name, SPUContext* ctx,
-                       Args&&... args) {
-  auto impl = [fn_name](SPUContext* sh_ctx, Args&&... sh_args) {
-    return dynDispatch(sh_ctx, fn_name, std::forward<Args>(sh_args)...);
+Value tiledDynDispatch(KernelId id, SPUContext* ctx, Args&&... args) {
+  auto impl = [id](SPUContext* sh_ctx, Args&&... sh_args) {
+    return dynDispatch(sh_ctx, id, std::forward<Args>(sh_args)...);
   };
 
   return tiled(impl, ctx, std::forward<Args>(args)...);
 }
 
-#define TILED_DISPATCH(CTX, ...)                           \
-  {                                                        \
-    SPU_TRACE_MPC_LEAF(ctx, __VA_ARGS__);                  \
-    return tiledDynDispatch(__func__, (CTX), __VA_ARGS__); \
+#define TILED_DISPATCH(CTX, ...)                                  \
+  {                                                               \
+    static const KernelId kKernelId = internKernelName(__func__); \
+    SPU_TRACE_MPC_LEAF(ctx, __VA_ARGS__);                         \
+    return tiledDynDispatch(kKernelId, (CTX), __VA_ARGS__);       \
   }
 
 // TODO: now we handcode mark some of the functions as tiled dispatch according
@@ -424,9 +429,10 @@ Value ppa_sklansky(SPUContext* ctx, Value const& lhs, Value const& rhs,
 
 Value add_bb(SPUContext* ctx, const Value& x, const Value& y) {
   // TRY_DISPATCH
-  if (ctx->hasKernel(__func__)) {
+  static const KernelId kKernelId = internKernelName(__func__);
+  if (ctx->hasKernel(kKernelId)) {
     SPU_TRACE_MPC_LEAF(ctx, x, y);
-    return tiledDynDispatch(__func__, ctx, x, y);
+    return tiledDynDispatch(kKernelId, ctx, x, y);
   }
 
   // default implementation
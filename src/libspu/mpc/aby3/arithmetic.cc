@@ -591,20 +591,22 @@ NdArrayRef MulA1B::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
 ////////////////////////////////////////////////////////////////////
 // matmul family
 ////////////////////////////////////////////////////////////////////
-NdArrayRef MatMulAP::proc(KernelEvalContext*, const NdArrayRef& x,
+NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                           const NdArrayRef& y) const {
   const auto field = x.eltype().as<Ring2k>()->field();
+  const auto num_threads = getMmulNumThreads(ctx);
 
   NdArrayRef z(makeType<AShrTy>(field), {x.shape()[0], y.shape()[1]});
 
+  // the ring gemm packs its operands, the stride 2 share views cost nothing.
   auto x1 = getFirstShare(x);
   auto x2 = getSecondShare(x);
 
   auto z1 = getFirstShare(z);
   auto z2 = getSecondShare(z);
 
-  ring_mmul_(z1, x1, y);
-  ring_mmul_(z2, x2, y);
+  ring_mmul_(z1, x1, y, num_threads);
+  ring_mmul_(z2, x2, y, num_threads);
 
   return z;
 }
@@ -642,8 +644,9 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
     // z3 := x3*y3 + x3*y1 + x1*y3 + k3
 
     // x1*(y1+y2) + x2*y1 + k1
-    auto t2 = std::async(ring_mmul, x2, y1);
-    auto t0 = ring_mmul(x1, ring_add(y1, y2));  //
+    const auto num_threads = getMmulNumThreads(ctx);
+    auto t2 = std::async(ring_mmul, x2, y1, num_threads);
+    auto t0 = ring_mmul(x1, ring_add(y1, y2), num_threads);  //
     auto z1 = ring_sum({t0, t2.get(), r.get()});
 
     auto f = std::async([&] { ring_assign(o1, z1); });
@@ -144,6 +144,7 @@ NdArrayRef OramReadOA::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
                             const NdArrayRef &db, int64_t offset) const {
   auto *comm = ctx->getState<Communicator>();
   auto *prg = ctx->getState<PrgState>();
+  const auto num_threads = getMmulNumThreads(ctx);
 
   const auto field = db.eltype().as<AShrTy>()->field();
   int64_t index_times = db.shape()[1];
@@ -179,8 +180,8 @@ NdArrayRef OramReadOA::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
     auto onehot0 = getFirstShare(shifted_onehot);
     auto onehot1 = getSecondShare(shifted_onehot);
 
-    auto res0 = std::async(ring_mmul, onehot0, db0);
-    auto res1 = ring_mmul(onehot1, db1);
+    auto res0 = std::async(ring_mmul, onehot0, db0, num_threads);
+    auto res1 = ring_mmul(onehot1, db1, num_threads);
 
     auto o1 = getFirstShare(out);
     auto o2 = getSecondShare(out);
@@ -238,7 +239,7 @@ NdArrayRef OramReadOP::proc(KernelEvalContext *ctx, const NdArrayRef &onehot,
       }
 
       // [TODO]: accelerate matmul with GPU
-      out2pc = ring_mmul(shifted_onehot, db);
+      out2pc = ring_mmul(shifted_onehot, db, getMmulNumThreads(ctx));
     }
 
     ring_add_(out2pc, r.get());
@@ -99,8 +99,7 @@ void Ot3::send(const NdArrayRef& m0, const NdArrayRef& m1) {
   auto masked_m0 = ring_xor(m0, w0);
   auto masked_m1 = ring_xor(m1, w1);
 
-  comm_->sendAsync(roles_.receiver, masked_m0, "m0");
-  comm_->sendAsync(roles_.receiver, masked_m1, "m1");
+  comm_->sendAsync(roles_.receiver, {masked_m0, masked_m1}, "m0,m1");
 }
 
 NdArrayRef Ot3::recv(const std::vector<uint8_t>& choices) {
@@ -118,8 +117,10 @@ NdArrayRef Ot3::recv(const std::vector<uint8_t>& choices) {
   }
 
   // get masked messages from sender.
-  auto m0 = comm_->recv(roles_.sender, ty, "m0");
-  auto m1 = comm_->recv(roles_.sender, ty, "m1");
+  const Shape flat = {shape_.numel()};
+  auto ms = comm_->recv(roles_.sender, {ty, ty}, {flat, flat}, "m0,m1");
+  const auto& m0 = ms[0];
+  const auto& m1 = ms[1];
 
   auto mc = ring_select(choices, m0, m1);
   // get chosen masks
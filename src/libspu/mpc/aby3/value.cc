@@ -14,6 +14,7 @@
 
 #include "libspu/mpc/aby3/value.h"
 
+#include "libspu/core/parallel_utils.h"
 #include "libspu/core/prelude.h"
 #include "libspu/mpc/aby3/type.h"
 #include "libspu/mpc/utils/ring_ops.h"
@@ -75,11 +76,18 @@ NdArrayRef makeAShare(const NdArrayRef& s1, const NdArrayRef& s2,
   NdArrayRef res(ty, s1.shape());
 
   if (res.numel() != 0) {
-    auto res_s1 = getFirstShare(res);
-    auto res_s2 = getSecondShare(res);
-
-    ring_assign(res_s1, s1);
-    ring_assign(res_s2, s2);
+    DISPATCH_ALL_FIELDS(field, [&]() {
+      using shr_t = std::array<ring2k_t, 2>;
+      NdArrayView<shr_t> _res(res);
+      NdArrayView<ring2k_t> _s1(s1);
+      NdArrayView<ring2k_t> _s2(s2);
+
+      // one pass over the result, rather than one per share.
+      pforeach(0, res.numel(), [&](int64_t idx) {
+        _res[idx][0] = _s1[idx];
+        _res[idx][1] = _s2[idx];
+      });
+    });
   }
 
   return res;
@@ -0,0 +1,59 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/aby3/value.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/aby3/type.h"
+#include "libspu/mpc/utils/ring_ops.h"
+
+namespace spu::mpc::aby3 {
+
+TEST(ShareTest, MakeAShare) {
+  registerTypes();
+  const auto s0 = ring_rand(FM64, {6, 5});
+  const auto s1 = ring_rand(FM64, {6, 5});
+  const auto x = makeAShare(s0, s1, FM64);
+
+  EXPECT_EQ(x.eltype(), makeType<AShrTy>(FM64));
+  EXPECT_TRUE(ring_all_equal(getFirstShare(x), s0));
+  EXPECT_TRUE(ring_all_equal(getSecondShare(x), s1));
+
+  // strided shares, i.e. transposed ones.
+  const auto xt = makeAShare(s0.transpose(), s1.transpose(), FM64);
+  EXPECT_TRUE(ring_all_equal(getFirstShare(xt), s0.transpose()));
+  EXPECT_TRUE(ring_all_equal(getSecondShare(xt), s1.transpose()));
+  EXPECT_TRUE(ring_all_equal(getSecondShare(x.transpose()), s1.transpose()));
+}
+
+TEST(ShareTest, BShareViews) {
+  registerTypes();
+  const auto ty = makeType<BShrTy>(PT_U16, 12);
+  NdArrayRef x(ty, {100});
+  NdArrayView<std::array<uint16_t, 2>> _x(x);
+  for (int64_t idx = 0; idx < x.numel(); ++idx) {
+    _x[idx][0] = static_cast<uint16_t>(idx);
+    _x[idx][1] = static_cast<uint16_t>(3 * idx + 1);
+  }
+
+  NdArrayView<uint16_t> _x0(getFirstShare(x));
+  NdArrayView<uint16_t> _x1(getSecondShare(x));
+  for (int64_t idx = 0; idx < x.numel(); ++idx) {
+    EXPECT_EQ(_x0[idx], static_cast<uint16_t>(idx));
+    EXPECT_EQ(_x1[idx], static_cast<uint16_t>(3 * idx + 1));
+  }
+}
+
+}  // namespace spu::mpc::aby3
@@ -123,19 +123,25 @@ Value SvpUnaryDisp(SPUContext* ctx, const Value& x, Args&&... args) {
 }  // namespace
 
 // TODO: Unify these macros.
-#define FORCE_NAMED_DISPATCH(CTX, NAME, ...)      \
-  {                                               \
-    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);         \
-    return dynDispatch((CTX), NAME, __VA_ARGS__); \
+// Kernel ids are interned once per call site, so dispatch does not look up
+// kernels by name.
+#define FORCE_NAMED_DISPATCH(CTX, NAME, ...)                  \
+  {                                                           \
+    static const KernelId kKernelId = internKernelName(NAME); \
+    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);                     \
+    return dynDispatch((CTX), kKernelId, __VA_ARGS__);        \
   }
 
 #define FORCE_DISPATCH(CTX, ...) \
   FORCE_NAMED_DISPATCH(CTX, __func__, __VA_ARGS__)
 
-#define TRY_NAMED_DISPATCH(CTX, FNAME, ...)        \
-  if ((CTX)->hasKernel(FNAME)) {                   \
-    SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);          \
-    return dynDispatch((CTX), FNAME, __VA_ARGS__); \
+#define TRY_NAMED_DISPATCH(CTX, FNAME, ...)                    \
+  {                                                            \
+    static const KernelId kKernelId = internKernelName(FNAME); \
+    if ((CTX)->hasKernel(kKernelId)) {                         \
+      SPU_TRACE_MPC_LEAF(CTX, __VA_ARGS__);                    \
+      return dynDispatch((CTX), kKernelId, __VA_ARGS__);       \
+    }                                                          \
   }
 
 #define TRY_DISPATCH(CTX, ...) TRY_NAMED_DISPATCH(CTX, __func__, __VA_ARGS__)
@@ -35,6 +35,7 @@
 #include "yacl/utils/elapsed_timer.h"
 
 #include "libspu/mpc/cheetah/arith/common.h"
+#include "libspu/mpc/cheetah/arith/mat_encode_cache.h"
 #include "libspu/mpc/cheetah/arith/matmat_prot.h"
 #include "libspu/mpc/cheetah/rlwe/lwe_ct.h"
 #include "libspu/mpc/cheetah/rlwe/modswitch_helper.h"
@@ -50,6 +51,9 @@ enum class CipherPackingType {
   none,
 };
 
+// packing time of the calling thread, see CheetahDot::ThreadPackingTime
+static thread_local std::chrono::nanoseconds tls_packing_time{0};
+
 static std::string ToString(CipherPackingType type) {
   switch (type) {
     case CipherPackingType::rlwes:
@@ -68,8 +72,10 @@ struct CheetahDot::Impl : public EnableCPRNG {
   static constexpr size_t kCtAsyncParallel = 16;
 
   explicit Impl(std::shared_ptr<yacl::link::Context> lctx,
-                bool disable_matmul_pack)
-      : lctx_(std::move(lctx)), disable_pack_(disable_matmul_pack) {}
+                bool disable_matmul_pack, size_t encode_cache_budget)
+      : lctx_(std::move(lctx)),
+        disable_pack_(disable_matmul_pack),
+        encode_cache_(encode_cache_budget) {}
 
   ~Impl() = default;
 
@@ -153,6 +159,8 @@ struct CheetahDot::Impl : public EnableCPRNG {
 
   void LazyInit(size_t field_bitlen, bool need_galois_key = false);
 
+  MatEncodeCache *encode_cache() { return &encode_cache_; }
+
   void LazyInitGaloisKey(size_t field_bitlen);
 
   // Enc(Delta*m) -> Enc(Delta*m - r), r where r is sampled from Rq
@@ -212,6 +220,9 @@ struct CheetahDot::Impl : public EnableCPRNG {
   // ModulusSwitchHelper for decoding
   std::unordered_map<size_t, std::shared_ptr<ModulusSwitchHelper>> dcd_mswh_;
   std::unordered_map<size_t, std::shared_ptr<seal::Decryptor>> decryptors_;
+
+  // encoded polynomials of the operands marked as reusable
+  MatEncodeCache encode_cache_;
 };
 
 void CheetahDot::Impl::LazyInitGaloisKey(size_t field_bitlen) {
@@ -348,26 +359,44 @@ void CheetahDot::Impl::doDotOLEReceiverRecvStep(const NdArrayRef &prv_mat,
     }
   });
 
-  // 2. encode the matrix for multiplication
-  std::vector<RLWEPt> plain_mat(is_self_lhs ? lhs_n : rhs_n);
-  if (is_self_lhs) {
-    matmat_prot.EncodeLHS(prv_mat, meta, false, absl::MakeSpan(plain_mat));
-  } else {
-    matmat_prot.EncodeRHS(prv_mat, meta, false, absl::MakeSpan(plain_mat));
+  // 2. encode the matrix for multiplication, or take the NTT-form
+  // polynomials of a reusable operand from the cache.
+  const bool cacheable = encode_cache_.IsEnabled(prv_mat);
+  const auto cache_tag =
+      fmt::format("ntt:{}:{}:{}:{}", fmt::join(dim3, "x"), is_self_lhs,
+                  static_cast<int>(cptype), field_bitlen);
+  std::shared_ptr<const MatEncodeCache::Polys> plain_mat;
+  if (cacheable) {
+    plain_mat = encode_cache_.Get(prv_mat, cache_tag);
   }
 
-  yacl::parallel_for(0, plain_mat.size(), [&](size_t bgn, size_t end) {
-    for (size_t i = bgn; i < end; ++i) {
-      NttInplace(plain_mat[i], this_context);
+  if (plain_mat == nullptr) {
+    auto encoded = std::make_shared<MatEncodeCache::Polys>(is_self_lhs ? lhs_n
+                                                                       : rhs_n);
+    if (is_self_lhs) {
+      matmat_prot.EncodeLHS(prv_mat, meta, false, absl::MakeSpan(*encoded));
+    } else {
+      matmat_prot.EncodeRHS(prv_mat, meta, false, absl::MakeSpan(*encoded));
     }
-  });
+
+    yacl::parallel_for(0, encoded->size(), [&](size_t bgn, size_t end) {
+      for (size_t i = bgn; i < end; ++i) {
+        NttInplace((*encoded)[i], this_context);
+      }
+    });
+
+    plain_mat = std::move(encoded);
+    if (cacheable) {
+      encode_cache_.Put(prv_mat, cache_tag, plain_mat);
+    }
+  }
   io_task.get();
 
   // 3. HE multiplications
   if (is_self_lhs) {
-    matmat_prot.Compute(plain_mat, enc_mat, meta, result_cts);
+    matmat_prot.Compute(*plain_mat, enc_mat, meta, result_cts);
   } else {
-    matmat_prot.Compute(enc_mat, plain_mat, meta, result_cts);
+    matmat_prot.Compute(enc_mat, *plain_mat, meta, result_cts);
   }
 }
 
@@ -405,15 +434,9 @@ NdArrayRef CheetahDot::Impl::doDotOLEReceiverSendStep(
     PackingHelper pack_helper(gap, this_ecd_msh.coeff_modulus_size(),
                               this_galois_key, this_context);
 
-    for (size_t i = 0; i < out_n; i += pack_stride) {
-      size_t this_batch = std::min(out_n - i, pack_stride);
-      size_t packed_idx = i / pack_stride;
-      pack_helper.PackingWithModulusDrop(
-          ct_array_to_pack.subspan(i, this_batch),
-          ct_array_to_pack[packed_idx]);
-    }
-
     num_ct_response = CeilDiv(out_n, pack_stride);
+    pack_helper.BatchPackingWithModulusDrop(
+        ct_array_to_pack, ct_array_to_pack.subspan(0, num_ct_response));
   } else {
     // Chen Hao et al's PackLWEs
     SPU_ENFORCE(batch_size == 1, "not implemented yet");
@@ -454,6 +477,8 @@ NdArrayRef CheetahDot::Impl::doDotOLEReceiverSendStep(
     }
   }
   double pack_time = pack_timer.CountMs();
+  tls_packing_time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double, std::milli>(pack_time));
 
   // 4. Random masking to conver HE to AShr
   std::vector<RLWEPt> rnd_polys(num_ct_response);
@@ -518,13 +543,32 @@ void CheetahDot::Impl::doDotOLESenderSendStep(const NdArrayRef &prv_mat,
   const size_t lhs_n = matmat_prot.GetLeftSize(meta, subshape);
   const size_t rhs_n = matmat_prot.GetRightSize(meta, subshape);
 
-  std::vector<RLWEPt> _encoded_mat(is_self_lhs ? lhs_n : rhs_n);
-  auto encoded_mat = absl::MakeSpan(_encoded_mat);
-  if (is_self_lhs) {
-    matmat_prot.EncodeLHS(prv_mat, meta, true, encoded_mat);
-  } else {
-    matmat_prot.EncodeRHS(prv_mat, meta, true, encoded_mat);
+  // NOTE: only the encoding of a reusable operand is cached. The ciphertexts
+  // are always fresh.
+  const bool cacheable = encode_cache_.IsEnabled(prv_mat);
+  const auto cache_tag =
+      fmt::format("enc:{}:{}:{}:{}", fmt::join(dim3, "x"), is_self_lhs,
+                  static_cast<int>(cptype), field_bitlen);
+  std::shared_ptr<const MatEncodeCache::Polys> cached_mat;
+  if (cacheable) {
+    cached_mat = encode_cache_.Get(prv_mat, cache_tag);
+  }
+
+  if (cached_mat == nullptr) {
+    auto encoded = std::make_shared<MatEncodeCache::Polys>(is_self_lhs ? lhs_n
+                                                                       : rhs_n);
+    if (is_self_lhs) {
+      matmat_prot.EncodeLHS(prv_mat, meta, true, absl::MakeSpan(*encoded));
+    } else {
+      matmat_prot.EncodeRHS(prv_mat, meta, true, absl::MakeSpan(*encoded));
+    }
+
+    cached_mat = std::move(encoded);
+    if (cacheable) {
+      encode_cache_.Put(prv_mat, cache_tag, cached_mat);
+    }
   }
+  auto encoded_mat = absl::MakeConstSpan(*cached_mat);
 
   size_t num_ct_to_send = encoded_mat.size();
   for (size_t i = 0; i < num_ct_to_send; i += kCtAsyncParallel) {
@@ -826,8 +870,9 @@ NdArrayRef CheetahDot::Impl::doDotOLE(const NdArrayRef &prv_mat,
 //////////////////////////////////////////////
 
 CheetahDot::CheetahDot(const std::shared_ptr<yacl::link::Context> &lctx,
-                       bool disable_matmul_pack) {
-  impl_ = std::make_unique<Impl>(lctx, disable_matmul_pack);
+                       bool disable_matmul_pack, size_t encode_cache_budget) {
+  impl_ =
+      std::make_unique<Impl>(lctx, disable_matmul_pack, encode_cache_budget);
 }
 
 CheetahDot::~CheetahDot() = default;
@@ -851,6 +896,15 @@ NdArrayRef CheetahDot::DotOLE(const NdArrayRef &inp, const Shape3D &dim3,
   return impl_->DotOLE(inp, nullptr, dim3, is_self_lhs);
 }
 
+std::chrono::nanoseconds CheetahDot::ThreadPackingTime() {
+  return tls_packing_time;
+}
+
+MatEncodeCache *CheetahDot::EncodeCache() {
+  SPU_ENFORCE(impl_ != nullptr);
+  return impl_->encode_cache();
+}
+
 NdArrayRef CheetahDot::BatchDotOLE(const NdArrayRef &inp,
                                    yacl::link::Context *conn,
                                    const Shape4D &dim4, bool is_self_lhs) {
@@ -14,12 +14,14 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "yacl/link/context.h"
 
 #include "libspu/core/ndarray_ref.h"
 #include "libspu/mpc/cheetah/arith/common.h"
+#include "libspu/mpc/cheetah/arith/mat_encode_cache.h"
 
 namespace spu::mpc::cheetah {
 
@@ -32,8 +34,11 @@ namespace spu::mpc::cheetah {
 //  https://eprint.iacr.org/2023/1678
 class CheetahDot {
  public:
+  // `encode_cache_budget` bounds the bytes of encoded polynomials kept for
+  // operands marked by EncodeCache()->Enable, zero disables the cache.
   explicit CheetahDot(const std::shared_ptr<yacl::link::Context>& lctx,
-                      bool disable_matmul_pack = false);
+                      bool disable_matmul_pack = false,
+                      size_t encode_cache_budget = 0);
 
   ~CheetahDot();
 
@@ -59,6 +64,12 @@ class CheetahDot {
   NdArrayRef BatchDotOLE(const NdArrayRef& inp, yacl::link::Context* conn,
                          const Shape4D& dim4, bool is_self_lhs);
 
+  MatEncodeCache* EncodeCache();
+
+  // Accumulated time that the calling thread spent on packing the HE results,
+  // for profiling.
+  static std::chrono::nanoseconds ThreadPackingTime();
+
  private:
   struct Impl;
 
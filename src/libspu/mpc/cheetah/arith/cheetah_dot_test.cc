@@ -135,4 +135,48 @@ TEST_P(CheetahDotTest, BatchDot) {
   });
 }
 
+TEST(CheetahDotCacheTest, ReuseWeight) {
+  size_t kWorldSize = 2;
+  auto field = FieldType::FM64;
+  const Shape3D dim3 = {18, 8, 41};
+  auto weight = ring_rand(field, {dim3[1], dim3[2]});
+
+  std::vector<NdArrayRef> inputs(3);
+  for (auto &inp : inputs) {
+    inp = ring_rand(field, {dim3[0], dim3[1]});
+  }
+
+  std::vector<std::vector<NdArrayRef>> result(kWorldSize);
+  std::vector<size_t> num_entries(kWorldSize);
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    int rank = lctx->Rank();
+    auto dot = std::make_shared<CheetahDot>(lctx, false, 64 << 20);
+    if (rank == 1) {
+      dot->EncodeCache()->Enable(weight);
+    }
+    for (const auto &inp : inputs) {
+      result[rank].push_back(
+          dot->DotOLE(rank == 0 ? inp : weight, dim3, rank == 0));
+    }
+    num_entries[rank] = dot->EncodeCache()->NumEntries();
+  });
+
+  EXPECT_EQ(num_entries[0], 0U);
+  EXPECT_EQ(num_entries[1], 1U);
+
+  const int64_t kMaxDiff = 1;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto expected = ring_mmul(inputs[i], weight);
+    auto computed = ring_add(result[0][i], result[1][i]);
+    DISPATCH_ALL_FIELDS(field, [&]() {
+      auto e = NdArrayView<ring2k_t>(expected);
+      auto c = NdArrayView<ring2k_t>(computed);
+
+      for (auto idx = 0; idx < expected.numel(); idx++) {
+        EXPECT_NEAR(e[idx], c[idx], kMaxDiff);
+      }
+    });
+  }
+}
+
 }  // namespace spu::mpc::cheetah
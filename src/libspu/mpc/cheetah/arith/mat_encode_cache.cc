@@ -0,0 +1,161 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/cheetah/arith/mat_encode_cache.h"
+
+#include "fmt/format.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::cheetah {
+
+namespace {
+
+size_t PolysSize(const MatEncodeCache::Polys& polys) {
+  size_t size = 0;
+  for (const auto& pt : polys) {
+    size += pt.coeff_count() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+// Compares the control blocks, which the weak pointer keeps alive, so a new
+// buffer at the address of a released one never matches.
+bool IsOwner(const std::weak_ptr<yacl::Buffer>& owner,
+             const std::shared_ptr<yacl::Buffer>& buf) {
+  return !owner.expired() && !owner.owner_before(buf) &&
+         !buf.owner_before(owner);
+}
+
+}  // namespace
+
+std::string MatEncodeCache::MakeKey(const NdArrayRef& x,
+                                    const std::string& tag) {
+  return fmt::format("{}:{}:{}:{}", fmt::ptr(x.data()), x.shape(),
+                     x.strides(), tag);
+}
+
+void MatEncodeCache::Enable(const NdArrayRef& x) {
+  if (memory_budget_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (FindMarked(x) == buffers_.end()) {
+    buffers_.emplace(x.buf()->data(), MarkedBuffer{x.buf(), {}});
+  }
+}
+
+void MatEncodeCache::Disable(const NdArrayRef& x) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = FindMarked(x);
+  if (it != buffers_.end()) {
+    EraseMarked(it);
+  }
+}
+
+bool MatEncodeCache::IsEnabled(const NdArrayRef& x) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.find(x.buf()->data());
+  return it != buffers_.end() && IsOwner(it->second.owner, x.buf());
+}
+
+std::shared_ptr<const MatEncodeCache::Polys> MatEncodeCache::Get(
+    const NdArrayRef& x, const std::string& tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (FindMarked(x) == buffers_.end()) {
+    return nullptr;
+  }
+  auto it = entries_.find(MakeKey(x, tag));
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  return it->second.polys;
+}
+
+void MatEncodeCache::Put(const NdArrayRef& x, const std::string& tag,
+                         std::shared_ptr<const Polys> polys) {
+  SPU_ENFORCE(polys != nullptr);
+  const size_t size = PolysSize(*polys);
+  if (size > memory_budget_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto buf = FindMarked(x);
+  if (buf == buffers_.end()) {
+    return;
+  }
+  auto key = MakeKey(x, tag);
+  if (entries_.count(key) > 0) {
+    // a concurrent call has cached it already.
+    return;
+  }
+
+  while (memory_usage_ + size > memory_budget_) {
+    SPU_ENFORCE(!lru_.empty());
+    std::string victim = lru_.back();
+    EraseEntry(victim);
+  }
+
+  lru_.push_front(key);
+  entries_.emplace(key,
+                   Entry{buf->first, size, std::move(polys), lru_.begin()});
+  buf->second.keys.insert(std::move(key));
+  memory_usage_ += size;
+}
+
+std::unordered_map<const void*, MatEncodeCache::MarkedBuffer>::iterator
+MatEncodeCache::FindMarked(const NdArrayRef& x) {
+  auto it = buffers_.find(x.buf()->data());
+  if (it == buffers_.end() || IsOwner(it->second.owner, x.buf())) {
+    return it;
+  }
+  // the marked buffer was released without Disable.
+  EraseMarked(it);
+  return buffers_.end();
+}
+
+void MatEncodeCache::EraseEntry(const std::string& key) {
+  auto it = entries_.find(key);
+  SPU_ENFORCE(it != entries_.end());
+  buffers_.at(it->second.buffer).keys.erase(key);
+  memory_usage_ -= it->second.size;
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+}
+
+void MatEncodeCache::EraseMarked(
+    std::unordered_map<const void*, MarkedBuffer>::iterator it) {
+  for (const auto& key : it->second.keys) {
+    auto entry = entries_.find(key);
+    SPU_ENFORCE(entry != entries_.end());
+    memory_usage_ -= entry->second.size;
+    lru_.erase(entry->second.lru_pos);
+    entries_.erase(entry);
+  }
+  buffers_.erase(it);
+}
+
+size_t MatEncodeCache::MemoryUsage() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return memory_usage_;
+}
+
+size_t MatEncodeCache::NumEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace spu::mpc::cheetah
@@ -0,0 +1,113 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "libspu/core/ndarray_ref.h"
+#include "libspu/mpc/cheetah/rlwe/types.h"
+
+namespace spu::mpc::cheetah {
+
+// Keeps the encoded polynomials of matmul operands that are marked as
+// reusable, e.g. the fixed weights of a model, so that repeated DotOLE calls
+// on them skip the encoding (and the NTT).
+//
+// Like semi2k::BeaverCache, operands are tracked by the address of their
+// underlying buffer, and views of a marked buffer are told apart by their
+// offset, shape and strides. A marked buffer MUST NOT be modified until it is
+// unmarked by Disable. The mark also remembers which buffer it was set on, a
+// buffer released while marked leaves its entries unreachable, even when its
+// memory is handed out again (e.g. by the BufferPool), and they are dropped on
+// the next access to that address.
+//
+// Entries are evicted in least recently used order once the total size of
+// the cached polynomials exceeds `memory_budget`. A zero budget disables the
+// cache.
+class MatEncodeCache {
+ public:
+  using Polys = std::vector<RLWEPt>;
+
+  explicit MatEncodeCache(size_t memory_budget)
+      : memory_budget_(memory_budget) {}
+
+  MatEncodeCache(const MatEncodeCache&) = delete;
+  MatEncodeCache& operator=(const MatEncodeCache&) = delete;
+
+  void Enable(const NdArrayRef& x);
+
+  // Unmarks the buffer of `x` and drops all its entries.
+  void Disable(const NdArrayRef& x);
+
+  bool IsEnabled(const NdArrayRef& x) const;
+
+  // `tag` describes how the view was encoded, e.g. the matmul dims and the
+  // side of the operand. Returns nullptr on miss.
+  std::shared_ptr<const Polys> Get(const NdArrayRef& x,
+                                   const std::string& tag);
+
+  // No-op if the buffer of `x` is not marked or the polys alone exceed the
+  // budget.
+  void Put(const NdArrayRef& x, const std::string& tag,
+           std::shared_ptr<const Polys> polys);
+
+  size_t MemoryUsage() const;
+
+  size_t NumEntries() const;
+
+ private:
+  struct MarkedBuffer {
+    // identifies the marked buffer beyond its address.
+    std::weak_ptr<yacl::Buffer> owner;
+    std::unordered_set<std::string> keys;
+  };
+
+  struct Entry {
+    const void* buffer = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const Polys> polys;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  static std::string MakeKey(const NdArrayRef& x, const std::string& tag);
+
+  // Returns the mark of the buffer of `x`, end() if there is none. A mark left
+  // by a released buffer at the same address is dropped with its entries.
+  std::unordered_map<const void*, MarkedBuffer>::iterator FindMarked(
+      const NdArrayRef& x);
+
+  void EraseEntry(const std::string& key);
+
+  // Drops the mark and all its entries.
+  void EraseMarked(std::unordered_map<const void*, MarkedBuffer>::iterator it);
+
+  const size_t memory_budget_;
+
+  mutable std::mutex mutex_;
+  // address of a marked buffer -> its mark
+  std::unordered_map<const void*, MarkedBuffer> buffers_;
+  std::unordered_map<std::string, Entry> entries_;
+  // most recently used first.
+  std::list<std::string> lru_;
+  size_t memory_usage_ = 0;
+};
+
+}  // namespace spu::mpc::cheetah
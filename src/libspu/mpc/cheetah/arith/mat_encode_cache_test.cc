@@ -0,0 +1,126 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/cheetah/arith/mat_encode_cache.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/utils/ring_ops.h"
+
+namespace spu::mpc::cheetah {
+
+namespace {
+
+// `n` polynomials of 1KiB each.
+std::shared_ptr<const MatEncodeCache::Polys> MakePolys(size_t n) {
+  return std::make_shared<MatEncodeCache::Polys>(n, RLWEPt(128));
+}
+
+}  // namespace
+
+TEST(MatEncodeCacheTest, Views) {
+  MatEncodeCache cache(1 << 20);
+  auto x = ring_rand(FieldType::FM64, {8, 8});
+  auto y = ring_rand(FieldType::FM64, {8, 8});
+
+  // not marked
+  cache.Put(x, "a", MakePolys(1));
+  EXPECT_EQ(cache.NumEntries(), 0U);
+
+  cache.Enable(x);
+  EXPECT_TRUE(cache.IsEnabled(x));
+  EXPECT_FALSE(cache.IsEnabled(y));
+
+  auto row = x.slice({1, 0}, {2, 8}, {1, 1});
+  EXPECT_TRUE(cache.IsEnabled(row));
+
+  cache.Put(x, "a", MakePolys(2));
+  cache.Put(row, "a", MakePolys(1));
+  EXPECT_EQ(cache.NumEntries(), 2U);
+  EXPECT_EQ(cache.MemoryUsage(), 3 * 1024U);
+
+  EXPECT_EQ(cache.Get(x, "a")->size(), 2U);
+  EXPECT_EQ(cache.Get(row, "a")->size(), 1U);
+  EXPECT_EQ(cache.Get(x, "b"), nullptr);
+  EXPECT_EQ(cache.Get(x.transpose(), "a"), nullptr);
+
+  cache.Disable(row);
+  EXPECT_FALSE(cache.IsEnabled(x));
+  EXPECT_EQ(cache.NumEntries(), 0U);
+  EXPECT_EQ(cache.MemoryUsage(), 0U);
+}
+
+TEST(MatEncodeCacheTest, Evict) {
+  MatEncodeCache cache(4 * 1024);
+  auto x = ring_rand(FieldType::FM64, {8, 8});
+  cache.Enable(x);
+
+  // larger than the budget
+  cache.Put(x, "big", MakePolys(5));
+  EXPECT_EQ(cache.NumEntries(), 0U);
+
+  cache.Put(x, "a", MakePolys(2));
+  cache.Put(x, "b", MakePolys(2));
+  auto held = cache.Get(x, "b");
+  // touch a so that b is the least recently used
+  ASSERT_NE(cache.Get(x, "a"), nullptr);
+
+  cache.Put(x, "c", MakePolys(1));
+  EXPECT_NE(cache.Get(x, "a"), nullptr);
+  EXPECT_EQ(cache.Get(x, "b"), nullptr);
+  EXPECT_NE(cache.Get(x, "c"), nullptr);
+  EXPECT_EQ(cache.MemoryUsage(), 3 * 1024U);
+  // evicted entries stay valid for the holders.
+  EXPECT_EQ(held->size(), 2U);
+}
+
+TEST(MatEncodeCacheTest, ReusedAddress) {
+  MatEncodeCache cache(1 << 20);
+  const auto ty = makeType<RingTy>(FieldType::FM64);
+  // two buffers on the same memory, as when a pool hands it out again.
+  std::vector<uint64_t> memory(64);
+  auto wrap = [&] {
+    auto buf = std::make_shared<yacl::Buffer>(
+        memory.data(), memory.size() * sizeof(uint64_t), [](void*) {});
+    return NdArrayRef(buf, ty, {8, 8});
+  };
+
+  {
+    auto x = wrap();
+    cache.Enable(x);
+    cache.Put(x, "a", MakePolys(1));
+    EXPECT_NE(cache.Get(x, "a"), nullptr);
+  }
+
+  // released without Disable
+  auto y = wrap();
+  EXPECT_FALSE(cache.IsEnabled(y));
+  EXPECT_EQ(cache.Get(y, "a"), nullptr);
+  EXPECT_EQ(cache.NumEntries(), 0U);
+  EXPECT_EQ(cache.MemoryUsage(), 0U);
+
+  cache.Enable(y);
+  EXPECT_EQ(cache.Get(y, "a"), nullptr);
+  cache.Put(y, "a", MakePolys(2));
+  EXPECT_EQ(cache.Get(y, "a")->size(), 2U);
+}
+
+TEST(MatEncodeCacheTest, ZeroBudget) {
+  MatEncodeCache cache(0);
+  auto x = ring_rand(FieldType::FM64, {8, 8});
+  cache.Enable(x);
+  EXPECT_FALSE(cache.IsEnabled(x));
+}
+
+}  // namespace spu::mpc::cheetah
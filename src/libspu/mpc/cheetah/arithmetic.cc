@@ -396,6 +396,28 @@ NdArrayRef MulAA::mulDirectly(KernelEvalContext* ctx, const NdArrayRef& x,
 }
 #endif
 
+namespace {
+
+// Adds the time spent on packing the HE matmul results to the profile, as a
+// nested action of the running matmul kernel ending at `end`. Threads packing
+// concurrently record one action each.
+void RecordPackingTime(KernelEvalContext* ctx, std::chrono::nanoseconds elapsed,
+                       std::chrono::high_resolution_clock::time_point end =
+                           std::chrono::high_resolution_clock::now()) {
+  if (elapsed.count() == 0) {
+    return;
+  }
+  const auto& tracer = GET_TRACER(ctx);
+  if ((tracer->getFlag() & TR_REC) == 0) {
+    return;
+  }
+  tracer->getProfState()->addRecord(ActionRecord{
+      spu::internal::genActionUuid(), "cheetah_pack", "",
+      TR_MPC | TR_REC | TR_NESTED, end - elapsed, end, 0, 0, 0, 0, 0, 0, 0, 0});
+}
+
+}  // namespace
+
 NdArrayRef MatMulVVS::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                            const NdArrayRef& y) const {
   auto out_type = makeType<cheetah::AShrTy>(ctx->sctx()->getField());
@@ -409,11 +431,15 @@ NdArrayRef MatMulVVS::proc(KernelEvalContext* ctx, const NdArrayRef& x,
   auto lhs_owner = x.eltype().as<Priv2kTy>()->owner();
 
   const Shape3D dim3 = {x.shape()[0], x.shape()[1], y.shape()[1]};
+  auto pack_time = CheetahDot::ThreadPackingTime();
+  NdArrayRef out;
   if (self_rank == lhs_owner) {
-    return dot_prot->DotOLE(x, dim3, /*is_lhs*/ true).as(out_type);
+    out = dot_prot->DotOLE(x, dim3, /*is_lhs*/ true);
   } else {
-    return dot_prot->DotOLE(y, dim3, /*is_lhs*/ false).as(out_type);
+    out = dot_prot->DotOLE(y, dim3, /*is_lhs*/ false);
   }
+  RecordPackingTime(ctx, CheetahDot::ThreadPackingTime() - pack_time);
+  return out.as(out_type);
 }
 
 // A is (M, K); B is (K, N)
@@ -435,25 +461,37 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
 
   auto* conn = comm->lctx().get();
   auto dupx = ctx->getState<CheetahMulState>()->duplx();
+  std::chrono::nanoseconds task_pack_time{0};
+  std::chrono::high_resolution_clock::time_point task_end;
   std::future<NdArrayRef> task = std::async(std::launch::async, [&] {
+    auto pack_time = CheetahDot::ThreadPackingTime();
     // Compute x0*y1
+    NdArrayRef x0y1;
     if (rank == 0) {
-      return dot_prot->DotOLE(x, dupx.get(), dim3, true);
+      x0y1 = dot_prot->DotOLE(x, dupx.get(), dim3, true);
     } else {
-      return dot_prot->DotOLE(y, dupx.get(), dim3, false);
+      x0y1 = dot_prot->DotOLE(y, dupx.get(), dim3, false);
     }
+    task_pack_time = CheetahDot::ThreadPackingTime() - pack_time;
+    task_end = std::chrono::high_resolution_clock::now();
+    return x0y1;
   });
 
+  auto pack_time = CheetahDot::ThreadPackingTime();
   NdArrayRef x1y0;
   if (rank == 0) {
     x1y0 = dot_prot->DotOLE(y, conn, dim3, false);
   } else {
     x1y0 = dot_prot->DotOLE(x, conn, dim3, true);
   }
+  RecordPackingTime(ctx, CheetahDot::ThreadPackingTime() - pack_time);
 
-  auto ret = ring_mmul(x, y);
+  auto ret = ring_mmul(x, y, getMmulNumThreads(ctx));
   ring_add_(ret, x1y0);
-  return ring_add(ret, task.get()).as(x.eltype());
+  ring_add_(ret, task.get());
+  // the task packs at the same time, its span overlaps the one above.
+  RecordPackingTime(ctx, task_pack_time, task_end);
+  return ret.as(x.eltype());
 }
 
 NdArrayRef MatMulAV::proc(KernelEvalContext* ctx, const NdArrayRef& x,
@@ -471,16 +509,39 @@ NdArrayRef MatMulAV::proc(KernelEvalContext* ctx, const NdArrayRef& x,
   const int owner = ptype->owner();
   NdArrayRef out;
   const Shape3D dim3 = {x.shape()[0], x.shape()[1], y.shape()[1]};
+  auto pack_time = CheetahDot::ThreadPackingTime();
   // (x0 + x1)*y = <x0 * y>_0 + <x0 * y>_1 + x1 * y
   if (rank == owner) {
     // Compute <y * x0>
     out = dot_prot->DotOLE(y, dim3, false);
-    auto local = ring_mmul(x, y);
+    auto local = ring_mmul(x, y, getMmulNumThreads(ctx));
     ring_add_(out, local);
   } else {
     out = dot_prot->DotOLE(x, dim3, true);
   }
+  RecordPackingTime(ctx, CheetahDot::ThreadPackingTime() - pack_time);
   return out.as(x.eltype());
 }
 
+void EncodeCacheKernel::evaluate(KernelEvalContext* ctx) const {
+  const auto& v = ctx->getParam<Value>(0);
+  const auto& enable_cache = ctx->getParam<bool>(1);
+
+  auto* encode_cache = ctx->getState<CheetahDotState>()->get()->EncodeCache();
+
+  if (enable_cache) {
+    encode_cache->Enable(v.data());
+    if (v.isComplex()) {
+      encode_cache->Enable(v.imag().value());
+    }
+  } else {
+    encode_cache->Disable(v.data());
+    if (v.isComplex()) {
+      encode_cache->Disable(v.imag().value());
+    }
+  }
+  // dummy output
+  ctx->pushOutput(Value());
+}
+
 }  // namespace spu::mpc::cheetah
@@ -221,6 +221,16 @@ class MatMulAA : public MatmulKernel {
                   const NdArrayRef& y) const override;
 };
 
+// Marks a share as a reusable matmul operand, so that CheetahDot keeps its
+// encoded polynomials. It shares the name with the semi2k beaver cache kernel
+// to serve the same cache intrinsics.
+class EncodeCacheKernel : public Kernel {
+ public:
+  static constexpr const char* kBindName() { return "beaver_cache"; }
+
+  void evaluate(KernelEvalContext* ctx) const override;
+};
+
 class Conv2DAA : public Conv2DKernel {
  public:
   static constexpr const char* kBindName() { return "conv2d_aa"; }
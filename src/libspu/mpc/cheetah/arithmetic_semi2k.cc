@@ -132,9 +132,9 @@ NdArrayRef MulAP::proc(KernelEvalContext*, const NdArrayRef& lhs,
   return ring_mul(lhs, rhs).as(lhs.eltype());
 }
 
-NdArrayRef MatMulAP::proc(KernelEvalContext*, const NdArrayRef& x,
+NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                           const NdArrayRef& y) const {
-  return ring_mmul(x, y).as(x.eltype());
+  return ring_mmul(x, y, getMmulNumThreads(ctx)).as(x.eltype());
 }
 
 NdArrayRef LShiftA::proc(KernelEvalContext*, const NdArrayRef& in,
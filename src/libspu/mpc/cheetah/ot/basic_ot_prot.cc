@@ -26,7 +26,7 @@
 namespace spu::mpc::cheetah {
 
 BasicOTProtocols::BasicOTProtocols(std::shared_ptr<Communicator> conn,
-                                   CheetahOtKind kind)
+                                   CheetahOtKind kind, bool enable_prefetch)
     : conn_(std::move(conn)) {
   SPU_ENFORCE(conn_ != nullptr);
 
@@ -43,11 +43,15 @@ BasicOTProtocols::BasicOTProtocols(std::shared_ptr<Communicator> conn,
     using Ot = YaclFerretOt;
     bool use_ss = (kind == CheetahOtKind::YACL_Softspoken);
     if (conn_->getRank() == 0) {
-      ferret_sender_ = std::make_shared<Ot>(conn_, true, use_ss);
-      ferret_receiver_ = std::make_shared<Ot>(conn_, false, use_ss);
+      ferret_sender_ =
+          std::make_shared<Ot>(conn_, true, use_ss, enable_prefetch);
+      ferret_receiver_ =
+          std::make_shared<Ot>(conn_, false, use_ss, enable_prefetch);
     } else {
-      ferret_receiver_ = std::make_shared<Ot>(conn_, false, use_ss);
-      ferret_sender_ = std::make_shared<Ot>(conn_, true, use_ss);
+      ferret_receiver_ =
+          std::make_shared<Ot>(conn_, false, use_ss, enable_prefetch);
+      ferret_sender_ =
+          std::make_shared<Ot>(conn_, true, use_ss, enable_prefetch);
     }
   }
 }
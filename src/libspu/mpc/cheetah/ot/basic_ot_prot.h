@@ -23,8 +23,10 @@ namespace spu::mpc::cheetah {
 
 class BasicOTProtocols {
  public:
+  // `enable_prefetch` expands Ferret OTs in background, see
+  // YaclFerretOTeAdapter.
   explicit BasicOTProtocols(std::shared_ptr<Communicator> conn,
-                            CheetahOtKind kind);
+                            CheetahOtKind kind, bool enable_prefetch = false);
 
   ~BasicOTProtocols();
 
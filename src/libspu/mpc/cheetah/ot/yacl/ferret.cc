@@ -153,7 +153,8 @@ struct YaclFerretOt::Impl {
   }
 
  public:
-  Impl(std::shared_ptr<Communicator> conn, bool is_sender, bool use_soft_spoken)
+  Impl(std::shared_ptr<Communicator> conn, bool is_sender, bool use_soft_spoken,
+       bool prefetch)
       : is_sender_(is_sender) {
     SPU_ENFORCE(conn != nullptr);
 
@@ -161,7 +162,8 @@ struct YaclFerretOt::Impl {
     if (use_soft_spoken) {
       ferret_ = std::make_shared<YaclSsOTeAdapter>(conn->lctx(), is_sender);
     } else {
-      ferret_ = std::make_shared<YaclFerretOTeAdapter>(conn->lctx(), is_sender);
+      ferret_ = std::make_shared<YaclFerretOTeAdapter>(conn->lctx(), is_sender,
+                                                       prefetch);
     }
     ferret_->OneTimeSetup();
   }
@@ -855,8 +857,8 @@ struct YaclFerretOt::Impl {
 };
 
 YaclFerretOt::YaclFerretOt(std::shared_ptr<Communicator> conn, bool is_sender,
-                           bool use_soft_spoken) {
-  impl_ = std::make_shared<Impl>(conn, is_sender, use_soft_spoken);
+                           bool use_soft_spoken, bool prefetch) {
+  impl_ = std::make_shared<Impl>(conn, is_sender, use_soft_spoken, prefetch);
 }
 
 int YaclFerretOt::Rank() const { return impl_->Rank(); }
@@ -31,8 +31,10 @@ class YaclFerretOt : public spu::mpc::cheetah::FerretOtInterface {
   std::shared_ptr<Impl> impl_;
 
  public:
+  // `prefetch` expands the next batch of OTs in background, ignored with
+  // `use_spoken_soft`.
   YaclFerretOt(std::shared_ptr<Communicator> conn, bool is_sender,
-               bool use_spoken_soft);
+               bool use_spoken_soft, bool prefetch = false);
 
   ~YaclFerretOt();
 
@@ -275,4 +275,45 @@ TEST_P(FerretCOTTest, COT_Collapse) {
     }
   });
 }
+TEST(FerretCOTPrefetchTest, ChosenCorrelationChosenChoice) {
+  size_t kWorldSize = 2;
+  // more than the first, pre-LPN buffer holds, so the standby buffer is
+  // swapped in at least once.
+  int64_t n = 8192;
+  auto field = FieldType::FM64;
+
+  auto _correlation = ring_rand(field, {n});
+  std::vector<uint8_t> choices(n);
+  std::default_random_engine rdv;
+  std::uniform_int_distribution<uint64_t> uniform(0, -1);
+  std::generate_n(choices.begin(), n, [&]() -> uint8_t {
+    return static_cast<uint8_t>(uniform(rdv) & 1);
+  });
+
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    NdArrayView<ring2k_t> correlation(_correlation);
+    std::vector<ring2k_t> computed[2];
+    utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> ctx) {
+      auto conn = std::make_shared<Communicator>(ctx);
+      int rank = ctx->Rank();
+      computed[rank].resize(n);
+      YaclFerretOt ferret(conn, rank == 0, /*use_ss*/ false,
+                          /*prefetch*/ true);
+      if (rank == 0) {
+        ferret.SendCAMCC(makeConstSpan<ring2k_t>(correlation),
+                         absl::MakeSpan(computed[0]));
+        ferret.Flush();
+      } else {
+        ferret.RecvCAMCC(absl::MakeSpan(choices), absl::MakeSpan(computed[1]));
+      }
+    });
+
+    for (int64_t i = 0; i < n; ++i) {
+      ring2k_t c = -computed[0][i] + computed[1][i];
+      ring2k_t e = choices[i] ? correlation[i] : 0;
+      EXPECT_EQ(e, c);
+    }
+  });
+}
+
 }  // namespace spu::mpc::cheetah::test
@@ -84,12 +84,19 @@ void YaclFerretOTeAdapter::OneTimeSetup() {
   buff_upper_bound_ = pre_lpn_param_.n;
   // Delay boostrap
   // Bootstrap();
+  if (prefetch_) {
+    LaunchRefill();
+  }
 }
 
 void YaclFerretOTeAdapter::rcot(absl::Span<uint128_t> data) {
   if (is_setup_ == false) {
     OneTimeSetup();
   }
+  if (prefetch_) {
+    rcotPrefetched(data);
+    return;
+  }
 
   uint64_t data_offset = 0;
   uint64_t require_num = data.size();
@@ -254,6 +261,88 @@ void YaclFerretOTeAdapter::BootstrapInplace(absl::Span<uint128_t> ot,
   bootstrap_time_ += elapse * 1000;
 }
 
+void YaclFerretOTeAdapter::LaunchRefill() {
+  // The head of the active buffer is never handed out, it seeds the next
+  // expansion.
+  yacl::UninitAlignedVector<uint128_t> base_ot(
+      ot_buff_.data<uint128_t>(), ot_buff_.data<uint128_t>() + reserve_num_);
+  auto output = MakeSpan_Uint128(standby_buff_);
+
+  refill_ = std::async(
+      std::launch::async,
+      [this, output, base_ot = std::move(base_ot)]() mutable {
+        auto begin = std::chrono::high_resolution_clock::now();
+        if (is_sender_) {
+          auto send_ot_store =
+              yc::MakeCompactOtSendStore(std::move(base_ot), Delta);
+          yc::FerretOtExtSend_cheetah(refill_ctx_, send_ot_store, lpn_param_,
+                                      lpn_param_.n, output);
+        } else {
+          auto recv_ot_store = yc::MakeCompactOtRecvStore(std::move(base_ot));
+          yc::FerretOtExtRecv_cheetah(refill_ctx_, recv_ot_store, lpn_param_,
+                                      lpn_param_.n, output);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::duration<double>>(
+                   end - begin)
+                   .count() *
+               1000;
+      });
+}
+
+void YaclFerretOTeAdapter::SwapStandby() {
+  SPU_ENFORCE(refill_.valid());
+  const bool stall = refill_.wait_for(std::chrono::seconds(0)) !=
+                     std::future_status::ready;
+
+  auto begin = std::chrono::high_resolution_clock::now();
+  double elapse = refill_.get();
+  auto end = std::chrono::high_resolution_clock::now();
+  if (stall) {
+    ++stall_num_;
+    stall_time_ +=
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - begin)
+            .count() *
+        1000;
+  }
+
+  std::swap(ot_buff_, standby_buff_);
+  buff_used_num_ = reserve_num_;
+  buff_upper_bound_ = lpn_param_.n;
+
+  // add state
+  ++bootstrap_num_;
+  bootstrap_time_ += elapse;
+
+  LaunchRefill();
+}
+
+void YaclFerretOTeAdapter::rcotPrefetched(absl::Span<uint128_t> data) {
+  uint64_t data_offset = 0;
+  while (data_offset < data.size()) {
+    if (buff_used_num_ == buff_upper_bound_) {
+      SwapStandby();
+    }
+    uint64_t ot_num = std::min<uint64_t>(buff_upper_bound_ - buff_used_num_,
+                                         data.size() - data_offset);
+    std::memcpy(data.data() + data_offset,
+                ot_buff_.data<uint128_t>() + buff_used_num_,
+                ot_num * sizeof(uint128_t));
+    buff_used_num_ += ot_num;
+    consumed_ot_num_ += ot_num;
+    data_offset += ot_num;
+  }
+}
+
+uint64_t YaclFerretOTeAdapter::GetReservoirDepth() const {
+  uint64_t depth = buff_upper_bound_ - buff_used_num_;
+  if (refill_.valid() && refill_.wait_for(std::chrono::seconds(0)) ==
+                             std::future_status::ready) {
+    depth += lpn_param_.n - reserve_num_;
+  }
+  return depth;
+}
+
 // ------------------------
 //   IknpOTeAdapter
 // ------------------------
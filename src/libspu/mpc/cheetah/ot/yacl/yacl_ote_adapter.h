@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <future>
+
 #include "yacl/base/dynamic_bitset.h"
 #include "yacl/crypto/rand/rand.h"
 #include "yacl/kernel/algorithms/base_ot.h"
@@ -47,27 +50,44 @@ class YaclOTeAdapter {
   virtual uint128_t GetDelta() const { return Delta; }
 };
 
+// With `prefetch`, the adapter keeps a standby buffer of the same size as the
+// active one. The next Ferret expansion runs in background on its own link as
+// soon as a buffer becomes active, and rcot only waits for it (a stall) when
+// the active buffer runs dry first. Both parties consume COTs in the same
+// order, so their expansions stay in lockstep.
 class YaclFerretOTeAdapter : public YaclOTeAdapter {
  public:
-  YaclFerretOTeAdapter(const std::shared_ptr<yl::Context>& ctx,
-                       bool is_sender) {
+  YaclFerretOTeAdapter(const std::shared_ptr<yl::Context>& ctx, bool is_sender,
+                       bool prefetch = false) {
     ctx_ = ctx;
     is_sender_ = is_sender;
+    prefetch_ = prefetch;
     reserve_num_ = yc::FerretCotHelper(lpn_param_, 0);
 
     ot_buff_ = yacl::Buffer(lpn_param_.n * sizeof(uint128_t));
+    if (prefetch_) {
+      refill_ctx_ = ctx_->Spawn();
+      refill_ctx_->SetThrottleWindowSize(0);
+      standby_buff_ = yacl::Buffer(lpn_param_.n * sizeof(uint128_t));
+    }
 
     id_ = yacl_id_;
     ++yacl_id_;
   }
 
   ~YaclFerretOTeAdapter() {
+    if (refill_.valid()) {
+      // the peer runs the same expansion, let it finish.
+      refill_.wait();
+    }
     SPDLOG_DEBUG(
         "[FerretAdapter {}]({}), comsume OT {}, total time {:.3e} ms, "
-        "invoke bootstrap {} ( {:.2e} ms per bootstrap, {:.2e} ms per ot )",
+        "invoke bootstrap {} ( {:.2e} ms per bootstrap, {:.2e} ms per ot ), "
+        "stall {} ( {:.3e} ms )",
         id_, (is_sender_ ? fmt::format("Sender") : fmt::format("Receiver")),
         consumed_ot_num_, bootstrap_time_, bootstrap_num_,
-        bootstrap_time_ / bootstrap_num_, bootstrap_time_ / consumed_ot_num_);
+        bootstrap_time_ / bootstrap_num_, bootstrap_time_ / consumed_ot_num_,
+        stall_num_, stall_time_);
   }
 
   void OneTimeSetup() override;
@@ -101,6 +121,16 @@ class YaclFerretOTeAdapter : public YaclOTeAdapter {
 
   double GetTime() const { return bootstrap_time_; }
 
+  // Number of COTs that rcot can hand out without running Ferret, including
+  // a finished standby buffer.
+  uint64_t GetReservoirDepth() const;
+
+  // Number of rcot calls that waited for a background expansion, and the
+  // time spent waiting in ms.
+  uint128_t GetStallNum() const { return stall_num_; }
+
+  double GetStallTime() const { return stall_time_; }
+
  private:
   std::shared_ptr<yl::Context> ctx_{nullptr};
 
@@ -108,6 +138,8 @@ class YaclFerretOTeAdapter : public YaclOTeAdapter {
 
   bool is_setup_{false};
 
+  bool prefetch_{false};
+
   yc::LpnParam pre_lpn_param_{470016, 32768, 918,
                               yc::LpnNoiseAsm::RegularNoise};
 
@@ -135,10 +167,25 @@ class YaclFerretOTeAdapter : public YaclOTeAdapter {
   // Yacl Ferret OTe
   void BootstrapInplace(absl::Span<uint128_t> ot, absl::Span<uint128_t> data);
 
+  // prefetch mode
+  std::shared_ptr<yl::Context> refill_ctx_{nullptr};
+  yacl::Buffer standby_buff_;
+  // background expansion into standby_buff_, returns its time in ms.
+  std::future<double> refill_;
+
+  // Expands into standby_buff_ in background, with the reserved head of the
+  // active buffer as base OTs.
+  void LaunchRefill();
+  // Waits for the standby buffer and makes it active.
+  void SwapStandby();
+  void rcotPrefetched(absl::Span<uint128_t> data);
+
   // runtime record
   uint128_t consumed_ot_num_{0};
   uint128_t bootstrap_num_{0};  // number of invoke bootstrap
   double bootstrap_time_{0.0};  // ms
+  uint128_t stall_num_{0};      // number of waits for the standby buffer
+  double stall_time_{0.0};      // ms
   uint128_t id_{0};
   static uint128_t yacl_id_;
 };
@@ -37,7 +37,8 @@ void regCheetahProtocol(SPUContext* ctx,
   cheetah::registerTypes();
 
   // add communicator
-  ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->addState<Communicator>(
+      lctx, ctx->config().experimental_enable_comm_bit_packing);
 
   // register random states & kernels.
   ctx->prot()->addState<PrgState>(lctx);
@@ -49,10 +50,12 @@ void regCheetahProtocol(SPUContext* ctx,
   ctx->prot()->addState<cheetah::CheetahMulState>(
       lctx, ctx->config().cheetah_2pc_config.enable_mul_lsb_error);
   ctx->prot()->addState<cheetah::CheetahDotState>(
-      lctx, ctx->config().cheetah_2pc_config.disable_matmul_pack);
+      lctx, ctx->config().cheetah_2pc_config.disable_matmul_pack,
+      ctx->config().cheetah_2pc_config.matmul_encode_cache_budget);
   ctx->prot()->addState<cheetah::CheetahOTState>(
       ctx->getClusterLevelMaxConcurrency(),
-      ctx->config().cheetah_2pc_config.ot_kind);
+      ctx->config().cheetah_2pc_config.ot_kind,
+      ctx->config().cheetah_2pc_config.enable_ot_prefetch);
 
   // register public kernels.
   regPV2kKernels(ctx->prot());
@@ -72,7 +75,7 @@ void regCheetahProtocol(SPUContext* ctx,
                   cheetah::MulA1B, cheetah::MulA1BV,                          //
                   cheetah::EqualAA, cheetah::EqualAP,                         //
                   cheetah::MatMulAP, cheetah::MatMulAA, cheetah::MatMulAV,    //
-                  cheetah::MatMulVVS,                                         //
+                  cheetah::MatMulVVS, cheetah::EncodeCacheKernel,             //
                   cheetah::LShiftA, cheetah::ARShiftB, cheetah::LShiftB,      //
                   cheetah::RShiftB,                                           //
                   cheetah::BitrevB,                                           //
@@ -33,6 +33,12 @@ RuntimeConfig makeConfig(FieldType field) {
   return conf;
 }
 
+RuntimeConfig makeBitPackingConfig(FieldType field) {
+  RuntimeConfig conf = makeConfig(field);
+  conf.experimental_enable_comm_bit_packing = true;
+  return conf;
+}
+
 }  // namespace
 
 INSTANTIATE_TEST_SUITE_P(
@@ -47,6 +53,19 @@ INSTANTIATE_TEST_SUITE_P(
                          std::get<2>(p.param));
     });
 
+// Boolean shares narrower than the field are sent packed.
+INSTANTIATE_TEST_SUITE_P(
+    CheetahBitPacking, ApiTest,
+    testing::Combine(testing::Values(makeCheetahProtocol),  //
+                     testing::Values(makeBitPackingConfig(FieldType::FM32),
+                                     makeBitPackingConfig(FieldType::FM64),
+                                     makeBitPackingConfig(FieldType::FM128)),
+                     testing::Values(2)),  //
+    [](const testing::TestParamInfo<ApiTest::ParamType>& p) {
+      return fmt::format("{}x{}", std::get<1>(p.param).field,
+                         std::get<2>(p.param));
+    });
+
 namespace {
 NdArrayRef mockPshare(SPUContext* ctx, const Index& perm) {
   NdArrayRef out(makeType<cheetah::PShrTy>(),
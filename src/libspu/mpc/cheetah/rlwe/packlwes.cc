@@ -19,6 +19,7 @@
 #include "seal/evaluator.h"
 #include "seal/galoiskeys.h"
 #include "seal/keygenerator.h"
+#include "seal/memorymanager.h"
 #include "seal/plaintext.h"
 #include "seal/util/ntt.h"
 #include "seal/util/polyarithsmallmod.h"
@@ -98,6 +99,14 @@ void PackingHelper::PackingWithModulusDrop(absl::Span<RLWECt> rlwes,
   }
   SPU_ENFORCE(rlwes.size() <= gap_);
 
+  BatchPackingWithModulusDrop(rlwes, {&packed, 1});
+}
+
+void PackingHelper::BatchPackingWithModulusDrop(
+    absl::Span<RLWECt> rlwes, absl::Span<RLWECt> packed) const {
+  SPU_ENFORCE(!rlwes.empty());
+  SPU_ENFORCE_EQ(packed.size(), (rlwes.size() + gap_ - 1) / gap_);
+
   auto pid = rlwes[0].parms_id();
   for (auto &rlwe : rlwes) {
     if (rlwe.size() == 0) {
@@ -111,13 +120,15 @@ void PackingHelper::PackingWithModulusDrop(absl::Span<RLWECt> rlwes,
 }
 
 void PackingHelper::doPackingRLWEs(absl::Span<RLWECt> rlwes,
-                                   RLWECt &out) const {
+                                   absl::Span<RLWECt> out) const {
   auto cntxt = context_.first_context_data();
 
   int64_t poly_degree = cntxt->parms().poly_modulus_degree();
   int64_t num_ct = rlwes.size();
+  int64_t gap = gap_;
+  int64_t num_groups = out.size();
 
-  SPU_ENFORCE(num_ct > 0 && num_ct <= (int)gap_,
+  SPU_ENFORCE(num_ct > 0 && num_ct <= num_groups * gap,
               fmt::format("invalid #rlwes = {} for gap = {}", num_ct, gap_));
 
   yacl::parallel_for(0, num_ct, [&](int64_t bgn, int64_t end) {
@@ -130,17 +141,26 @@ void PackingHelper::doPackingRLWEs(absl::Span<RLWECt> rlwes,
     }
   });
 
-  // FFT-like method to merge RLWEs into one RLWE.
+  // FFT-like method to merge each group of RLWEs into one RLWE. The merges of
+  // one level are independent, and they are scheduled across all groups so
+  // that the last levels still have enough work to keep the threads busy.
   seal::Evaluator evaluator(context_);
   const int64_t logn = absl::bit_width(gap_) - 1;
   for (int64_t k = logn; k >= 1; --k) {
     int64_t h = static_cast<uint64_t>(1) << (k - 1);
-    yacl::parallel_for(0, h, [&](int64_t bgn, int64_t end) {
+    yacl::parallel_for(0, num_groups * h, [&](int64_t bgn, int64_t end) {
+      // scratch of the keyswitch comes from the pool of this worker instead
+      // of the global pool, which all workers would contend for.
+      auto pool = seal::MemoryManager::GetPool(
+          seal::mm_prof_opt::mm_force_thread_local, true);
       RLWECt dummy;  // zero-padding with zero RLWE
-      for (int64_t i = bgn; i < end; ++i) {
+      for (int64_t job = bgn; job < end; ++job) {
+        int64_t offset = (job / h) * gap;
+        int64_t n = std::min(gap, num_ct - offset);
+        int64_t i = job % h;
         // E' <- E + X^k*O + Auto(E - X^k*O, k')
-        RLWECt &ct_even = i < num_ct ? rlwes[i] : dummy;
-        RLWECt &ct_odd = i + h < num_ct ? rlwes[i + h] : dummy;
+        RLWECt &ct_even = i < n ? rlwes[offset + i] : dummy;
+        RLWECt &ct_odd = i + h < n ? rlwes[offset + i + h] : dummy;
 
         bool is_odd_empty = ct_odd.size() == 0;
         bool is_even_empty = ct_even.size() == 0;
@@ -152,7 +172,8 @@ void PackingHelper::doPackingRLWEs(absl::Span<RLWECt> rlwes,
         NegacyclicRightShiftInplace(ct_odd, h, context_);
 
         if (!is_even_empty) {
-          seal::Ciphertext tmp = ct_even;
+          seal::Ciphertext tmp(pool);
+          tmp = ct_even;
           if (!is_odd_empty) {
             // E - X^k*O
             // E + X^k*O
@@ -161,20 +182,27 @@ void PackingHelper::doPackingRLWEs(absl::Span<RLWECt> rlwes,
           }
 
           CATCH_SEAL_ERROR(evaluator.apply_galois_inplace(
-              ct_even, poly_degree / h + 1, galois_keys_));
+              ct_even, poly_degree / h + 1, galois_keys_, pool));
           CATCH_SEAL_ERROR(evaluator.add_inplace(ct_even, tmp));
         } else {
           evaluator.negate(ct_odd, ct_even);
           CATCH_SEAL_ERROR(evaluator.apply_galois_inplace(
-              ct_even, poly_degree / h + 1, galois_keys_));
+              ct_even, poly_degree / h + 1, galois_keys_, pool));
           CATCH_SEAL_ERROR(evaluator.add_inplace(ct_even, ct_odd));
         }
       }
     });
   }
 
-  SPU_ENFORCE(rlwes[0].size() > 0, fmt::format("all empty RLWEs are invalid"));
-  out = rlwes[0];
+  // NOTE: `out` might alias the head of `rlwes`, and out[g] never overwrites a
+  // result that has not been moved yet.
+  for (int64_t g = 0; g < num_groups; ++g) {
+    auto &merged = rlwes[g * gap];
+    SPU_ENFORCE(merged.size() > 0, fmt::format("all empty RLWEs are invalid"));
+    if (&out[g] != &merged) {
+      out[g] = std::move(merged);
+    }
+  }
 }
 
 void GenerateGaloisKeyForPacking(const seal::SEALContext &context,
@@ -33,10 +33,16 @@ class PackingHelper {
   // require ct_array.size() == gap
   void PackingWithModulusDrop(absl::Span<RLWECt> rlwes, RLWECt &packed) const;
 
+  // Packs each `gap` consecutive RLWEs, i.e., rlwes[i*gap, (i+1)*gap), into
+  // packed[i]. The merges of each level of the tree are run in parallel across
+  // all the groups. `packed` can alias the head of `rlwes`.
+  void BatchPackingWithModulusDrop(absl::Span<RLWECt> rlwes,
+                                   absl::Span<RLWECt> packed) const;
+
  private:
   void MultiplyFixedScalarInplace(RLWECt &ct) const;
 
-  void doPackingRLWEs(absl::Span<RLWECt> rlwes, RLWECt &out) const;
+  void doPackingRLWEs(absl::Span<RLWECt> rlwes, absl::Span<RLWECt> out) const;
 
   size_t gap_;
   size_t num_modulus_for_packing_;
@@ -146,6 +146,62 @@ TEST_P(PackLWEsTest, PackRLWEs) {
   }
 }
 
+TEST_P(PackLWEsTest, BatchPackRLWEs) {
+  auto field = std::get<0>(GetParam());  // FM64
+  size_t num_rlwes = std::get<1>(GetParam()) / 128;
+  SPU_ENFORCE(num_rlwes <= poly_N);
+  // the last group is half full
+  size_t num_packed = 3;
+  size_t total =
+      num_rlwes * (num_packed - 1) + std::max<size_t>(1, num_rlwes / 2);
+
+  seal::Encryptor encryptor(*N_context_, *N_rlwe_sk_);
+  seal::Decryptor decryptor(*N_context_, *N_rlwe_sk_);
+
+  using scalar_t = uint64_t;
+  std::vector<NdArrayRef> arrays(total);
+  std::vector<RLWECt> rlwes(total);
+  for (size_t i = 0; i < total; ++i) {
+    arrays[i] = ring_rand(field, {poly_N});
+    RLWEPt pt;
+    N_encoder_->Forward(arrays[i], &pt, true);
+    NttInplace(pt, *N_context_);
+    CATCH_SEAL_ERROR(encryptor.encrypt_symmetric(pt, rlwes[i]));
+    InvNttInplace(rlwes[i], *N_context_);
+  }
+
+  PackingHelper ph(num_rlwes, N_ms_helper_->coeff_modulus_size(), *galois_,
+                   *N_context_);
+
+  // pack in place
+  auto packed = absl::MakeSpan(rlwes).subspan(0, num_packed);
+  ph.BatchPackingWithModulusDrop(absl::MakeSpan(rlwes), packed);
+
+  std::vector<scalar_t> coefficients(poly_N);
+  for (size_t g = 0; g < num_packed; ++g) {
+    EXPECT_EQ(packed[g].size(), 2);
+    EXPECT_FALSE(packed[g].is_ntt_form());
+    EXPECT_EQ(packed[g].coeff_modulus_size(),
+              N_ms_helper_->coeff_modulus_size());
+
+    NttInplace(packed[g], *N_context_);
+    RLWEPt dec;
+    decryptor.decrypt(packed[g], dec);
+    InvNttInplace(dec, *N_context_);
+    N_ms_helper_->ModulusDownRNS(absl::MakeSpan(dec.data(), dec.coeff_count()),
+                                 absl::MakeSpan(coefficients));
+
+    size_t n = std::min(num_rlwes, total - g * num_rlwes);
+    for (size_t i = 0; i < poly_N; i += num_rlwes) {
+      size_t offset = i / num_rlwes;
+      for (size_t j = 0; j < n; ++j) {
+        NdArrayView<scalar_t> expected(arrays[g * num_rlwes + j]);
+        EXPECT_EQ(expected[offset * num_rlwes], coefficients[i + j]);
+      }
+    }
+  }
+}
+
 TEST_P(PackLWEsTest, Basic) {
   auto field = std::get<0>(GetParam());  // FM64
   size_t num_lwes = std::get<1>(GetParam()) / 128;
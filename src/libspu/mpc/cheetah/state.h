@@ -102,8 +102,10 @@ class CheetahDotState : public State {
   static constexpr const char* kBindName() { return "CheetahDot"; }
 
   explicit CheetahDotState(const std::shared_ptr<yacl::link::Context>& lctx,
-                           bool disable_matmul_pack = false) {
-    dot_prot_ = std::make_unique<CheetahDot>(lctx, disable_matmul_pack);
+                           bool disable_matmul_pack = false,
+                           size_t encode_cache_budget = 0) {
+    dot_prot_ = std::make_unique<CheetahDot>(lctx, disable_matmul_pack,
+                                             encode_cache_budget);
   }
 
   ~CheetahDotState() override = default;
@@ -122,14 +124,17 @@ class CheetahOTState : public State {
   size_t maximum_instances_ = 0;
   std::vector<ProtPtr> basic_ot_prot_;
   CheetahOtKind ot_kind_;
+  bool enable_prefetch_ = false;
 
  public:
   static constexpr const char* kBindName() { return "CheetahOT"; }
 
-  explicit CheetahOTState(size_t maximum_instances, CheetahOtKind ot_kind)
+  explicit CheetahOTState(size_t maximum_instances, CheetahOtKind ot_kind,
+                          bool enable_prefetch = false)
       : maximum_instances_(std::min(kMaxOTParallel, maximum_instances)),
         basic_ot_prot_(maximum_instances_),
-        ot_kind_(ot_kind) {
+        ot_kind_(ot_kind),
+        enable_prefetch_(enable_prefetch) {
     SPU_ENFORCE(maximum_instances_ > 0);
     std::string ot_type;
     switch (ot_kind_) {
@@ -163,8 +168,8 @@ class CheetahOTState : public State {
     auto link = comm->lctx()->Spawn();
     link->SetThrottleWindowSize(0);
     auto _comm = std::make_shared<Communicator>(std::move(link));
-    basic_ot_prot_[idx] =
-        std::make_shared<BasicOTProtocols>(std::move(_comm), ot_kind_);
+    basic_ot_prot_[idx] = std::make_shared<BasicOTProtocols>(
+        std::move(_comm), ot_kind_, enable_prefetch_);
   }
 
   std::shared_ptr<BasicOTProtocols> get(size_t idx = 0) {
@@ -14,6 +14,8 @@
 
 #include "libspu/mpc/common/communicator.h"
 
+#include <cstring>
+
 #include "libspu/mpc/utils/gfmp_ops.h"
 #include "libspu/mpc/utils/ring_ops.h"
 
@@ -35,14 +37,155 @@ NdArrayRef getOrCreateCompactArray(const NdArrayRef& in) {
   return in;
 }
 
+void reduceInplace(ReduceOp op, NdArrayRef& res, const NdArrayRef& arr) {
+  if (op == ReduceOp::ADD) {
+    if (res.eltype().isa<GfmpTy>()) {
+      gfmp_add_mod_(res, arr);
+    } else {
+      ring_add_(res, arr);
+    }
+  } else if (op == ReduceOp::XOR) {
+    ring_xor_(res, arr);
+  } else {
+    SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
+  }
+}
+
+int64_t wireSize(int64_t numel, size_t elsize, size_t nbits) {
+  if (nbits == 0) {
+    return numel * static_cast<int64_t>(elsize);
+  }
+  return (numel + 63) / 64 * static_cast<int64_t>(nbits * sizeof(uint64_t));
+}
+
+int64_t wireSize(const NdArrayRef& in, size_t nbits) {
+  return wireSize(in.numel(), in.elsize(), nbits);
+}
+
+// Bytes of an array on the wire, the low `nbits` of each element when
+// `nbits` is non-zero, the compact array otherwise.
+class WireBytes {
+ public:
+  WireBytes(const NdArrayRef& in, size_t nbits) {
+    if (nbits > 0) {
+      packed_ = ring_pack_bits(in, nbits);
+      view_ = yacl::ByteContainerView(packed_.data<uint8_t>(), packed_.size());
+    } else {
+      array_ = getOrCreateCompactArray(in);
+      view_ = yacl::ByteContainerView(array_.data<uint8_t>(),
+                                      in.numel() * in.elsize());
+    }
+  }
+
+  WireBytes(const WireBytes&) = delete;
+  WireBytes& operator=(const WireBytes&) = delete;
+
+  yacl::ByteContainerView view() const { return view_; }
+
+  size_t size() const { return view_.size(); }
+
+ private:
+  NdArrayRef array_;
+  yacl::Buffer packed_;
+  yacl::ByteContainerView view_;
+};
+
+NdArrayRef fromWire(const std::shared_ptr<yacl::Buffer>& buf, int64_t offset,
+                    const Type& eltype, const Shape& shape, size_t nbits) {
+  if (nbits > 0) {
+    return ring_unpack_bits(
+        yacl::ByteContainerView(buf->data<uint8_t>() + offset,
+                                wireSize(shape.numel(), eltype.size(), nbits)),
+        eltype, shape, nbits);
+  }
+  return NdArrayRef(buf, eltype, shape, makeCompactStrides(shape), offset);
+}
+
+NdArrayRef fromWire(yacl::Buffer&& buf, const Type& eltype, const Shape& shape,
+                    size_t nbits) {
+  return fromWire(stealBuffer(std::move(buf)), kOffset, eltype, shape, nbits);
+}
+
+// Concatenates the wire bytes of `ins` into a single buffer.
+yacl::Buffer packFrame(absl::Span<const NdArrayRef> ins,
+                       absl::Span<const size_t> nbits) {
+  int64_t frame_size = 0;
+  for (size_t idx = 0; idx < ins.size(); idx++) {
+    frame_size += wireSize(ins[idx], nbits[idx]);
+  }
+  yacl::Buffer frame(frame_size);
+  int64_t offset = 0;
+  for (size_t idx = 0; idx < ins.size(); idx++) {
+    const WireBytes wire(ins[idx], nbits[idx]);
+    if (wire.size() > 0) {
+      std::memcpy(frame.data<std::byte>() + offset, wire.view().data(),
+                  wire.size());
+    }
+    offset += wire.size();
+  }
+  return frame;
+}
+
+// Splits a frame packed by a peer into compact arrays of the given types and
+// shapes.
+std::vector<NdArrayRef> unpackFrame(yacl::Buffer&& frame,
+                                    absl::Span<const Type> eltypes,
+                                    absl::Span<const Shape> shapes,
+                                    absl::Span<const size_t> nbits) {
+  SPU_ENFORCE(eltypes.size() == shapes.size());
+  int64_t frame_size = 0;
+  for (size_t idx = 0; idx < shapes.size(); idx++) {
+    frame_size +=
+        wireSize(shapes[idx].numel(), eltypes[idx].size(), nbits[idx]);
+  }
+  SPU_ENFORCE(frame.size() == frame_size, "frame size mismatch {} {}",
+              frame.size(), frame_size);
+  auto buf = stealBuffer(std::move(frame));
+  std::vector<NdArrayRef> res;
+  res.reserve(shapes.size());
+  int64_t offset = 0;
+  for (size_t idx = 0; idx < shapes.size(); idx++) {
+    res.push_back(
+        fromWire(buf, offset, eltypes[idx], shapes[idx], nbits[idx]));
+    offset += wireSize(shapes[idx].numel(), eltypes[idx].size(), nbits[idx]);
+  }
+  return res;
+}
+
+// Splits a frame packed by a peer into compact arrays shaped as `likes`.
+std::vector<NdArrayRef> unpackFrame(yacl::Buffer&& frame,
+                                    absl::Span<const NdArrayRef> likes,
+                                    absl::Span<const size_t> nbits) {
+  std::vector<Type> eltypes;
+  std::vector<Shape> shapes;
+  for (const auto& like : likes) {
+    eltypes.push_back(like.eltype());
+    shapes.push_back(like.shape());
+  }
+  return unpackFrame(std::move(frame), eltypes, shapes, nbits);
+}
+
 }  // namespace
 
+size_t Communicator::packedBits(const Type& eltype) const {
+  if (!bit_packing_ || !eltype.isa<BShare>() || !eltype.isa<Ring2k>()) {
+    return 0;
+  }
+  const auto field = eltype.as<Ring2k>()->field();
+  const size_t nbits = eltype.as<BShare>()->nbits();
+  if (eltype.size() != SizeOf(field) || nbits == 0 ||
+      nbits >= SizeOf(field) * 8) {
+    return 0;
+  }
+  return nbits;
+}
+
 NdArrayRef Communicator::allReduce(ReduceOp op, const NdArrayRef& in,
                                    std::string_view tag) {
-  const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             in.numel() * in.elsize());
-  std::vector<yacl::Buffer> bufs = yacl::link::AllGather(lctx_, bv, tag);
+  const size_t nbits = packedBits(in.eltype());
+  const WireBytes wire(in, nbits);
+  std::vector<yacl::Buffer> bufs =
+      yacl::link::AllGather(lctx_, wire.view(), tag);
 
   SPU_ENFORCE(bufs.size() == getWorldSize());
   auto res = in.clone();
@@ -51,23 +194,56 @@ NdArrayRef Communicator::allReduce(ReduceOp op, const NdArrayRef& in,
       continue;
     }
 
-    auto arr = NdArrayRef(stealBuffer(std::move(bufs[idx])), in.eltype(),
-                          in.shape(), makeCompactStrides(in.shape()), kOffset);
-    if (op == ReduceOp::ADD) {
-      if (in.eltype().isa<GfmpTy>()) {
-        gfmp_add_mod_(res, arr);
-      } else {
-        ring_add_(res, arr);
-      }
-    } else if (op == ReduceOp::XOR) {
-      ring_xor_(res, arr);
-    } else {
-      SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
+    auto arr = fromWire(std::move(bufs[idx]), in.eltype(), in.shape(), nbits);
+    reduceInplace(op, res, arr);
+  }
+  if (nbits > 0) {
+    // peers only sent live bits, drop the local dead ones as well.
+    ring_bitmask_(res, 0, nbits);
+  }
+
+  stats_.latency += 1;
+  stats_.messages += 1;
+  stats_.comm += wire.size() * (lctx_->WorldSize() - 1);
+
+  return res;
+}
+
+std::vector<NdArrayRef> Communicator::allReduce(
+    ReduceOp op, absl::Span<const NdArrayRef> ins, std::string_view tag) {
+  std::vector<size_t> nbits;
+  for (const auto& in : ins) {
+    nbits.push_back(packedBits(in.eltype()));
+  }
+  const auto frame = packFrame(ins, nbits);
+  yacl::ByteContainerView bv(frame.data<uint8_t>(), frame.size());
+  std::vector<yacl::Buffer> bufs = yacl::link::AllGather(lctx_, bv, tag);
+
+  SPU_ENFORCE(bufs.size() == getWorldSize());
+  std::vector<NdArrayRef> res;
+  res.reserve(ins.size());
+  for (const auto& in : ins) {
+    res.push_back(in.clone());
+  }
+  for (size_t idx = 0; idx < bufs.size(); idx++) {
+    if (idx == getRank()) {
+      continue;
+    }
+
+    auto arrs = unpackFrame(std::move(bufs[idx]), ins, nbits);
+    for (size_t i = 0; i < ins.size(); i++) {
+      reduceInplace(op, res[i], arrs[i]);
+    }
+  }
+  for (size_t i = 0; i < ins.size(); i++) {
+    if (nbits[i] > 0) {
+      ring_bitmask_(res[i], 0, nbits[i]);
     }
   }
 
   stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize() * (lctx_->WorldSize() - 1);
+  stats_.messages += ins.size();
+  stats_.comm += frame.size() * (lctx_->WorldSize() - 1);
 
   return res;
 }
@@ -75,10 +251,10 @@ NdArrayRef Communicator::allReduce(ReduceOp op, const NdArrayRef& in,
 NdArrayRef Communicator::reduce(ReduceOp op, const NdArrayRef& in, size_t root,
                                 std::string_view tag) {
   SPU_ENFORCE(root < lctx_->WorldSize());
-  const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             in.numel() * in.elsize());
-  std::vector<yacl::Buffer> bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  const size_t nbits = packedBits(in.eltype());
+  const WireBytes wire(in, nbits);
+  std::vector<yacl::Buffer> bufs =
+      yacl::link::Gather(lctx_, wire.view(), root, tag);
 
   auto res = in.clone();
   if (getRank() == root) {
@@ -88,59 +264,50 @@ NdArrayRef Communicator::reduce(ReduceOp op, const NdArrayRef& in, size_t root,
       }
 
       auto arr =
-          NdArrayRef(stealBuffer(std::move(bufs[idx])), in.eltype(), in.shape(),
-                     makeCompactStrides(in.shape()), kOffset);
-      if (op == ReduceOp::ADD) {
-        if (in.eltype().isa<GfmpTy>()) {
-          gfmp_add_mod_(res, arr);
-        } else {
-          ring_add_(res, arr);
-        }
-      } else if (op == ReduceOp::XOR) {
-        ring_xor_(res, arr);
-      } else {
-        SPU_THROW("unsupported reduce op={}", static_cast<int>(op));
-      }
+          fromWire(std::move(bufs[idx]), in.eltype(), in.shape(), nbits);
+      reduceInplace(op, res, arr);
+    }
+    if (nbits > 0) {
+      ring_bitmask_(res, 0, nbits);
     }
   }
   stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize();
+  stats_.messages += 1;
+  stats_.comm += wire.size();
 
   return res;
 }
 
 NdArrayRef Communicator::rotate(const NdArrayRef& in, std::string_view tag) {
-  const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             in.numel() * in.elsize());
-  lctx_->SendAsync(lctx_->PrevRank(), bv, tag);
+  const size_t nbits = packedBits(in.eltype());
+  const WireBytes wire(in, nbits);
+  lctx_->SendAsync(lctx_->PrevRank(), wire.view(), tag);
 
   auto res_buf = lctx_->Recv(lctx_->NextRank(), tag);
 
   stats_.latency += 1;
-  stats_.comm += in.numel() * in.elsize();
+  stats_.messages += 1;
+  stats_.comm += wire.size();
 
-  return NdArrayRef(stealBuffer(std::move(res_buf)), in.eltype(), in.shape(),
-                    makeCompactStrides(in.shape()), kOffset);
+  return fromWire(std::move(res_buf), in.eltype(), in.shape(), nbits);
 }
 
 std::vector<NdArrayRef> Communicator::gather(const NdArrayRef& in, size_t root,
                                              std::string_view tag) {
-  const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             array.numel() * array.elsize());
-  auto bufs = yacl::link::Gather(lctx_, bv, root, tag);
+  const size_t nbits = packedBits(in.eltype());
+  const WireBytes wire(in, nbits);
+  auto bufs = yacl::link::Gather(lctx_, wire.view(), root, tag);
 
   stats_.latency += 1;
-  stats_.comm += array.numel() * array.elsize();
+  stats_.messages += 1;
+  stats_.comm += wire.size();
 
   auto res = std::vector<NdArrayRef>(getWorldSize());
   if (root == getRank()) {
     SPU_ENFORCE_EQ(bufs.size(), getWorldSize());
     for (size_t idx = 0; idx < bufs.size(); idx++) {
       res[idx] =
-          NdArrayRef(stealBuffer(std::move(bufs[idx])), in.eltype(), in.shape(),
-                     makeCompactStrides(in.shape()), kOffset);
+          fromWire(std::move(bufs[idx]), in.eltype(), in.shape(), nbits);
     }
   }
   return res;
@@ -149,43 +316,89 @@ std::vector<NdArrayRef> Communicator::gather(const NdArrayRef& in, size_t root,
 NdArrayRef Communicator::broadcast(const NdArrayRef& in, size_t root,
                                    const Type& eltype, const Shape& shape,
                                    std::string_view tag) {
+  const size_t nbits = packedBits(eltype);
+
   stats_.latency += 1;
-  stats_.comm += in.elsize() * in.numel();
+  stats_.messages += 1;
+  stats_.comm += wireSize(shape.numel(), eltype.size(), nbits);
 
   yacl::Buffer buf;
   if (lctx_->Rank() == root) {
-    const auto array = getOrCreateCompactArray(in);
-    yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                               array.elsize() * array.numel());
-    auto buf = yacl::link::Broadcast(lctx_, bv, root, tag);
-    return NdArrayRef(stealBuffer(std::move(buf)), in.eltype(), in.shape(),
-                      makeCompactStrides(in.shape()), kOffset);
+    const WireBytes wire(in, nbits);
+    auto buf = yacl::link::Broadcast(lctx_, wire.view(), root, tag);
+    return fromWire(std::move(buf), in.eltype(), in.shape(), nbits);
   } else {
     // for yacl::link::Broadcast need a legal ByteContainerView
     // But the data is not actually used
     std::array<uint8_t, 1> dummy;
     auto buf = yacl::link::Broadcast(lctx_, dummy, root, tag);
-    SPU_ENFORCE(static_cast<size_t>(buf.size()) ==
-                shape.numel() * eltype.size());
-    return NdArrayRef(stealBuffer(std::move(buf)), eltype, shape,
-                      makeCompactStrides(shape), kOffset);
+    SPU_ENFORCE(static_cast<int64_t>(buf.size()) ==
+                wireSize(shape.numel(), eltype.size(), nbits));
+    return fromWire(std::move(buf), eltype, shape, nbits);
   }
 }
 
 void Communicator::sendAsync(size_t dst_rank, const NdArrayRef& in,
                              std::string_view tag) {
-  const auto array = getOrCreateCompactArray(in);
-  yacl::ByteContainerView bv(reinterpret_cast<uint8_t const*>(array.data()),
-                             in.numel() * in.elsize());
-  lctx_->SendAsync(dst_rank, bv, tag);
+  const size_t nbits = packedBits(in.eltype());
+  if (nbits == 0) {
+    const WireBytes wire(in, nbits);
+    lctx_->SendAsync(dst_rank, wire.view(), tag);
+    return;
+  }
+
+  // the receiver can not tell the number of elements from the packed size.
+  const int64_t numel = in.numel();
+  const WireBytes wire(in, nbits);
+  yacl::Buffer frame(sizeof(numel) + wire.size());
+  std::memcpy(frame.data<std::byte>(), &numel, sizeof(numel));
+  std::memcpy(frame.data<std::byte>() + sizeof(numel), wire.view().data(),
+              wire.size());
+  lctx_->SendAsync(dst_rank, yacl::ByteContainerView(frame.data<uint8_t>(),
+                                                     frame.size()),
+                   tag);
 }
 
 NdArrayRef Communicator::recv(size_t src_rank, const Type& eltype,
                               std::string_view tag) {
   auto buf = lctx_->Recv(src_rank, tag);
 
-  int64_t numel = buf.size() / eltype.size();
-  return NdArrayRef(stealBuffer(std::move(buf)), eltype, {numel}, {1}, kOffset);
+  const size_t nbits = packedBits(eltype);
+  if (nbits == 0) {
+    int64_t numel = buf.size() / eltype.size();
+    return NdArrayRef(stealBuffer(std::move(buf)), eltype, {numel}, {1},
+                      kOffset);
+  }
+
+  int64_t numel = 0;
+  SPU_ENFORCE(buf.size() >= static_cast<int64_t>(sizeof(numel)));
+  std::memcpy(&numel, buf.data<std::byte>(), sizeof(numel));
+  return fromWire(stealBuffer(std::move(buf)), sizeof(numel), eltype, {numel},
+                  nbits);
+}
+
+void Communicator::sendAsync(size_t dst_rank, absl::Span<const NdArrayRef> ins,
+                             std::string_view tag) {
+  std::vector<size_t> nbits;
+  for (const auto& in : ins) {
+    nbits.push_back(packedBits(in.eltype()));
+  }
+  const auto frame = packFrame(ins, nbits);
+  lctx_->SendAsync(
+      dst_rank, yacl::ByteContainerView(frame.data<uint8_t>(), frame.size()),
+      tag);
+}
+
+std::vector<NdArrayRef> Communicator::recv(size_t src_rank,
+                                           absl::Span<const Type> eltypes,
+                                           absl::Span<const Shape> shapes,
+                                           std::string_view tag) {
+  auto frame = lctx_->Recv(src_rank, tag);
+  std::vector<size_t> nbits;
+  for (const auto& eltype : eltypes) {
+    nbits.push_back(packedBits(eltype));
+  }
+  return unpackFrame(std::move(frame), eltypes, shapes, nbits);
 }
 
-}  // namespace spu::mpc
\ No newline at end of file
+}  // namespace spu::mpc
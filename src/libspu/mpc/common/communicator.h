@@ -62,8 +62,13 @@ class Communicator : public State {
     // TODO(jint) add formal definition for asymmetric algorithms.
     size_t comm = 0;
 
+    // Number of logical messages, i.e. arrays. Batched calls carry several
+    // messages in one frame, which costs a single latency.
+    size_t messages = 0;
+
     Stats operator-(const Stats& rhs) const {
-      return {latency - rhs.latency, comm - rhs.comm};
+      return {latency - rhs.latency, comm - rhs.comm,
+              messages - rhs.messages};
     }
   };
 
@@ -72,15 +77,24 @@ class Communicator : public State {
 
   const std::shared_ptr<yacl::link::Context> lctx_;
 
+  // Send only the live bits of boolean shares, see packedBits.
+  const bool bit_packing_;
+
+  // Number of bits of `eltype` sent on the wire when bit packing is enabled,
+  // i.e. the nbits of a boolean share stored one element per ring element,
+  // 0 to send elements as is.
+  size_t packedBits(const Type& eltype) const;
+
  public:
-  explicit Communicator(std::shared_ptr<yacl::link::Context> lctx)
-      : lctx_(std::move(lctx)) {}
+  explicit Communicator(std::shared_ptr<yacl::link::Context> lctx,
+                        bool bit_packing = false)
+      : lctx_(std::move(lctx)), bit_packing_(bit_packing) {}
 
   bool hasLowCostFork() const override { return true; }
 
   std::unique_ptr<State> fork() override {
     // TODO: share the same statistics.
-    return std::make_unique<Communicator>(lctx_->Spawn());
+    return std::make_unique<Communicator>(lctx_->Spawn(), bit_packing_);
   }
 
   const std::shared_ptr<yacl::link::Context>& lctx() { return lctx_; }
@@ -103,6 +117,13 @@ class Communicator : public State {
 
   NdArrayRef allReduce(ReduceOp op, const NdArrayRef& in, std::string_view tag);
 
+  // Batched version, all arrays are packed into one frame and sent in a
+  // single round. Arrays may have different types and shapes, which must be
+  // the same on all parties.
+  std::vector<NdArrayRef> allReduce(ReduceOp op,
+                                    absl::Span<const NdArrayRef> ins,
+                                    std::string_view tag);
+
   std::vector<NdArrayRef> gather(const NdArrayRef& in, size_t root,
                                  std::string_view tag);
 
@@ -118,6 +139,16 @@ class Communicator : public State {
 
   NdArrayRef recv(size_t src_rank, const Type& eltype, std::string_view tag);
 
+  // Batched point to point, several arrays for the same peer are sent as one
+  // message. The receiver gives the types and shapes of the arrays, compact
+  // arrays are returned.
+  void sendAsync(size_t dst_rank, absl::Span<const NdArrayRef> ins,
+                 std::string_view tag);
+
+  std::vector<NdArrayRef> recv(size_t src_rank, absl::Span<const Type> eltypes,
+                               absl::Span<const Shape> shapes,
+                               std::string_view tag);
+
   template <typename T>
   std::vector<T> rotate(absl::Span<T const> in, std::string_view tag);
 
@@ -149,6 +180,7 @@ std::vector<T> Communicator::rotate(absl::Span<T const> in,
   auto buf = lctx_->Recv(lctx_->NextRank(), tag);
 
   stats_.latency += 1;
+  stats_.messages += 1;
   stats_.comm += in.size() * sizeof(T);
 
   SPU_ENFORCE(buf.size() == static_cast<int64_t>(sizeof(T) * in.size()));
@@ -189,6 +221,7 @@ std::vector<T> Communicator::allReduce(absl::Span<T const> in,
   }
 
   stats_.latency += 1;
+  stats_.messages += 1;
   stats_.comm += in.size() * sizeof(T) * (lctx_->WorldSize() - 1);
 
   return res;
@@ -202,6 +235,7 @@ std::vector<T> Communicator::bcast(absl::Span<T const> in, size_t root,
   yacl::Buffer buf = yacl::link::Broadcast(lctx_, bv, root, tag);
 
   stats_.latency += 1;
+  stats_.messages += 1;
   stats_.comm += in.size() * sizeof(T);
 
   // TODO: steal the buffer.
@@ -219,6 +253,7 @@ std::vector<std::vector<T>> Communicator::gather(absl::Span<T const> in,
   std::vector<yacl::Buffer> bufs = yacl::link::Gather(lctx_, bv, root, tag);
 
   stats_.latency += 1;
+  stats_.messages += 1;
   stats_.comm += in.size() * sizeof(T);
 
   // TODO: steal the buffer.
@@ -24,6 +24,19 @@
 namespace spu::mpc {
 namespace {
 
+class TestBShrTy : public TypeImpl<TestBShrTy, RingTy, Secret, BShare> {
+  using Base = TypeImpl<TestBShrTy, RingTy, Secret, BShare>;
+
+ public:
+  using Base::Base;
+  TestBShrTy(FieldType field, size_t nbits) {
+    field_ = field;
+    nbits_ = nbits;
+  }
+
+  static std::string_view getStaticId() { return "test.BShr"; }
+};
+
 class CommTest
     : public ::testing::TestWithParam<std::tuple<size_t, FieldType>> {};
 
@@ -107,6 +120,110 @@ TEST_P(CommTest, Rotate) {
   });
 }
 
+TEST_P(CommTest, BatchedAllReduce) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+
+  // arrays of different fields and shapes in the same frame.
+  std::vector<NdArrayRef> xs(kWorldSize);
+  std::vector<NdArrayRef> ys(kWorldSize);
+  auto sum_x = ring_zeros(kField, {10, 20});
+  auto sum_y = ring_zeros(FieldType::FM32, {7});
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    xs[idx] = ring_rand(kField, {10, 20});
+    ys[idx] = ring_rand(FieldType::FM32, {7});
+    ring_add_(sum_x, xs[idx]);
+    ring_add_(sum_y, ys[idx]);
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    // WHEN
+    auto prev = com.getStats();
+    auto rs = com.allReduce(ReduceOp::ADD,
+                            {xs[com.getRank()], ys[com.getRank()]}, "_");
+    auto cost = com.getStats() - prev;
+
+    // THEN
+    ASSERT_EQ(rs.size(), 2);
+    EXPECT_TRUE(ring_all_equal(rs[0], sum_x));
+    EXPECT_TRUE(ring_all_equal(rs[1], sum_y));
+    EXPECT_EQ(cost.latency, 1);
+    EXPECT_EQ(cost.messages, 2);
+  });
+}
+
+TEST_P(CommTest, BatchedSendRecv) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  const int64_t kNumel = 1000;
+
+  std::vector<NdArrayRef> xs(kWorldSize);
+  std::vector<NdArrayRef> ys(kWorldSize);
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    xs[idx] = ring_rand(kField, {kNumel});
+    // strided input of another field.
+    ys[idx] =
+        ring_rand(FieldType::FM32, {2 * kNumel}).slice({0}, {2 * kNumel}, {2});
+  }
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx));
+    // WHEN
+    com.sendAsync(com.prevRank(), {xs[com.getRank()], ys[com.getRank()]},
+                  "_");
+    auto rs = com.recv(com.nextRank(), {xs[0].eltype(), ys[0].eltype()},
+                       {Shape{kNumel}, Shape{kNumel}}, "_");
+
+    // THEN
+    const auto next = (com.getRank() + 1) % kWorldSize;
+    ASSERT_EQ(rs.size(), 2);
+    EXPECT_TRUE(ring_all_equal(rs[0], xs[next]));
+    EXPECT_TRUE(ring_all_equal(rs[1], ys[next]));
+  });
+}
+
+TEST_P(CommTest, BitPacking) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  const int64_t kNumel = 1000;
+  const size_t kNbits = 5;
+  const auto ty = makeType<TestBShrTy>(kField, kNbits);
+
+  // random high bits, which are not live.
+  std::vector<NdArrayRef> xs(kWorldSize);
+  auto xor_x = ring_zeros(kField, {kNumel});
+  for (size_t idx = 0; idx < kWorldSize; idx++) {
+    xs[idx] = ring_rand(kField, {kNumel}).as(ty);
+    ring_xor_(xor_x, xs[idx]);
+  }
+  ring_bitmask_(xor_x, 0, kNbits);
+
+  utils::simulate(kWorldSize, [&](std::shared_ptr<yacl::link::Context> lctx) {
+    Communicator com(std::move(lctx), true);
+    const auto rank = com.getRank();
+    const auto next = (rank + 1) % kWorldSize;
+
+    // WHEN
+    auto prev = com.getStats();
+    auto xor_r = com.allReduce(ReduceOp::XOR, xs[rank], "_");
+    auto cost = com.getStats() - prev;
+    auto rotated = com.rotate(xs[rank], "_");
+    com.sendAsync(next, xs[rank], "_");
+    auto received = com.recv((rank + kWorldSize - 1) % kWorldSize, ty, "_");
+
+    // THEN
+    EXPECT_TRUE(ring_all_equal(xor_r, xor_x));
+    EXPECT_EQ(cost.comm, (kNumel + 63) / 64 * kNbits * sizeof(uint64_t) *
+                             (kWorldSize - 1));
+    EXPECT_TRUE(
+        ring_all_equal(rotated, ring_bitmask(xs[next], 0, kNbits)));
+    EXPECT_TRUE(ring_all_equal(
+        received,
+        ring_bitmask(xs[(rank + kWorldSize - 1) % kWorldSize], 0, kNbits)));
+  });
+}
+
 INSTANTIATE_TEST_SUITE_P(
     CommTestInstances, CommTest,
     testing::Combine(testing::Values(4, 3, 2),
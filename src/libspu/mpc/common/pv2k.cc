@@ -360,10 +360,10 @@ class MatMulPP : public MatmulKernel {
 
   ce::CExpr comm() const override { return ce::Const(0); }
 
-  NdArrayRef proc(KernelEvalContext*, const NdArrayRef& lhs,
+  NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                   const NdArrayRef& rhs) const override {
     SPU_ENFORCE(lhs.eltype() == rhs.eltype());
-    return ring_mmul(lhs, rhs).as(lhs.eltype());
+    return ring_mmul(lhs, rhs, getMmulNumThreads(ctx)).as(lhs.eltype());
   }
 };
 
@@ -380,7 +380,7 @@ class MatMulVVV : public MatmulKernel {
     SPU_ENFORCE(lhs.eltype() == rhs.eltype());
     // For parties other than owner, also do a matmul to make result shape
     // correct.
-    return ring_mmul(lhs, rhs).as(lhs.eltype());
+    return ring_mmul(lhs, rhs, getMmulNumThreads(ctx)).as(lhs.eltype());
   }
 };
 
@@ -396,7 +396,7 @@ class MatMulVP : public MatmulKernel {
                   const NdArrayRef& rhs) const override {
     // For parties other than owner, also do a matmul to make result shape
     // correct.
-    return ring_mmul(lhs, rhs).as(lhs.eltype());
+    return ring_mmul(lhs, rhs, getMmulNumThreads(ctx)).as(lhs.eltype());
   }
 };
 
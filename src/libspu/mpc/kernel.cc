@@ -16,6 +16,11 @@
 
 namespace spu::mpc {
 
+int64_t getMmulNumThreads(KernelEvalContext* ctx) {
+  return static_cast<int64_t>(
+      ctx->sctx()->config().experimental_mmul_num_threads);
+}
+
 void RandKernel::evaluate(KernelEvalContext* ctx) const {
   const auto& shape = ctx->getParam<Shape>(0);
 
@@ -18,6 +18,10 @@
 
 namespace spu::mpc {
 
+// Thread budget of the ring matmuls run by the kernels of `ctx`, see
+// RuntimeConfig.experimental_mmul_num_threads.
+int64_t getMmulNumThreads(KernelEvalContext* ctx);
+
 class RandKernel : public Kernel {
  public:
   void evaluate(KernelEvalContext* ctx) const override;
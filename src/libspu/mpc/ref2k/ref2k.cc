@@ -284,7 +284,7 @@ class Ref2kMatMulSS : public MatmulKernel {
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                   const NdArrayRef& rhs) const override {
     SPU_ENFORCE(lhs.eltype() == rhs.eltype());
-    return ring_mmul(lhs, rhs).as(lhs.eltype());
+    return ring_mmul(lhs, rhs, getMmulNumThreads(ctx)).as(lhs.eltype());
   }
 };
 
@@ -298,7 +298,7 @@ class Ref2kMatMulSP : public MatmulKernel {
 
   NdArrayRef proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                   const NdArrayRef& rhs) const override {
-    return ring_mmul(lhs, rhs).as(lhs.eltype());
+    return ring_mmul(lhs, rhs, getMmulNumThreads(ctx)).as(lhs.eltype());
   }
 };
 
@@ -174,7 +174,7 @@ NdArrayRef MulAP::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
 ////////////////////////////////////////////////////////////////////
 NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                           const NdArrayRef& y) const {
-  return ring_mmul(x, y).as(x.eltype());
+  return ring_mmul(x, y, getMmulNumThreads(ctx)).as(x.eltype());
 }
 
 NdArrayRef LShiftA::proc(KernelEvalContext* ctx, const NdArrayRef& in,
@@ -384,10 +384,11 @@ NdArrayRef MatMulAA_simple::proc(KernelEvalContext* ctx, const NdArrayRef& x,
   const auto field = x.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto rank = comm->getRank();
+  const auto num_threads = getMmulNumThreads(ctx);
   auto ty = makeType<AShrTy>(field);
   auto shape1 = x.shape();
   auto shape2 = y.shape();
-  auto shape3 = ring_mmul(x, y).shape();
+  auto shape3 = ring_mmul(x, y, num_threads).shape();
   auto z = ring_zeros(field, shape3);
 
   const auto kComm = x.elsize();
@@ -400,7 +401,8 @@ NdArrayRef MatMulAA_simple::proc(KernelEvalContext* ctx, const NdArrayRef& x,
     auto b0 = ring_rand(field, shape2);
     auto b1 = ring_rand(field, shape2);
     auto c0 = ring_rand(field, shape3);
-    auto c1 = ring_sub(ring_mmul(ring_add(a0, a1), ring_add(b0, b1)), c0);
+    auto c1 = ring_sub(
+        ring_mmul(ring_add(a0, a1), ring_add(b0, b1), num_threads), c0);
     // 1 latency, 2 * (m * n + m * k + n * k) * kComm (offline)
     comm->sendAsync(0, a0, "a");
     comm->sendAsync(0, b0, "b");
@@ -433,10 +435,12 @@ NdArrayRef MatMulAA_simple::proc(KernelEvalContext* ctx, const NdArrayRef& x,
     auto y_b = ring_add(send_y_b, recv_y_b);
 
     // Zi = Ci + (X - A) dot Bi + Ai dot (Y - B) + <(X - A) dot (Y - B)>
-    z = ring_add(ring_add(ring_mmul(x_a, b), ring_mmul(a, y_b)), c);
+    z = ring_add(ring_add(ring_mmul(x_a, b, num_threads),
+                          ring_mmul(a, y_b, num_threads)),
+                 c);
     if (rank == 0) {
       // z += (X-A) * (Y-B);
-      z = ring_add(z, ring_mmul(x_a, y_b));
+      z = ring_add(z, ring_mmul(x_a, y_b, num_threads));
     }
   }
 
@@ -460,9 +464,10 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
   const auto field = x.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto rank = comm->getRank();
+  const auto num_threads = getMmulNumThreads(ctx);
   auto shape1 = x.shape();
   auto shape2 = y.shape();
-  auto shape3 = ring_mmul(x, y).shape();
+  auto shape3 = ring_mmul(x, y, num_threads).shape();
   auto ty = makeType<AShrTy>(field);
   auto z = ring_zeros(field, shape3);
 
@@ -482,7 +487,8 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
             .second;
 
     // c1 = (a0 + a1) * (b0 + b1) - c0
-    auto c1 = ring_sub(ring_mmul(ring_add(a0, a1), ring_add(b0, b1)), c0);
+    auto c1 = ring_sub(
+        ring_mmul(ring_add(a0, a1), ring_add(b0, b1), num_threads), c0);
     comm->sendAsync(1, c1, "c");  // 1 latency, m * n * kComm (offline)
   }
 
@@ -523,10 +529,12 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
     auto y_b = ring_add(send_y_b, recv_y_b);
 
     // Zi = Ci + (X - A) dot Bi + Ai dot (Y - B) + <(X - A) dot (Y - B)>
-    z = ring_add(ring_add(ring_mmul(x_a, b), ring_mmul(a, y_b)), c);
+    z = ring_add(ring_add(ring_mmul(x_a, b, num_threads),
+                          ring_mmul(a, y_b, num_threads)),
+                 c);
     if (rank == 0) {
       // z += (X-A) * (Y-B);
-      z = ring_add(z, ring_mmul(x_a, y_b));
+      z = ring_add(z, ring_mmul(x_a, y_b, num_threads));
     }
   }
 
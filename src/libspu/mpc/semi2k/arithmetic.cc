@@ -17,13 +17,13 @@
 #include <functional>
 
 #include "libspu/core/type_util.h"
-#include "libspu/core/vectorize.h"
 #include "libspu/mpc/api.h"
 #include "libspu/mpc/common/communicator.h"
 #include "libspu/mpc/common/prg_state.h"
 #include "libspu/mpc/common/pv2k.h"
 #include "libspu/mpc/semi2k/state.h"
 #include "libspu/mpc/semi2k/type.h"
+#include "libspu/mpc/utils/ring_eval.h"
 #include "libspu/mpc/utils/ring_ops.h"
 
 namespace spu::mpc::semi2k {
@@ -241,9 +241,8 @@ std::tuple<NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef, NdArrayRef> MulOpen(
       y_b = comm->allReduce(ReduceOp::ADD, ring_sub(y, b), "open(y-b)");
     }
   } else {
-    auto res = vmap({ring_sub(x, a), ring_sub(y, b)}, [&](const NdArrayRef& s) {
-      return comm->allReduce(ReduceOp::ADD, s, "open(x-a,y-b)");
-    });
+    auto res = comm->allReduce(ReduceOp::ADD, {ring_sub(x, a), ring_sub(y, b)},
+                               "open(x-a,y-b)");
     x_a = std::move(res[0]);
     y_b = std::move(res[1]);
   }
@@ -268,15 +267,13 @@ NdArrayRef MulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
   auto [a, b, c, x_a, y_b] = MulOpen(ctx, x, y, false);
 
   // Zi = Ci + (X - A) * Bi + (Y - B) * Ai + <(X - A) * (Y - B)>
-  ring_mul_(b, x_a);
-  ring_mul_(a, y_b);
-  ring_add_(b, a);
-  ring_add_(b, c);
-
+  auto z = ring_expr(c) + ring_expr(x_a) * ring_expr(b) +
+           ring_expr(y_b) * ring_expr(a);
   if (comm->getRank() == 0) {
     // z += (X-A) * (Y-B);
-    ring_mul_(x_a, y_b);
-    ring_add_(b, x_a);
+    ring_eval(b, z + ring_expr(x_a) * ring_expr(y_b));
+  } else {
+    ring_eval(b, z);
   }
   return b.as(x.eltype());
 }
@@ -440,22 +437,25 @@ NdArrayRef MulVVS::proc(KernelEvalContext* ctx, const NdArrayRef& x,
 ////////////////////////////////////////////////////////////////////
 // matmul family
 ////////////////////////////////////////////////////////////////////
-NdArrayRef MatMulAP::proc(KernelEvalContext*, const NdArrayRef& x,
+NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                           const NdArrayRef& y) const {
-  return ring_mmul(x, y).as(x.eltype());
+  return ring_mmul(x, y, getMmulNumThreads(ctx)).as(x.eltype());
 }
 
 NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& x,
                           const NdArrayRef& y) const {
   auto* comm = ctx->getState<Communicator>();
+  const auto num_threads = getMmulNumThreads(ctx);
 
   auto [a, b, c, x_a, y_b] = MulOpen(ctx, x, y, true);
 
   // Zi = Ci + (X - A) dot Bi + Ai dot (Y - B) + <(X - A) dot (Y - B)>
-  auto z = ring_add(ring_add(ring_mmul(x_a, b), ring_mmul(a, y_b)), c);
+  auto z = ring_add(ring_add(ring_mmul(x_a, b, num_threads),
+                             ring_mmul(a, y_b, num_threads)),
+                    c);
   if (comm->getRank() == 0) {
     // z += (X-A) * (Y-B);
-    ring_add_(z, ring_mmul(x_a, y_b));
+    ring_add_(z, ring_mmul(x_a, y_b, num_threads));
   }
   return z.as(x.eltype());
 }
@@ -132,6 +132,13 @@ void BeaverCache::DisableCache(const NdArrayRef& x) {
 
 NdArrayRef BeaverCache::ReadCache(const CacheMeta& meta,
                                   const NdArrayRef& x) const {
+  if (arena_ != nullptr) {
+    auto view = arena_->Get(meta.arena_handle);
+    SPU_ENFORCE(static_cast<size_t>(view->size()) ==
+                meta.replay.size * SizeOf(meta.replay.field));
+    return NdArrayRef(std::move(view), x.eltype(), x.shape());
+  }
+
   Beaver::Array ret_buf;
   ret_buf.resize(meta.replay.size * SizeOf(meta.replay.field));
   size_t read_size = 0;
@@ -155,6 +162,11 @@ NdArrayRef BeaverCache::ReadCache(const CacheMeta& meta,
 void BeaverCache::WriteCache(const NdArrayRef& x, const NdArrayRef& open_cache,
                              CacheMeta& meta) {
   SPU_ENFORCE(open_cache.isCompact());
+  if (arena_ != nullptr) {
+    meta.arena_handle = arena_->Put(open_cache);
+    return;
+  }
+
   const auto key_prefix = KeyPrefix(x);
   const size_t elsize = open_cache.elsize();
   size_t remain_size = elsize * open_cache.numel();
@@ -177,6 +189,10 @@ void BeaverCache::WriteCache(const NdArrayRef& x, const NdArrayRef& open_cache,
 }
 
 void BeaverCache::DropCache(const CacheMeta& meta) {
+  if (arena_ != nullptr) {
+    arena_->Drop(meta.arena_handle);
+    return;
+  }
   for (const auto& k : meta.leveldb_keys) {
     auto status = db_->Delete(leveldb::WriteOptions(), k);
     SPU_ENFORCE(status.ok());
@@ -184,6 +200,9 @@ void BeaverCache::DropCache(const CacheMeta& meta) {
 }
 
 void BeaverCache::LazyInitCacheDB() {
+  if (arena_ != nullptr) {
+    return;
+  }
   std::call_once(db_lazy_once_flag_, [&]() {
     leveldb::DB* db = nullptr;
     leveldb::Options options;
@@ -26,16 +26,24 @@
 #include "leveldb/db.h"
 
 #include "libspu/core/ndarray_ref.h"
+#include "libspu/mpc/semi2k/beaver/beaver_cache_arena.h"
 #include "libspu/mpc/semi2k/beaver/beaver_interface.h"
 
 namespace spu::mpc::semi2k {
 
 class BeaverCache {
  public:
+  // When `memory_budget` is zero, opened values are kept in LevelDB, otherwise
+  // in a BeaverCacheArena with the given budget, which serves views instead of
+  // copies.
   // clang-format off
-  BeaverCache()
+  explicit BeaverCache(size_t memory_budget = 0)
       : cache_db_(fmt::format("BeaverCache.{}.{}.{}", getpid(), fmt::ptr(this),
-                              std::random_device()())) {};
+                              std::random_device()())) {
+    if (memory_budget > 0) {
+      arena_ = std::make_unique<BeaverCacheArena>(memory_budget);
+    }
+  };
   // clang-format on
   ~BeaverCache() {
     db_.reset();
@@ -71,6 +79,8 @@ class BeaverCache {
     Beaver::ReplayDesc replay;
     // data_shape_strides_idx
     std::vector<std::string> leveldb_keys;
+    // used instead of leveldb_keys when the arena is enabled.
+    BeaverCacheArena::Handle arena_handle = 0;
   };
 
   NdArrayRef ReadCache(const CacheMeta&, const NdArrayRef&) const;
@@ -82,6 +92,7 @@ class BeaverCache {
   mutable std::shared_mutex mutex_;
   std::unique_ptr<leveldb::DB> db_;
   const size_t cache_slice_size_ = 32 * 1024 * 1024;
+  std::unique_ptr<BeaverCacheArena> arena_;
   // for all NdArrayRef share same buffer (cache enabled NdArrayRef and slice of
   // this NdArrayRef) use NdArrayRef(data ptr with offset + shape + strides) to
   // track the specific cache.
@@ -0,0 +1,238 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_cache_arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <iterator>
+#include <map>
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::semi2k {
+
+// Temporary file holding the spilled entries, unlinked right away so it never
+// outlives the process. Ranges are page aligned, as mapping offsets must be,
+// free ones are reused first fit and the file is truncated when its tail is
+// freed.
+class BeaverCacheArena::SpillFile {
+ public:
+  SpillFile() {
+    auto path = (std::filesystem::temp_directory_path() / "BeaverCache.XXXXXX")
+                    .string();
+    fd_ = mkstemp(path.data());
+    SPU_ENFORCE(fd_ >= 0, "failed to create beaver cache spill file");
+    unlink(path.c_str());
+  }
+
+  ~SpillFile() { close(fd_); }
+
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+
+  int fd() const { return fd_; }
+
+  static size_t Extent(size_t bytes) {
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    return (bytes + page_size - 1) / page_size * page_size;
+  }
+
+  // Returns the offset of a free range of `len` bytes, len is page aligned.
+  size_t Allocate(size_t len) {
+    std::unique_lock lock(mutex_);
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      if (it->second < len) {
+        continue;
+      }
+      const auto [offset, free_len] = *it;
+      free_.erase(it);
+      if (free_len > len) {
+        free_.emplace(offset + len, free_len - len);
+      }
+      return offset;
+    }
+    size_ += len;
+    return size_ - len;
+  }
+
+  // Gives back a range once nothing maps it anymore.
+  void Release(size_t offset, size_t len) {
+    std::unique_lock lock(mutex_);
+    auto next = free_.lower_bound(offset);
+    if (next != free_.end() && offset + len == next->first) {
+      len += next->second;
+      next = free_.erase(next);
+    }
+    if (next != free_.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        offset = prev->first;
+        len += prev->second;
+        free_.erase(prev);
+      }
+    }
+    // a failed truncation only keeps the tail until it is reused.
+    if (offset + len == size_ && ftruncate(fd_, offset) == 0) {
+      size_ = offset;
+      return;
+    }
+    free_.emplace(offset, len);
+  }
+
+  size_t Size() const {
+    std::unique_lock lock(mutex_);
+    return size_;
+  }
+
+ private:
+  int fd_ = -1;
+
+  mutable std::mutex mutex_;
+  size_t size_ = 0;
+  // free ranges, offset -> length, never adjacent to each other.
+  std::map<size_t, size_t> free_;
+};
+
+struct BeaverCacheArena::Mapping {
+  void* addr = nullptr;
+  size_t size = 0;
+  std::shared_ptr<SpillFile> file;
+  size_t offset = 0;
+
+  ~Mapping() {
+    if (addr != nullptr) {
+      munmap(addr, size);
+      file->Release(offset, SpillFile::Extent(size));
+    }
+  }
+};
+
+BeaverCacheArena::BeaverCacheArena(size_t memory_budget)
+    : memory_budget_(memory_budget) {}
+
+BeaverCacheArena::~BeaverCacheArena() = default;
+
+BeaverCacheArena::Handle BeaverCacheArena::Put(const NdArrayRef& arr) {
+  SPU_ENFORCE(arr.isCompact());
+  auto memory = std::make_shared<yacl::Buffer>(arr.data(),
+                                               arr.numel() * arr.elsize());
+
+  std::unique_lock lock(mutex_);
+  const Handle handle = next_handle_++;
+  auto& entry = entries_[handle];
+  entry.size = memory->size();
+  entry.memory = std::move(memory);
+  lru_.push_front(handle);
+  entry.lru_pos = lru_.begin();
+  memory_usage_ += entry.size;
+
+  Shrink();
+  return handle;
+}
+
+std::shared_ptr<yacl::Buffer> BeaverCacheArena::Get(Handle handle) {
+  std::unique_lock lock(mutex_);
+  auto it = entries_.find(handle);
+  SPU_ENFORCE(it != entries_.end(), "beaver cache entry {} not found", handle);
+  auto& entry = it->second;
+
+  // The view holds the backing memory, so it outlives Drop and spilling.
+  if (entry.memory != nullptr) {
+    lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    return std::make_shared<yacl::Buffer>(
+        entry.memory->data(), entry.size,
+        [memory = entry.memory](void*) {});
+  }
+  SPU_ENFORCE(entry.mapping != nullptr);
+  return std::make_shared<yacl::Buffer>(entry.mapping->addr, entry.size,
+                                        [mapping = entry.mapping](void*) {});
+}
+
+void BeaverCacheArena::Drop(Handle handle) {
+  std::unique_lock lock(mutex_);
+  auto it = entries_.find(handle);
+  if (it == entries_.end()) {
+    return;
+  }
+  if (it->second.memory != nullptr) {
+    lru_.erase(it->second.lru_pos);
+    memory_usage_ -= it->second.size;
+  }
+  entries_.erase(it);
+}
+
+size_t BeaverCacheArena::MemoryUsage() const {
+  std::unique_lock lock(mutex_);
+  return memory_usage_;
+}
+
+size_t BeaverCacheArena::SpilledBytes() const {
+  std::unique_lock lock(mutex_);
+  return spill_file_ != nullptr ? spill_file_->Size() : 0;
+}
+
+void BeaverCacheArena::Shrink() {
+  while (memory_usage_ > memory_budget_ && !lru_.empty()) {
+    auto& entry = entries_.at(lru_.back());
+    if (entry.size != 0) {
+      // an empty buffer has nothing to map and is kept.
+      entry.mapping = Spill(*entry.memory);
+      entry.memory.reset();
+    }
+    lru_.pop_back();
+    memory_usage_ -= entry.size;
+  }
+}
+
+std::shared_ptr<BeaverCacheArena::Mapping> BeaverCacheArena::Spill(
+    const yacl::Buffer& buf) {
+  if (spill_file_ == nullptr) {
+    spill_file_ = std::make_shared<SpillFile>();
+  }
+
+  const size_t size = buf.size();
+  const size_t offset = spill_file_->Allocate(SpillFile::Extent(size));
+
+  const auto* data = buf.data<char>();
+  size_t written = 0;
+  while (written < size) {
+    auto ret = pwrite(spill_file_->fd(), data + written, size - written,
+                      offset + written);
+    if (ret <= 0) {
+      spill_file_->Release(offset, SpillFile::Extent(size));
+      SPU_THROW("failed to write beaver cache spill file");
+    }
+    written += ret;
+  }
+
+  // Private mapping, pages are loaded from the file on demand.
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    spill_file_->fd(), offset);
+  if (addr == MAP_FAILED) {
+    spill_file_->Release(offset, SpillFile::Extent(size));
+    SPU_THROW("failed to map beaver cache spill file");
+  }
+  auto mapping = std::make_shared<Mapping>();
+  mapping->addr = addr;
+  mapping->size = size;
+  mapping->file = spill_file_;
+  mapping->offset = offset;
+  return mapping;
+}
+
+}  // namespace spu::mpc::semi2k
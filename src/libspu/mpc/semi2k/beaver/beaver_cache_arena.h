@@ -0,0 +1,90 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "yacl/base/buffer.h"
+
+#include "libspu/core/ndarray_ref.h"
+
+namespace spu::mpc::semi2k {
+
+// Backing store of BeaverCache which hands out views instead of copies.
+//
+// Entries are kept in memory up to `memory_budget` bytes, least recently used
+// entries beyond the budget are spilled to a temporary file and served from a
+// private mapping of it. Entries are never dropped on pressure, since all
+// parties must agree on whether a cache hits. The file range of a spilled
+// entry is reused, or truncated away, once the entry is dropped and its views
+// are gone.
+//
+// Views share memory with the cache, callers must not update them in place.
+class BeaverCacheArena {
+ public:
+  using Handle = size_t;
+
+  explicit BeaverCacheArena(size_t memory_budget);
+  ~BeaverCacheArena();
+
+  BeaverCacheArena(const BeaverCacheArena&) = delete;
+  BeaverCacheArena& operator=(const BeaverCacheArena&) = delete;
+
+  // Copies a compact array into the arena.
+  Handle Put(const NdArrayRef& arr);
+
+  // Returns a view of the entry, the view stays valid after Drop.
+  std::shared_ptr<yacl::Buffer> Get(Handle handle);
+
+  void Drop(Handle handle);
+
+  // bytes of entries held in memory.
+  size_t MemoryUsage() const;
+  // bytes of the spill file, including ranges waiting to be reused.
+  size_t SpilledBytes() const;
+
+ private:
+  class SpillFile;
+  struct Mapping;
+
+  struct Entry {
+    size_t size = 0;
+    // exactly one of them is set, except for empty entries.
+    std::shared_ptr<yacl::Buffer> memory;
+    std::shared_ptr<Mapping> mapping;
+    std::list<Handle>::iterator lru_pos;
+  };
+
+  // spills least recently used entries until memory usage is within budget.
+  void Shrink();
+  std::shared_ptr<Mapping> Spill(const yacl::Buffer& buf);
+
+  const size_t memory_budget_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Handle, Entry> entries_;
+  // in-memory entries, most recently used first.
+  std::list<Handle> lru_;
+  Handle next_handle_ = 0;
+  size_t memory_usage_ = 0;
+
+  // lazily created, shared with the mappings which give their range back.
+  std::shared_ptr<SpillFile> spill_file_;
+};
+
+}  // namespace spu::mpc::semi2k
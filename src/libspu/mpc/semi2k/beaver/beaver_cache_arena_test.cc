@@ -0,0 +1,127 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_cache_arena.h"
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/utils/ring_ops.h"
+
+namespace spu::mpc::semi2k {
+
+namespace {
+
+constexpr FieldType kField = FieldType::FM64;
+constexpr int64_t kNumel = 1000;
+constexpr size_t kBytes = kNumel * 8;
+
+NdArrayRef view(const std::shared_ptr<yacl::Buffer>& buf,
+                const NdArrayRef& like) {
+  return NdArrayRef(buf, like.eltype(), like.shape());
+}
+
+}  // namespace
+
+TEST(BeaverCacheArenaTest, Spill) {
+  // room for two entries in memory.
+  BeaverCacheArena arena(2 * kBytes);
+
+  std::vector<NdArrayRef> arrs;
+  std::vector<BeaverCacheArena::Handle> handles;
+  for (size_t idx = 0; idx < 3; ++idx) {
+    arrs.push_back(ring_rand(kField, {kNumel}));
+    handles.push_back(arena.Put(arrs.back()));
+  }
+
+  // the first entry is the least recently used one.
+  EXPECT_EQ(arena.MemoryUsage(), 2 * kBytes);
+  EXPECT_GE(arena.SpilledBytes(), kBytes);
+
+  for (size_t idx = 0; idx < 3; ++idx) {
+    EXPECT_TRUE(
+        ring_all_equal(view(arena.Get(handles[idx]), arrs[idx]), arrs[idx]));
+  }
+
+  // touching entry 1 makes entry 2 the next one to spill.
+  arena.Get(handles[1]);
+  arrs.push_back(ring_rand(kField, {kNumel}));
+  handles.push_back(arena.Put(arrs.back()));
+  EXPECT_EQ(arena.MemoryUsage(), 2 * kBytes);
+  EXPECT_GE(arena.SpilledBytes(), 2 * kBytes);
+
+  for (size_t idx = 0; idx < arrs.size(); ++idx) {
+    EXPECT_TRUE(
+        ring_all_equal(view(arena.Get(handles[idx]), arrs[idx]), arrs[idx]));
+  }
+}
+
+TEST(BeaverCacheArenaTest, ViewOutlivesDrop) {
+  BeaverCacheArena arena(kBytes);
+
+  auto in_memory = ring_rand(kField, {kNumel});
+  auto spilled = ring_rand(kField, {kNumel});
+  auto spilled_handle = arena.Put(spilled);
+  auto in_memory_handle = arena.Put(in_memory);
+
+  auto in_memory_view = arena.Get(in_memory_handle);
+  auto spilled_view = arena.Get(spilled_handle);
+  arena.Drop(in_memory_handle);
+  arena.Drop(spilled_handle);
+  EXPECT_EQ(arena.MemoryUsage(), 0);
+
+  EXPECT_TRUE(ring_all_equal(view(in_memory_view, in_memory), in_memory));
+  EXPECT_TRUE(ring_all_equal(view(spilled_view, spilled), spilled));
+}
+
+TEST(BeaverCacheArenaTest, SpillFileIsReused) {
+  // one entry in memory, the others are spilled.
+  BeaverCacheArena arena(kBytes);
+  // spilled entries take whole pages.
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t extent = (kBytes + page_size - 1) / page_size * page_size;
+
+  std::vector<NdArrayRef> arrs;
+  for (size_t idx = 0; idx < 4; ++idx) {
+    arrs.push_back(ring_rand(kField, {kNumel}));
+  }
+  for (size_t round = 0; round < 100; ++round) {
+    std::vector<BeaverCacheArena::Handle> handles;
+    for (size_t idx = 0; idx < 3; ++idx) {
+      handles.push_back(arena.Put(arrs[idx]));
+    }
+    EXPECT_EQ(arena.SpilledBytes(), 2 * extent);
+
+    // the range of entry 0 is reused by entry 2.
+    arena.Drop(handles[0]);
+    handles.push_back(arena.Put(arrs[3]));
+    EXPECT_EQ(arena.SpilledBytes(), 2 * extent);
+
+    // a view keeps the range of a dropped entry.
+    auto pinned = arena.Get(handles[1]);
+    for (size_t idx = 1; idx < 4; ++idx) {
+      EXPECT_TRUE(
+          ring_all_equal(view(arena.Get(handles[idx]), arrs[idx]), arrs[idx]));
+      arena.Drop(handles[idx]);
+    }
+    EXPECT_EQ(arena.SpilledBytes(), 2 * extent);
+    EXPECT_TRUE(ring_all_equal(view(pinned, arrs[1]), arrs[1]));
+
+    pinned.reset();
+    EXPECT_EQ(arena.SpilledBytes(), 0);
+  }
+}
+
+}  // namespace spu::mpc::semi2k
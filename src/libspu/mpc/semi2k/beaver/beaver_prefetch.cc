@@ -0,0 +1,246 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_prefetch.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::semi2k {
+
+BeaverPrefetch::BeaverPrefetch(std::unique_ptr<Beaver> beaver, size_t depth)
+    : fallback_(std::move(beaver)), depth_(depth) {
+  SPU_ENFORCE(fallback_ != nullptr);
+  SPU_ENFORCE(depth_ > 0, "prefetch depth should be positive");
+}
+
+BeaverPrefetch::~BeaverPrefetch() {
+  {
+    std::unique_lock lk(mu_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  std::unique_lock lk(thread_mu_);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void BeaverPrefetch::produceLoop() {
+  while (true) {
+    Request req;
+    {
+      std::unique_lock lk(mu_);
+      cv_.wait(lk, [this] {
+        return stopped_ || num_produced_ >= plan_.size() ||
+               num_produced_ < depth_;
+      });
+      if (stopped_ || num_produced_ >= plan_.size()) {
+        // the next hint starts a new thread.
+        running_ = false;
+        return;
+      }
+      req = plan_[num_produced_].req;
+    }
+
+    std::vector<Array> bufs;
+    try {
+      bufs = evalBeaverRequest(producer_.get(), req);
+    } catch (...) {
+      std::unique_lock lk(mu_);
+      error_ = std::current_exception();
+      cv_.notify_all();
+      return;
+    }
+
+    {
+      // The consumer only erases ready entries, so the entry being generated
+      // is still at index num_produced_.
+      std::unique_lock lk(mu_);
+      auto& entry = plan_[num_produced_];
+      entry.bufs = std::move(bufs);
+      entry.ready = true;
+      num_produced_++;
+    }
+    cv_.notify_all();
+  }
+}
+
+void BeaverPrefetch::Hint(absl::Span<const Request> requests) {
+  bool start = false;
+  {
+    std::unique_lock lk(mu_);
+    for (const auto& req : requests) {
+      if (req.kind == Kind::PermPair) {
+        continue;
+      }
+      plan_.push_back(Entry{req});
+    }
+    if (!running_ && error_ == nullptr && num_produced_ < plan_.size()) {
+      running_ = true;
+      start = true;
+    }
+  }
+
+  if (start) {
+    std::unique_lock lk(thread_mu_);
+    // the previous thread found nothing to generate, it is exiting.
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (producer_ == nullptr) {
+      // spawned in the caller's thread, in hint order, like any other spawn.
+      producer_ = fallback_->Spawn();
+    }
+    thread_ = std::thread(&BeaverPrefetch::produceLoop, this);
+  }
+  cv_.notify_all();
+}
+
+BeaverPrefetch::Stats BeaverPrefetch::GetStats() {
+  std::unique_lock lk(mu_);
+  return stats_;
+}
+
+std::optional<std::vector<Beaver::Array>> BeaverPrefetch::tryTake(
+    const Request& req) {
+  std::unique_lock lk(mu_);
+
+  // Only look within the window the producer may run ahead, a request which
+  // matches nothing there is served by the fallback beaver.
+  const size_t window = std::min(plan_.size(), depth_);
+  size_t idx = 0;
+  while (idx < window && !(plan_[idx].req == req)) {
+    idx++;
+  }
+  if (idx == window) {
+    stats_.misses++;
+    return std::nullopt;
+  }
+
+  if (!plan_[idx].ready) {
+    stats_.stalls++;
+    cv_.wait(lk, [&] { return plan_[idx].ready || error_ != nullptr; });
+    if (!plan_[idx].ready) {
+      std::rethrow_exception(error_);
+    }
+  }
+  stats_.hits++;
+  stats_.dropped += idx;
+
+  auto bufs = std::move(plan_[idx].bufs);
+  plan_.erase(plan_.begin(), plan_.begin() + idx + 1);
+  num_produced_ -= idx + 1;
+  lk.unlock();
+
+  // Wake the producer, the window moved.
+  cv_.notify_all();
+  return bufs;
+}
+
+BeaverPrefetch::Triple BeaverPrefetch::Mul(FieldType field, int64_t size,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc,
+                                           ElementType eltype) {
+  // Replayed operands are bound to the beaver that recorded them.
+  if (x_desc == nullptr && y_desc == nullptr && eltype == ElementType::kRing) {
+    if (auto bufs = tryTake({Kind::Mul, field, size})) {
+      return toTriple(std::move(*bufs));
+    }
+  }
+  return fallback_->Mul(field, size, x_desc, y_desc, eltype);
+}
+
+BeaverPrefetch::Pair BeaverPrefetch::MulPriv(FieldType field, int64_t size,
+                                             ElementType eltype) {
+  if (eltype == ElementType::kRing) {
+    if (auto bufs = tryTake({Kind::MulPriv, field, size})) {
+      return toPair(std::move(*bufs));
+    }
+  }
+  return fallback_->MulPriv(field, size, eltype);
+}
+
+BeaverPrefetch::Pair BeaverPrefetch::Square(FieldType field, int64_t size,
+                                            ReplayDesc* x_desc) {
+  if (x_desc == nullptr) {
+    if (auto bufs = tryTake({Kind::Square, field, size})) {
+      return toPair(std::move(*bufs));
+    }
+  }
+  return fallback_->Square(field, size, x_desc);
+}
+
+BeaverPrefetch::Triple BeaverPrefetch::And(int64_t size) {
+  if (auto bufs = tryTake({Kind::And, FT_INVALID, size})) {
+    return toTriple(std::move(*bufs));
+  }
+  return fallback_->And(size);
+}
+
+BeaverPrefetch::Triple BeaverPrefetch::Dot(FieldType field, int64_t m,
+                                           int64_t n, int64_t k,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc) {
+  if (x_desc == nullptr && y_desc == nullptr) {
+    if (auto bufs = tryTake({Kind::Dot, field, m, n, k})) {
+      return toTriple(std::move(*bufs));
+    }
+  }
+  return fallback_->Dot(field, m, n, k, x_desc, y_desc);
+}
+
+BeaverPrefetch::Pair BeaverPrefetch::Trunc(FieldType field, int64_t size,
+                                           size_t bits) {
+  if (auto bufs = tryTake({Kind::Trunc, field, size, 0, 0, bits})) {
+    return toPair(std::move(*bufs));
+  }
+  return fallback_->Trunc(field, size, bits);
+}
+
+BeaverPrefetch::Triple BeaverPrefetch::TruncPr(FieldType field, int64_t size,
+                                               size_t bits) {
+  if (auto bufs = tryTake({Kind::TruncPr, field, size, 0, 0, bits})) {
+    return toTriple(std::move(*bufs));
+  }
+  return fallback_->TruncPr(field, size, bits);
+}
+
+BeaverPrefetch::Array BeaverPrefetch::RandBit(FieldType field, int64_t size) {
+  if (auto bufs = tryTake({Kind::RandBit, field, size})) {
+    SPU_ENFORCE(bufs->size() == 1);
+    return std::move(bufs->front());
+  }
+  return fallback_->RandBit(field, size);
+}
+
+BeaverPrefetch::PremTriple BeaverPrefetch::PermPair(FieldType field,
+                                                    int64_t size,
+                                                    size_t perm_rank) {
+  // Permutation pairs communicate with the perm rank, they are not prefetched.
+  return fallback_->PermPair(field, size, perm_rank);
+}
+
+std::unique_ptr<Beaver> BeaverPrefetch::Spawn() { return fallback_->Spawn(); }
+
+BeaverPrefetch::Pair BeaverPrefetch::Eqz(FieldType field, int64_t size) {
+  if (auto bufs = tryTake({Kind::Eqz, field, size})) {
+    return toPair(std::move(*bufs));
+  }
+  return fallback_->Eqz(field, size);
+}
+
+}  // namespace spu::mpc::semi2k
@@ -0,0 +1,163 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "libspu/mpc/semi2k/beaver/beaver_interface.h"
+#include "libspu/mpc/semi2k/beaver/beaver_request.h"
+
+namespace spu::mpc::semi2k {
+
+// A Beaver decorator which generates correlations ahead of time.
+//
+// The caller hints the sequence of upcoming requests, a background thread
+// generates them in hinted order with a dedicated (spawned) beaver, so an
+// online request which matches the hint only waits for the opening round.
+//
+// The producer is spawned and its thread started by the first hint, and the
+// thread exits once every hinted request is generated, so an instance which
+// is never hinted, e.g. in a forked state, costs nothing.
+//
+// All parties must observe the same sequence of hints and requests (which is
+// the case for SPMD execution). Whether a request is served from the pool is
+// decided from the hint and the request sequence only, never from timing, so
+// the underlying beavers of all parties see the same call sequence:
+//  - the producer beaver serves every hinted request, in hinted order.
+//  - the fallback beaver serves requests which do not match the hint.
+class BeaverPrefetch final : public Beaver {
+ public:
+  using Kind = BeaverKind;
+  using Request = BeaverRequest;
+
+  struct Stats {
+    // Number of requests served from prefetched correlations.
+    size_t hits = 0;
+    // Number of hits which still had to wait for the producer.
+    size_t stalls = 0;
+    // Number of requests not matching the hint.
+    size_t misses = 0;
+    // Number of hinted requests skipped by the online sequence.
+    size_t dropped = 0;
+
+    Stats operator-(const Stats& rhs) const {
+      return {hits - rhs.hits, stalls - rhs.stalls, misses - rhs.misses,
+              dropped - rhs.dropped};
+    }
+
+    Stats& operator+=(const Stats& rhs) {
+      hits += rhs.hits;
+      stalls += rhs.stalls;
+      misses += rhs.misses;
+      dropped += rhs.dropped;
+      return *this;
+    }
+  };
+
+ private:
+  struct Entry {
+    Request req;
+    bool ready = false;
+    // Triple/Pair/Array flattened.
+    std::vector<Array> bufs;
+  };
+
+  // serves requests not matching the hint, also used by Spawn.
+  std::unique_ptr<Beaver> fallback_;
+  // serves hinted requests on the background thread, spawned by the first
+  // hint.
+  std::unique_ptr<Beaver> producer_;
+
+  // max number of hinted requests generated ahead of the online cursor.
+  const size_t depth_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // hinted requests not consumed yet, front is the online cursor.
+  std::deque<Entry> plan_;
+  // number of leading entries in plan_ already generated.
+  size_t num_produced_ = 0;
+  // set while the producer thread has hinted requests to generate.
+  bool running_ = false;
+  bool stopped_ = false;
+  std::exception_ptr error_;
+  Stats stats_;
+
+  // guards thread_ and producer_, which are replaced by Hint.
+  std::mutex thread_mu_;
+  std::thread thread_;
+
+  void produceLoop();
+
+  // Returns generated buffers of a hinted request, or nullopt if the request
+  // is not within the next `depth_` hinted requests.
+  std::optional<std::vector<Array>> tryTake(const Request& req);
+
+ public:
+  // `beaver` is used for requests which are not hinted, a producer beaver is
+  // spawned from it.
+  BeaverPrefetch(std::unique_ptr<Beaver> beaver, size_t depth);
+
+  size_t depth() const { return depth_; }
+
+  ~BeaverPrefetch() override;
+
+  // Append upcoming requests to the hint, PermPair requests are ignored. Must
+  // not race with requests, hints and requests are ordered by the caller.
+  void Hint(absl::Span<const Request> requests);
+
+  Stats GetStats();
+
+  Triple Mul(FieldType field, int64_t size, ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr,
+             ElementType eltype = ElementType::kRing) override;
+
+  Pair MulPriv(FieldType field, int64_t size,
+               ElementType eltype = ElementType::kRing) override;
+
+  Pair Square(FieldType field, int64_t size,
+              ReplayDesc* x_desc = nullptr) override;
+
+  Triple And(int64_t size) override;
+
+  Triple Dot(FieldType field, int64_t m, int64_t n, int64_t k,
+             ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr) override;
+
+  Pair Trunc(FieldType field, int64_t size, size_t bits) override;
+
+  Triple TruncPr(FieldType field, int64_t size, size_t bits) override;
+
+  Array RandBit(FieldType field, int64_t size) override;
+
+  PremTriple PermPair(FieldType field, int64_t size, size_t perm_rank) override;
+
+  // Spawned beavers do not prefetch, Semi2kState::fork wraps them in their own
+  // BeaverPrefetch.
+  std::unique_ptr<Beaver> Spawn() override;
+
+  Pair Eqz(FieldType field, int64_t size) override;
+};
+
+}  // namespace spu::mpc::semi2k
@@ -0,0 +1,122 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_prefetch.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/semi2k/beaver/beaver_impl/beaver_tfp.h"
+#include "libspu/mpc/utils/ring_ops.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::mpc::semi2k {
+
+namespace {
+
+using Kind = BeaverPrefetch::Kind;
+
+constexpr FieldType kField = FieldType::FM64;
+constexpr size_t kWorldSize = 2;
+
+NdArrayRef open(std::vector<Beaver::Array>& shares, int64_t numel) {
+  auto ret = ring_zeros(kField, {numel});
+  for (auto& share : shares) {
+    EXPECT_EQ(share.size(), numel * SizeOf(kField));
+    NdArrayRef arr(std::make_shared<yacl::Buffer>(std::move(share)),
+                   ret.eltype(), {numel});
+    ring_add_(ret, arr);
+  }
+  return ret;
+}
+
+}  // namespace
+
+TEST(BeaverPrefetchTest, Hint) {
+  const int64_t kNumel = 10;
+  const int64_t kBits = 3;
+
+  std::vector<Beaver::Triple> muls(kWorldSize);
+  std::vector<Beaver::Pair> truncs(kWorldSize);
+  std::vector<Beaver::Triple> ands(kWorldSize);
+  std::vector<BeaverPrefetch::Stats> stats(kWorldSize);
+
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverPrefetch beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx), 2);
+                    std::vector<BeaverPrefetch::Request> hint = {
+                        {Kind::Mul, kField, kNumel},
+                        {Kind::Dot, kField, 2, 3, 4},
+                        {Kind::Trunc, kField, kNumel, 0, 0, kBits},
+                    };
+                    beaver.Hint(hint);
+
+                    const auto rank = lctx->Rank();
+                    // hit
+                    muls[rank] = beaver.Mul(kField, kNumel);
+                    // miss, served by the fallback beaver
+                    ands[rank] = beaver.And(kNumel);
+                    // hit, the hinted dot is dropped
+                    truncs[rank] = beaver.Trunc(kField, kNumel, kBits);
+                    stats[rank] = beaver.GetStats();
+                  });
+
+  for (const auto& stat : stats) {
+    EXPECT_EQ(stat.hits, 2);
+    EXPECT_EQ(stat.misses, 1);
+    EXPECT_EQ(stat.dropped, 1);
+  }
+
+  {
+    std::vector<Beaver::Array> a;
+    std::vector<Beaver::Array> b;
+    std::vector<Beaver::Array> c;
+    for (auto& [a_buf, b_buf, c_buf] : muls) {
+      a.emplace_back(std::move(a_buf));
+      b.emplace_back(std::move(b_buf));
+      c.emplace_back(std::move(c_buf));
+    }
+    EXPECT_TRUE(ring_all_equal(
+        ring_mul(open(a, kNumel), open(b, kNumel)), open(c, kNumel)));
+  }
+
+  {
+    std::vector<Beaver::Array> r;
+    std::vector<Beaver::Array> rb;
+    for (auto& [r_buf, rb_buf] : truncs) {
+      r.emplace_back(std::move(r_buf));
+      rb.emplace_back(std::move(rb_buf));
+    }
+    EXPECT_TRUE(ring_all_equal(ring_arshift(open(r, kNumel), {kBits}),
+                               open(rb, kNumel), 0));
+  }
+
+  {
+    std::vector<uint8_t> open_a(kNumel);
+    std::vector<uint8_t> open_b(kNumel);
+    std::vector<uint8_t> open_c(kNumel);
+    for (const auto& [a, b, c] : ands) {
+      for (int64_t i = 0; i < kNumel; i++) {
+        open_a[i] ^= a.data<uint8_t>()[i];
+        open_b[i] ^= b.data<uint8_t>()[i];
+        open_c[i] ^= c.data<uint8_t>()[i];
+      }
+    }
+    for (int64_t i = 0; i < kNumel; i++) {
+      EXPECT_EQ(open_c[i], open_a[i] & open_b[i]);
+    }
+  }
+}
+
+}  // namespace spu::mpc::semi2k
@@ -0,0 +1,102 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_request.h"
+
+#include <utility>
+
+#include "fmt/format.h"
+#include "magic_enum.hpp"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::semi2k {
+
+std::string toString(const BeaverRequest& req) {
+  return fmt::format("{}(field={}, size={}, n={}, k={}, bits={}, perm_rank={})",
+                     magic_enum::enum_name(req.kind), req.field, req.size,
+                     req.n, req.k, req.bits, req.perm_rank);
+}
+
+std::vector<Beaver::Array> evalBeaverRequest(Beaver* beaver,
+                                             const BeaverRequest& req) {
+  std::vector<Beaver::Array> bufs;
+  auto push_triple = [&](Beaver::Triple&& t) {
+    bufs.emplace_back(std::move(std::get<0>(t)));
+    bufs.emplace_back(std::move(std::get<1>(t)));
+    bufs.emplace_back(std::move(std::get<2>(t)));
+  };
+  auto push_pair = [&](Beaver::Pair&& p) {
+    bufs.emplace_back(std::move(p.first));
+    bufs.emplace_back(std::move(p.second));
+  };
+
+  switch (req.kind) {
+    case BeaverKind::Mul:
+      push_triple(beaver->Mul(req.field, req.size));
+      break;
+    case BeaverKind::MulPriv:
+      push_pair(beaver->MulPriv(req.field, req.size));
+      break;
+    case BeaverKind::Square:
+      push_pair(beaver->Square(req.field, req.size));
+      break;
+    case BeaverKind::And:
+      push_triple(beaver->And(req.size));
+      break;
+    case BeaverKind::Dot:
+      push_triple(beaver->Dot(req.field, req.size, req.n, req.k));
+      break;
+    case BeaverKind::Trunc:
+      push_pair(beaver->Trunc(req.field, req.size, req.bits));
+      break;
+    case BeaverKind::TruncPr:
+      push_triple(beaver->TruncPr(req.field, req.size, req.bits));
+      break;
+    case BeaverKind::RandBit:
+      bufs.emplace_back(beaver->RandBit(req.field, req.size));
+      break;
+    case BeaverKind::PermPair: {
+      auto [a, b, pi] = beaver->PermPair(req.field, req.size, req.perm_rank);
+      bufs.emplace_back(std::move(a));
+      bufs.emplace_back(std::move(b));
+      bufs.emplace_back(pi.data(), pi.size() * sizeof(int64_t));
+      break;
+    }
+    case BeaverKind::Eqz:
+      push_pair(beaver->Eqz(req.field, req.size));
+      break;
+  }
+  return bufs;
+}
+
+Beaver::Triple toTriple(std::vector<Beaver::Array>&& bufs) {
+  SPU_ENFORCE(bufs.size() == 3);
+  return {std::move(bufs[0]), std::move(bufs[1]), std::move(bufs[2])};
+}
+
+Beaver::Pair toPair(std::vector<Beaver::Array>&& bufs) {
+  SPU_ENFORCE(bufs.size() == 2);
+  return {std::move(bufs[0]), std::move(bufs[1])};
+}
+
+Beaver::PremTriple toPremTriple(std::vector<Beaver::Array>&& bufs) {
+  SPU_ENFORCE(bufs.size() == 3);
+  SPU_ENFORCE(bufs[2].size() % sizeof(int64_t) == 0);
+  const auto* pi = bufs[2].data<int64_t>();
+  return {std::move(bufs[0]), std::move(bufs[1]),
+          Index(pi, pi + bufs[2].size() / sizeof(int64_t))};
+}
+
+}  // namespace spu::mpc::semi2k
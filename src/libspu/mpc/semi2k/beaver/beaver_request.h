@@ -0,0 +1,72 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "libspu/mpc/semi2k/beaver/beaver_interface.h"
+
+namespace spu::mpc::semi2k {
+
+enum class BeaverKind {
+  Mul,
+  MulPriv,
+  Square,
+  And,
+  Dot,
+  Trunc,
+  TruncPr,
+  RandBit,
+  PermPair,
+  Eqz,
+};
+
+// A single Beaver request without replay descriptors, fields not used by
+// `kind` should be left as default.
+struct BeaverRequest {
+  BeaverKind kind = BeaverKind::Mul;
+  FieldType field = FT_INVALID;
+  // number of elements, or number of bytes for And.
+  int64_t size = 0;
+  // Dot only, size is m.
+  int64_t n = 0;
+  int64_t k = 0;
+  // Trunc/TruncPr only.
+  size_t bits = 0;
+  // PermPair only.
+  size_t perm_rank = 0;
+
+  bool operator==(const BeaverRequest& other) const {
+    return kind == other.kind && field == other.field && size == other.size &&
+           n == other.n && k == other.k && bits == other.bits &&
+           perm_rank == other.perm_rank;
+  }
+};
+
+std::string toString(const BeaverRequest& req);
+
+// Evaluates `req` on `beaver`, the result is flattened into buffers, i.e. 3
+// buffers for a Triple, 2 for a Pair and 1 for an Array. The permutation of
+// PermPair is stored as int64 elements.
+std::vector<Beaver::Array> evalBeaverRequest(Beaver* beaver,
+                                             const BeaverRequest& req);
+
+Beaver::Triple toTriple(std::vector<Beaver::Array>&& bufs);
+
+Beaver::Pair toPair(std::vector<Beaver::Array>&& bufs);
+
+Beaver::PremTriple toPremTriple(std::vector<Beaver::Array>&& bufs);
+
+}  // namespace spu::mpc::semi2k
@@ -0,0 +1,356 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#include "fmt/format.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::semi2k {
+
+namespace {
+
+// Record layout, all integers are int64:
+//   magic, kind, field, size, n, k, bits, perm_rank, num_bufs,
+//   buf_size * num_bufs, padding, (buf_data, padding) * num_bufs
+// Buffers are aligned so views into the mapping can be used as ring elements.
+constexpr int64_t kRecordMagic = 0x53505542454156;  // "SPUBEAV"
+constexpr size_t kNumHeaderFields = 9;
+constexpr size_t kAlignment = 16;
+// A stream is renamed with this suffix once a reader claims it.
+constexpr char kConsumedSuffix[] = ".consumed";
+
+size_t alignUp(size_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::string streamPath(const std::string& dir, const std::string& stream) {
+  return fmt::format("{}/{}.bin", dir, stream);
+}
+
+std::string createStoreDir(std::string dir) {
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+}  // namespace
+
+BeaverStoreWriter::BeaverStoreWriter(const std::string& path)
+    : ofs_(path, std::ios::binary | std::ios::trunc) {
+  SPU_ENFORCE(ofs_.is_open(), "failed to open beaver store {}", path);
+}
+
+void BeaverStoreWriter::Append(const BeaverRequest& req,
+                               absl::Span<const Beaver::Array> bufs) {
+  auto write = [&](const void* data, size_t size) {
+    ofs_.write(static_cast<const char*>(data), static_cast<int64_t>(size));
+    offset_ += size;
+  };
+  auto pad = [&]() {
+    static const char kZeros[kAlignment] = {};
+    write(kZeros, alignUp(offset_) - offset_);
+  };
+
+  const int64_t header[kNumHeaderFields] = {
+      kRecordMagic,
+      static_cast<int64_t>(req.kind),
+      static_cast<int64_t>(req.field),
+      req.size,
+      req.n,
+      req.k,
+      static_cast<int64_t>(req.bits),
+      static_cast<int64_t>(req.perm_rank),
+      static_cast<int64_t>(bufs.size())};
+  write(header, sizeof(header));
+  for (const auto& buf : bufs) {
+    const int64_t size = buf.size();
+    write(&size, sizeof(size));
+  }
+  pad();
+  for (const auto& buf : bufs) {
+    write(buf.data(), buf.size());
+    pad();
+  }
+  SPU_ENFORCE(ofs_.good(), "failed to write beaver store");
+}
+
+struct BeaverStoreReader::Mapping {
+  void* addr = nullptr;
+  size_t size = 0;
+
+  ~Mapping() {
+    if (addr != nullptr) {
+      munmap(addr, size);
+    }
+  }
+};
+
+BeaverStoreReader::BeaverStoreReader(const std::string& path)
+    : mapping_(std::make_shared<Mapping>()) {
+  // Claim the stream before reading it, rename is atomic so at most one
+  // reader ever gets it, even when replays race.
+  const auto consumed = path + kConsumedSuffix;
+  if (rename(path.c_str(), consumed.c_str()) != 0) {
+    SPU_ENFORCE(!std::filesystem::exists(consumed),
+                "beaver store {} is already replayed, reusing correlations "
+                "breaks security",
+                path);
+    SPU_THROW("failed to claim beaver store {}: {}", path,
+              std::strerror(errno));
+  }
+
+  int fd = open(consumed.c_str(), O_RDONLY);
+  SPU_ENFORCE(fd >= 0, "failed to open beaver store {}", consumed);
+
+  struct stat st;
+  SPU_ENFORCE(fstat(fd, &st) == 0, "failed to stat beaver store {}", path);
+  mapping_->size = st.st_size;
+  if (mapping_->size > 0) {
+    // Private mapping, so in-place updates of served buffers stay in memory.
+    void* addr = mmap(nullptr, mapping_->size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, fd, 0);
+    SPU_ENFORCE(addr != MAP_FAILED, "failed to map beaver store {}", path);
+    mapping_->addr = addr;
+  }
+  close(fd);
+}
+
+bool BeaverStoreReader::Exhausted() const {
+  return offset_ >= mapping_->size;
+}
+
+std::vector<Beaver::Array> BeaverStoreReader::Next(const BeaverRequest& req) {
+  SPU_ENFORCE(!Exhausted(), "beaver store exhausted after {} records, at {}",
+              num_read_, toString(req));
+
+  auto* base = static_cast<std::byte*>(mapping_->addr);
+  auto read = [&](size_t size) {
+    SPU_ENFORCE(offset_ + size <= mapping_->size, "beaver store truncated");
+    auto* ptr = base + offset_;
+    offset_ += size;
+    return ptr;
+  };
+
+  const auto* header = reinterpret_cast<const int64_t*>(
+      read(kNumHeaderFields * sizeof(int64_t)));
+  SPU_ENFORCE(header[0] == kRecordMagic, "beaver store corrupted");
+
+  BeaverRequest stored;
+  stored.kind = static_cast<BeaverKind>(header[1]);
+  stored.field = static_cast<FieldType>(header[2]);
+  stored.size = header[3];
+  stored.n = header[4];
+  stored.k = header[5];
+  stored.bits = header[6];
+  stored.perm_rank = header[7];
+  SPU_ENFORCE(stored == req,
+              "beaver request #{} {} does not match the store {}, the store "
+              "is recorded from another program",
+              num_read_, toString(req), toString(stored));
+
+  const auto num_bufs = static_cast<size_t>(header[8]);
+  const auto* sizes =
+      reinterpret_cast<const int64_t*>(read(num_bufs * sizeof(int64_t)));
+  offset_ = alignUp(offset_);
+
+  std::vector<Beaver::Array> bufs;
+  bufs.reserve(num_bufs);
+  for (size_t idx = 0; idx < num_bufs; ++idx) {
+    auto* data = read(sizes[idx]);
+    offset_ = alignUp(offset_);
+    // The view keeps the mapping alive.
+    bufs.emplace_back(data, sizes[idx], [mapping = mapping_](void*) {});
+  }
+  num_read_++;
+  return bufs;
+}
+
+BeaverRecorder::BeaverRecorder(std::unique_ptr<Beaver> beaver, std::string dir,
+                               std::string stream)
+    : beaver_(std::move(beaver)),
+      dir_(createStoreDir(std::move(dir))),
+      stream_(std::move(stream)),
+      writer_(streamPath(dir_, stream_)) {}
+
+std::vector<Beaver::Array> BeaverRecorder::record(const BeaverRequest& req) {
+  auto bufs = evalBeaverRequest(beaver_.get(), req);
+  writer_.Append(req, bufs);
+  return bufs;
+}
+
+BeaverRecorder::Triple BeaverRecorder::Mul(FieldType field, int64_t size,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc,
+                                           ElementType eltype) {
+  if (x_desc != nullptr || y_desc != nullptr ||
+      eltype != ElementType::kRing) {
+    return beaver_->Mul(field, size, x_desc, y_desc, eltype);
+  }
+  return toTriple(record({BeaverKind::Mul, field, size}));
+}
+
+BeaverRecorder::Pair BeaverRecorder::MulPriv(FieldType field, int64_t size,
+                                             ElementType eltype) {
+  if (eltype != ElementType::kRing) {
+    return beaver_->MulPriv(field, size, eltype);
+  }
+  return toPair(record({BeaverKind::MulPriv, field, size}));
+}
+
+BeaverRecorder::Pair BeaverRecorder::Square(FieldType field, int64_t size,
+                                            ReplayDesc* x_desc) {
+  if (x_desc != nullptr) {
+    return beaver_->Square(field, size, x_desc);
+  }
+  return toPair(record({BeaverKind::Square, field, size}));
+}
+
+BeaverRecorder::Triple BeaverRecorder::And(int64_t size) {
+  return toTriple(record({BeaverKind::And, FT_INVALID, size}));
+}
+
+BeaverRecorder::Triple BeaverRecorder::Dot(FieldType field, int64_t m,
+                                           int64_t n, int64_t k,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc) {
+  if (x_desc != nullptr || y_desc != nullptr) {
+    return beaver_->Dot(field, m, n, k, x_desc, y_desc);
+  }
+  return toTriple(record({BeaverKind::Dot, field, m, n, k}));
+}
+
+BeaverRecorder::Pair BeaverRecorder::Trunc(FieldType field, int64_t size,
+                                           size_t bits) {
+  return toPair(record({BeaverKind::Trunc, field, size, 0, 0, bits}));
+}
+
+BeaverRecorder::Triple BeaverRecorder::TruncPr(FieldType field, int64_t size,
+                                               size_t bits) {
+  return toTriple(record({BeaverKind::TruncPr, field, size, 0, 0, bits}));
+}
+
+BeaverRecorder::Array BeaverRecorder::RandBit(FieldType field, int64_t size) {
+  auto bufs = record({BeaverKind::RandBit, field, size});
+  return std::move(bufs[0]);
+}
+
+BeaverRecorder::PremTriple BeaverRecorder::PermPair(FieldType field,
+                                                    int64_t size,
+                                                    size_t perm_rank) {
+  return toPremTriple(
+      record({BeaverKind::PermPair, field, size, 0, 0, 0, perm_rank}));
+}
+
+std::unique_ptr<Beaver> BeaverRecorder::Spawn() {
+  return std::make_unique<BeaverRecorder>(
+      beaver_->Spawn(), dir_, fmt::format("{}-{}", stream_, num_spawned_++));
+}
+
+BeaverRecorder::Pair BeaverRecorder::Eqz(FieldType field, int64_t size) {
+  return toPair(record({BeaverKind::Eqz, field, size}));
+}
+
+BeaverReplayer::BeaverReplayer(std::unique_ptr<Beaver> beaver, std::string dir,
+                               std::string stream)
+    : beaver_(std::move(beaver)),
+      dir_(std::move(dir)),
+      stream_(std::move(stream)),
+      reader_(streamPath(dir_, stream_)) {}
+
+BeaverReplayer::Triple BeaverReplayer::Mul(FieldType field, int64_t size,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc,
+                                           ElementType eltype) {
+  if (x_desc != nullptr || y_desc != nullptr ||
+      eltype != ElementType::kRing) {
+    return beaver_->Mul(field, size, x_desc, y_desc, eltype);
+  }
+  return toTriple(reader_.Next({BeaverKind::Mul, field, size}));
+}
+
+BeaverReplayer::Pair BeaverReplayer::MulPriv(FieldType field, int64_t size,
+                                             ElementType eltype) {
+  if (eltype != ElementType::kRing) {
+    return beaver_->MulPriv(field, size, eltype);
+  }
+  return toPair(reader_.Next({BeaverKind::MulPriv, field, size}));
+}
+
+BeaverReplayer::Pair BeaverReplayer::Square(FieldType field, int64_t size,
+                                            ReplayDesc* x_desc) {
+  if (x_desc != nullptr) {
+    return beaver_->Square(field, size, x_desc);
+  }
+  return toPair(reader_.Next({BeaverKind::Square, field, size}));
+}
+
+BeaverReplayer::Triple BeaverReplayer::And(int64_t size) {
+  return toTriple(reader_.Next({BeaverKind::And, FT_INVALID, size}));
+}
+
+BeaverReplayer::Triple BeaverReplayer::Dot(FieldType field, int64_t m,
+                                           int64_t n, int64_t k,
+                                           ReplayDesc* x_desc,
+                                           ReplayDesc* y_desc) {
+  if (x_desc != nullptr || y_desc != nullptr) {
+    return beaver_->Dot(field, m, n, k, x_desc, y_desc);
+  }
+  return toTriple(reader_.Next({BeaverKind::Dot, field, m, n, k}));
+}
+
+BeaverReplayer::Pair BeaverReplayer::Trunc(FieldType field, int64_t size,
+                                           size_t bits) {
+  return toPair(reader_.Next({BeaverKind::Trunc, field, size, 0, 0, bits}));
+}
+
+BeaverReplayer::Triple BeaverReplayer::TruncPr(FieldType field, int64_t size,
+                                               size_t bits) {
+  return toTriple(
+      reader_.Next({BeaverKind::TruncPr, field, size, 0, 0, bits}));
+}
+
+BeaverReplayer::Array BeaverReplayer::RandBit(FieldType field, int64_t size) {
+  auto bufs = reader_.Next({BeaverKind::RandBit, field, size});
+  SPU_ENFORCE(bufs.size() == 1);
+  return std::move(bufs[0]);
+}
+
+BeaverReplayer::PremTriple BeaverReplayer::PermPair(FieldType field,
+                                                    int64_t size,
+                                                    size_t perm_rank) {
+  return toPremTriple(
+      reader_.Next({BeaverKind::PermPair, field, size, 0, 0, 0, perm_rank}));
+}
+
+std::unique_ptr<Beaver> BeaverReplayer::Spawn() {
+  return std::make_unique<BeaverReplayer>(
+      beaver_->Spawn(), dir_, fmt::format("{}-{}", stream_, num_spawned_++));
+}
+
+BeaverReplayer::Pair BeaverReplayer::Eqz(FieldType field, int64_t size) {
+  return toPair(reader_.Next({BeaverKind::Eqz, field, size}));
+}
+
+}  // namespace spu::mpc::semi2k
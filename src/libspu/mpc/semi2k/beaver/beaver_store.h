@@ -0,0 +1,169 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "libspu/mpc/semi2k/beaver/beaver_interface.h"
+#include "libspu/mpc/semi2k/beaver/beaver_request.h"
+
+namespace spu::mpc::semi2k {
+
+// Offline/online split of correlated randomness.
+//
+// In the offline phase, the executable is run once (with placeholder inputs,
+// the request sequence of an MPC program does not depend on data) with a
+// BeaverRecorder, which persists every correlation into a store directory.
+// In the online phase, BeaverReplayer serves the same request sequence from
+// the store, without any generation cost.
+//
+// Each beaver instance owns one stream file in the store. Streams of spawned
+// beavers are named after the spawn path, e.g. "0-2-1" is the second spawn of
+// the third spawn of the root, which is deterministic since every instance
+// spawns in its own program order.
+//
+// Requests with replay descriptors are bound to the seeds of the beaver which
+// served them, they are always served by the wrapped beaver and not stored.
+//
+// WARNING: a store MUST only be replayed once, reusing correlations breaks
+// security. Readers enforce it by renaming every stream they open to
+// "<stream>.bin.consumed", a consumed stream can not be opened again.
+
+// Appends records to a stream file.
+class BeaverStoreWriter {
+ public:
+  explicit BeaverStoreWriter(const std::string& path);
+
+  void Append(const BeaverRequest& req, absl::Span<const Beaver::Array> bufs);
+
+ private:
+  std::ofstream ofs_;
+  // bytes written so far, used to align buffers in the file.
+  size_t offset_ = 0;
+};
+
+// Reads records of a stream file, buffers are copy-on-write views of a
+// private mapping of the file, so callers may modify them in place. Throws
+// when the stream is already consumed by another reader.
+class BeaverStoreReader {
+ public:
+  explicit BeaverStoreReader(const std::string& path);
+
+  // Returns the next record, which must match `req`.
+  std::vector<Beaver::Array> Next(const BeaverRequest& req);
+
+  bool Exhausted() const;
+
+ private:
+  struct Mapping;
+
+  std::shared_ptr<Mapping> mapping_;
+  size_t offset_ = 0;
+  size_t num_read_ = 0;
+};
+
+// Offline phase decorator, see above.
+class BeaverRecorder final : public Beaver {
+ public:
+  BeaverRecorder(std::unique_ptr<Beaver> beaver, std::string dir,
+                 std::string stream = "0");
+
+  Triple Mul(FieldType field, int64_t size, ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr,
+             ElementType eltype = ElementType::kRing) override;
+
+  Pair MulPriv(FieldType field, int64_t size,
+               ElementType eltype = ElementType::kRing) override;
+
+  Pair Square(FieldType field, int64_t size,
+              ReplayDesc* x_desc = nullptr) override;
+
+  Triple And(int64_t size) override;
+
+  Triple Dot(FieldType field, int64_t m, int64_t n, int64_t k,
+             ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr) override;
+
+  Pair Trunc(FieldType field, int64_t size, size_t bits) override;
+
+  Triple TruncPr(FieldType field, int64_t size, size_t bits) override;
+
+  Array RandBit(FieldType field, int64_t size) override;
+
+  PremTriple PermPair(FieldType field, int64_t size, size_t perm_rank) override;
+
+  std::unique_ptr<Beaver> Spawn() override;
+
+  Pair Eqz(FieldType field, int64_t size) override;
+
+ private:
+  std::vector<Array> record(const BeaverRequest& req);
+
+  std::unique_ptr<Beaver> beaver_;
+  const std::string dir_;
+  const std::string stream_;
+  size_t num_spawned_ = 0;
+  BeaverStoreWriter writer_;
+};
+
+// Online phase decorator, see above.
+class BeaverReplayer final : public Beaver {
+ public:
+  // `beaver` serves requests with replay descriptors.
+  BeaverReplayer(std::unique_ptr<Beaver> beaver, std::string dir,
+                 std::string stream = "0");
+
+  Triple Mul(FieldType field, int64_t size, ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr,
+             ElementType eltype = ElementType::kRing) override;
+
+  Pair MulPriv(FieldType field, int64_t size,
+               ElementType eltype = ElementType::kRing) override;
+
+  Pair Square(FieldType field, int64_t size,
+              ReplayDesc* x_desc = nullptr) override;
+
+  Triple And(int64_t size) override;
+
+  Triple Dot(FieldType field, int64_t m, int64_t n, int64_t k,
+             ReplayDesc* x_desc = nullptr,
+             ReplayDesc* y_desc = nullptr) override;
+
+  Pair Trunc(FieldType field, int64_t size, size_t bits) override;
+
+  Triple TruncPr(FieldType field, int64_t size, size_t bits) override;
+
+  Array RandBit(FieldType field, int64_t size) override;
+
+  PremTriple PermPair(FieldType field, int64_t size, size_t perm_rank) override;
+
+  std::unique_ptr<Beaver> Spawn() override;
+
+  Pair Eqz(FieldType field, int64_t size) override;
+
+ private:
+  std::unique_ptr<Beaver> beaver_;
+  const std::string dir_;
+  const std::string stream_;
+  size_t num_spawned_ = 0;
+  BeaverStoreReader reader_;
+};
+
+}  // namespace spu::mpc::semi2k
@@ -0,0 +1,183 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/semi2k/beaver/beaver_store.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/semi2k/beaver/beaver_impl/beaver_tfp.h"
+#include "libspu/mpc/utils/ring_ops.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::mpc::semi2k {
+
+namespace {
+
+constexpr FieldType kField = FieldType::FM64;
+constexpr size_t kWorldSize = 2;
+constexpr int64_t kNumel = 10;
+constexpr size_t kBits = 3;
+
+std::string partyDir(const std::string& dir, size_t rank) {
+  return fmt::format("{}/party_{}", dir, rank);
+}
+
+struct Results {
+  Beaver::Triple mul;
+  Beaver::Pair trunc;
+  Beaver::Triple spawned_mul;
+};
+
+// Same request sequence on every party, including a spawned beaver.
+Results runRequests(Beaver* beaver) {
+  Results ret;
+  ret.mul = beaver->Mul(kField, kNumel);
+  auto spawned = beaver->Spawn();
+  ret.trunc = beaver->Trunc(kField, kNumel, kBits);
+  ret.spawned_mul = spawned->Mul(kField, kNumel);
+  return ret;
+}
+
+NdArrayRef open(const std::vector<const Beaver::Array*>& shares) {
+  auto ret = ring_zeros(kField, {kNumel});
+  for (const auto* share : shares) {
+    EXPECT_EQ(share->size(), kNumel * SizeOf(kField));
+    auto buf = std::make_shared<yacl::Buffer>(share->data(), share->size());
+    ring_add_(ret, NdArrayRef(buf, ret.eltype(), {kNumel}));
+  }
+  return ret;
+}
+
+template <size_t I>
+NdArrayRef openTriple(const std::vector<Results>& results,
+                      Beaver::Triple Results::*member) {
+  std::vector<const Beaver::Array*> shares;
+  for (const auto& r : results) {
+    shares.push_back(&std::get<I>(r.*member));
+  }
+  return open(shares);
+}
+
+void checkMul(const std::vector<Results>& results,
+              Beaver::Triple Results::*member) {
+  EXPECT_TRUE(ring_all_equal(ring_mul(openTriple<0>(results, member),
+                                      openTriple<1>(results, member)),
+                             openTriple<2>(results, member)));
+}
+
+}  // namespace
+
+class BeaverStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = (std::filesystem::temp_directory_path() /
+            fmt::format("beaver_store_test_{}", getpid()))
+               .string();
+    std::filesystem::remove_all(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::string dir_;
+};
+
+TEST_F(BeaverStoreTest, RecordReplay) {
+  std::vector<Results> recorded(kWorldSize);
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverRecorder beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    recorded[lctx->Rank()] = runRequests(&beaver);
+                  });
+  checkMul(recorded, &Results::mul);
+  checkMul(recorded, &Results::spawned_mul);
+
+  std::vector<Results> replayed(kWorldSize);
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverReplayer beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    replayed[lctx->Rank()] = runRequests(&beaver);
+                  });
+
+  // Replay serves exactly the recorded correlations.
+  for (size_t rank = 0; rank < kWorldSize; ++rank) {
+    const auto& expected = recorded[rank];
+    const auto& got = replayed[rank];
+    auto same = [](const Beaver::Array& lhs, const Beaver::Array& rhs) {
+      return lhs.size() == rhs.size() &&
+             std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+    };
+    EXPECT_TRUE(same(std::get<2>(expected.mul), std::get<2>(got.mul)));
+    EXPECT_TRUE(same(expected.trunc.second, got.trunc.second));
+    EXPECT_TRUE(same(std::get<2>(expected.spawned_mul),
+                     std::get<2>(got.spawned_mul)));
+  }
+  checkMul(replayed, &Results::mul);
+}
+
+TEST_F(BeaverStoreTest, ReplayOnce) {
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverRecorder beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    beaver.Mul(kField, kNumel);
+                  });
+
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverReplayer beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    beaver.Mul(kField, kNumel);
+                  });
+
+  // The store is consumed by the first replay.
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    EXPECT_THROW(BeaverReplayer(
+                                     std::make_unique<BeaverTfpUnsafe>(lctx),
+                                     partyDir(dir_, lctx->Rank())),
+                                 RuntimeError);
+                  });
+}
+
+TEST_F(BeaverStoreTest, Mismatch) {
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverRecorder beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    beaver.Mul(kField, kNumel);
+                  });
+
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    BeaverReplayer beaver(
+                        std::make_unique<BeaverTfpUnsafe>(lctx),
+                        partyDir(dir_, lctx->Rank()));
+                    EXPECT_THROW(beaver.Mul(kField, kNumel + 1), RuntimeError);
+                  });
+}
+
+}  // namespace spu::mpc::semi2k
@@ -34,7 +34,8 @@ void regSemi2kProtocol(SPUContext* ctx,
   semi2k::registerTypes();
 
   // add communicator
-  ctx->prot()->addState<Communicator>(lctx);
+  ctx->prot()->addState<Communicator>(
+      lctx, ctx->config().experimental_enable_comm_bit_packing);
 
   // register random states & kernels.
   ctx->prot()->addState<PrgState>(lctx);
@@ -54,6 +54,12 @@ RuntimeConfig makeConfig(FieldType field) {
   return conf;
 }
 
+RuntimeConfig makeBitPackingConfig(FieldType field) {
+  RuntimeConfig conf = makeConfig(field);
+  conf.experimental_enable_comm_bit_packing = true;
+  return conf;
+}
+
 std::once_flag init_server;
 std::unique_ptr<brpc::Server> server;
 std::string server_host;
@@ -101,6 +107,20 @@ INSTANTIATE_TEST_SUITE_P(
                          std::get<1>(p.param).field, std::get<2>(p.param));
     });
 
+// Boolean shares narrower than the field are sent packed.
+INSTANTIATE_TEST_SUITE_P(
+    Semi2kBitPacking, ApiTest,
+    testing::Combine(testing::Values(CreateObjectFn(makeSemi2kProtocol,
+                                                    "tfp")),  //
+                     testing::Values(makeBitPackingConfig(FieldType::FM32),
+                                     makeBitPackingConfig(FieldType::FM64),
+                                     makeBitPackingConfig(FieldType::FM128)),
+                     testing::Values(2, 3)),  //
+    [](const testing::TestParamInfo<ApiTest::ParamType>& p) {
+      return fmt::format("{}x{}x{}", std::get<0>(p.param).name(),
+                         std::get<1>(p.param).field, std::get<2>(p.param));
+    });
+
 INSTANTIATE_TEST_SUITE_P(
     Semi2k, ArithmeticTest,
     testing::Combine(testing::Values(CreateObjectFn(makeSemi2kProtocol, "tfp"),
@@ -757,4 +777,36 @@ TEST_P(ApiTest, TruncP_2PC) {
   });
 }
 
+TEST(BeaverPrefetchTest, KernelHints) {
+  RuntimeConfig conf = makeConfig(FieldType::FM64);
+  conf.experimental_beaver_prefetch_depth = 4;
+
+  utils::simulate(2, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+    auto ctx = makeSemi2kProtocol(conf, lctx);
+    auto* state = ctx->prot()->getState<Semi2kState>();
+
+    auto x = p2a(ctx.get(), rand_p(ctx.get(), {3, 4}));
+    auto y = p2a(ctx.get(), rand_p(ctx.get(), {3, 4}));
+    auto w = p2a(ctx.get(), rand_p(ctx.get(), {4, 2}));
+
+    // What the device announces for a secret multiply and dot.
+    ctx->prot()->hint({{"mul_aa", 12, {}},
+                       {"mmul_aa", 1, {{"m", 3}, {"k", 4}, {"n", 2}}}});
+    mul_aa(ctx.get(), x, y);
+    mmul_aa(ctx.get(), x, w);
+    EXPECT_EQ(state->prefetchStats()->hits, 2);
+
+    // Forks prefetch as well, their stats are merged once they are dropped.
+    {
+      auto sub_ctx = ctx->fork();
+      sub_ctx->prot()->hint({{"mul_aa", 12, {}}});
+      mul_aa(sub_ctx.get(), x, y);
+    }
+    auto stats = state->prefetchStats();
+    EXPECT_EQ(stats->hits, 3);
+    EXPECT_EQ(stats->misses, 0);
+    EXPECT_EQ(ctx->prot()->describeStats().size(), 1);
+  });
+}
+
 }  // namespace spu::mpc::test
@@ -15,23 +15,49 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "libspu/core/object.h"
 #include "libspu/mpc/semi2k/beaver/beaver_cache.h"
 #include "libspu/mpc/semi2k/beaver/beaver_impl/beaver_tfp.h"
 #include "libspu/mpc/semi2k/beaver/beaver_impl/beaver_ttp.h"
 #include "libspu/mpc/semi2k/beaver/beaver_interface.h"
+#include "libspu/mpc/semi2k/beaver/beaver_prefetch.h"
+#include "libspu/mpc/semi2k/beaver/beaver_store.h"
 
 namespace spu::mpc {
 
 // TODO(jint) split this into individual states.
 class Semi2kState : public State {
+  // Prefetch stats of dropped forks, shared by a state and all its forks.
+  struct PrefetchStats {
+    std::mutex mu;
+    semi2k::BeaverPrefetch::Stats forked;
+  };
+
   std::unique_ptr<semi2k::Beaver> beaver_;
   std::shared_ptr<semi2k::BeaverCache> beaver_cache_;
+  // points into beaver_ when prefetching is enabled.
+  semi2k::BeaverPrefetch* beaver_prefetch_ = nullptr;
+  std::shared_ptr<PrefetchStats> prefetch_stats_;
+  bool is_fork_ = false;
+
+  // used to translate kernel hints into beaver requests.
+  FieldType field_ = FT_INVALID;
+  // the request of trunc_a, if it consumes correlations.
+  std::optional<semi2k::BeaverKind> trunc_kind_;
 
  private:
   Semi2kState() = default;
 
+  void enablePrefetch(size_t depth) {
+    auto prefetch =
+        std::make_unique<semi2k::BeaverPrefetch>(std::move(beaver_), depth);
+    beaver_prefetch_ = prefetch.get();
+    beaver_ = std::move(prefetch);
+  }
+
  public:
   static constexpr const char* kBindName() { return "Semi2kState"; }
 
@@ -65,18 +91,114 @@ class Semi2kState : public State {
     } else {
       SPU_THROW("unsupported beaver type {}", conf.beaver_type);
     }
-    beaver_cache_ = std::make_unique<semi2k::BeaverCache>();
+    if (!conf.experimental_beaver_record_dir.empty()) {
+      SPU_ENFORCE(conf.experimental_beaver_replay_dir.empty(),
+                  "beaver record and replay are exclusive");
+      beaver_ = std::make_unique<semi2k::BeaverRecorder>(
+          std::move(beaver_),
+          fmt::format("{}/party_{}", conf.experimental_beaver_record_dir,
+                      lctx->Rank()));
+    } else if (!conf.experimental_beaver_replay_dir.empty()) {
+      beaver_ = std::make_unique<semi2k::BeaverReplayer>(
+          std::move(beaver_),
+          fmt::format("{}/party_{}", conf.experimental_beaver_replay_dir,
+                      lctx->Rank()));
+    }
+    if (conf.experimental_beaver_prefetch_depth > 0) {
+      enablePrefetch(conf.experimental_beaver_prefetch_depth);
+      prefetch_stats_ = std::make_shared<PrefetchStats>();
+    }
+    beaver_cache_ = std::make_unique<semi2k::BeaverCache>(
+        conf.experimental_beaver_cache_memory_budget);
+
+    field_ = conf.field;
+    // see the trunc_a kernels registered by regSemi2kProtocol.
+    if (lctx->WorldSize() > 2) {
+      trunc_kind_ = conf.trunc_allow_msb_error ? semi2k::BeaverKind::Trunc
+                                               : semi2k::BeaverKind::TruncPr;
+    }
+  }
+
+  ~Semi2kState() override {
+    if (is_fork_ && beaver_prefetch_ != nullptr) {
+      std::unique_lock lk(prefetch_stats_->mu);
+      prefetch_stats_->forked += beaver_prefetch_->GetStats();
+    }
   }
 
   semi2k::Beaver* beaver() { return beaver_.get(); }
   semi2k::BeaverCache* beaver_cache() { return beaver_cache_.get(); }
+  // nullptr if prefetching is disabled.
+  semi2k::BeaverPrefetch* beaver_prefetch() { return beaver_prefetch_; }
 
   std::unique_ptr<State> fork() override {
     auto ret = std::unique_ptr<Semi2kState>(new Semi2kState);
     ret->beaver_ = beaver_->Spawn();
     ret->beaver_cache_ = beaver_cache_;
+    ret->field_ = field_;
+    ret->trunc_kind_ = trunc_kind_;
+    if (beaver_prefetch_ != nullptr) {
+      // forks run whole ops and loop bodies, which are hinted as well.
+      ret->enablePrefetch(beaver_prefetch_->depth());
+      ret->prefetch_stats_ = prefetch_stats_;
+      ret->is_fork_ = true;
+    }
     return ret;
   }
+
+  // Prefetches the correlations of the hinted kernels, when enabled. Only
+  // kernels whose requests are known from their shapes are translated, others
+  // are served on demand.
+  void hint(const std::vector<KernelHint>& calls) override {
+    if (beaver_prefetch_ == nullptr) {
+      return;
+    }
+
+    std::vector<semi2k::BeaverRequest> requests;
+    for (const auto& call : calls) {
+      const auto numel = static_cast<int64_t>(call.numel);
+      if (call.name == "mul_aa") {
+        requests.push_back({semi2k::BeaverKind::Mul, field_, numel});
+      } else if (call.name == "mmul_aa") {
+        auto param = [&](const char* name) {
+          return static_cast<int64_t>(call.params.at(name));
+        };
+        requests.push_back({semi2k::BeaverKind::Dot, field_, param("m"),
+                            param("n"), param("k")});
+      } else if (call.name == "trunc_a" && trunc_kind_.has_value()) {
+        requests.push_back(
+            {*trunc_kind_, field_, numel, 0, 0, call.params.at("n")});
+      }
+    }
+    if (!requests.empty()) {
+      beaver_prefetch_->Hint(requests);
+    }
+  }
+
+  // Prefetch stats of this state and its dropped forks, nullopt if
+  // prefetching is disabled.
+  std::optional<semi2k::BeaverPrefetch::Stats> prefetchStats() const {
+    if (beaver_prefetch_ == nullptr) {
+      return std::nullopt;
+    }
+    auto stats = beaver_prefetch_->GetStats();
+    std::unique_lock lk(prefetch_stats_->mu);
+    stats += prefetch_stats_->forked;
+    return stats;
+  }
+
+  std::vector<std::string> describeStats() const override {
+    if (is_fork_) {
+      return {};
+    }
+    auto stats = prefetchStats();
+    if (!stats.has_value()) {
+      return {};
+    }
+    return {fmt::format(
+        "beaver prefetch, {} hits ({} stalled), {} misses, {} dropped hints",
+        stats->hits, stats->stalls, stats->misses, stats->dropped)};
+  }
 };
 
 }  // namespace spu::mpc
@@ -134,6 +134,7 @@ NdArrayRef P2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
 NdArrayRef A2P::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto out_field = ctx->getState<Z2kState>()->getDefaultField();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto k = ctx->getState<Spdz2kState>()->k();
   const auto s = ctx->getState<Spdz2kState>()->s();
 
@@ -141,7 +142,9 @@ NdArrayRef A2P::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto& x = getValueShare(in);
   const auto& x_mac = getMacShare(in);
   auto [t, check_mac] = beaver->BatchOpen(x, x_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(t, check_mac, k, s));
+  mac_checker->check(t, check_mac, k, s);
+  // reveal, check all pending opens.
+  mac_checker->flush();
 
   // Notice that only the last sth bits is correct
   ring_bitmask_(t, 0, k);
@@ -156,6 +159,7 @@ NdArrayRef A2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
   const auto out_field = ctx->getState<Z2kState>()->getDefaultField();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto k = ctx->getState<Spdz2kState>()->k();
   const auto s = ctx->getState<Spdz2kState>()->s();
 
@@ -176,7 +180,9 @@ NdArrayRef A2V::proc(KernelEvalContext* ctx, const NdArrayRef& in,
   auto mask_x_mac = ring_add(x_mac, z_mac);
 
   auto [t, check_mac] = beaver->BatchOpen(mask_x, mask_x_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(t, check_mac, k, s));
+  mac_checker->check(t, check_mac, k, s);
+  // reveal, check all pending opens.
+  mac_checker->flush();
 
   // Notice that only the last s bits is correct
   if (comm->getRank() == rank) {
@@ -457,6 +463,7 @@ NdArrayRef MulAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   const auto field = lhs.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto key = ctx->getState<Spdz2kState>()->key();
   const auto k = ctx->getState<Spdz2kState>()->k();
   const auto s = ctx->getState<Spdz2kState>()->s();
@@ -488,8 +495,8 @@ NdArrayRef MulAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   // don't use BatchOpen to reduce the number of masks
   // auto [p_e, masked_e_mac] = beaver->BatchOpen(e, e_mac, k, s);
   // auto [p_f, masked_f_mac] = beaver->BatchOpen(f, f_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(p_e, e_mac, k, s));
-  SPU_ENFORCE(beaver->BatchMacCheck(p_f, f_mac, k, s));
+  mac_checker->check(p_e, e_mac, k, s);
+  mac_checker->check(p_f, f_mac, k, s);
 
   auto p_ef = ring_mul(p_e, p_f);
 
@@ -515,6 +522,7 @@ NdArrayRef MulAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
 NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
                           const NdArrayRef& rhs) const {
   const auto field = lhs.eltype().as<Ring2k>()->field();
+  const auto num_threads = getMmulNumThreads(ctx);
 
   // in
   const auto& x = getValueShare(lhs);
@@ -522,8 +530,8 @@ NdArrayRef MatMulAP::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   const auto& y = CastRing(rhs, field);
 
   // ret
-  auto z = ring_mmul(x, y);
-  auto z_mac = ring_mmul(x_mac, y);
+  auto z = ring_mmul(x, y, num_threads);
+  auto z_mac = ring_mmul(x_mac, y, num_threads);
   return makeAShare(z, z_mac, field);
 }
 
@@ -535,6 +543,7 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   const auto key = ctx->getState<Spdz2kState>()->key();
   const auto k_bits = ctx->getState<Spdz2kState>()->k();
   const auto s_bits = ctx->getState<Spdz2kState>()->s();
+  const auto num_threads = getMmulNumThreads(ctx);
 
   const auto& x = getValueShare(lhs);
   const auto& y = getValueShare(rhs);
@@ -551,17 +560,20 @@ NdArrayRef MatMulAA::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   });
   auto p_e = std::move(res[0]);
   auto p_f = std::move(res[1]);
-  auto p_ef = ring_mmul(p_e, p_f);
+  auto p_ef = ring_mmul(p_e, p_f, num_threads);
 
   // z = p_e dot b + a dot p_f + c;
-  auto z = ring_add(ring_add(ring_mmul(p_e, b), ring_mmul(a, p_f)), c);
+  auto z = ring_add(ring_add(ring_mmul(p_e, b, num_threads),
+                             ring_mmul(a, p_f, num_threads)),
+                    c);
   if (comm->getRank() == 0) {
     // z += p_e dot p_f;
-    ring_add_(z, ring_mmul(p_e, p_f));
+    ring_add_(z, ring_mmul(p_e, p_f, num_threads));
   }
 
   // zmac = p_e dot b_mac + a_mac dot p_f + c_mac + (p_e dot p_f) * key;
-  auto zmac = ring_add(ring_mmul(p_e, b_mac), ring_mmul(a_mac, p_f));
+  auto zmac = ring_add(ring_mmul(p_e, b_mac, num_threads),
+                       ring_mmul(a_mac, p_f, num_threads));
   ring_add_(zmac, c_mac);
   ring_add_(zmac, ring_mul(p_ef, key));
 
@@ -592,6 +604,7 @@ NdArrayRef TruncA::proc(KernelEvalContext* ctx, const NdArrayRef& in,
   const auto field = in.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto k = ctx->getState<Spdz2kState>()->k();
   const auto s = ctx->getState<Spdz2kState>()->s();
 
@@ -604,7 +617,7 @@ NdArrayRef TruncA::proc(KernelEvalContext* ctx, const NdArrayRef& in,
   // open x - r
   auto [x_r, check_mac] =
       beaver->BatchOpen(ring_sub(x, r), ring_sub(x_mac, r_mac), k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(x_r, check_mac, k, s));
+  mac_checker->check(x_r, check_mac, k, s);
   size_t bit_len = SizeOf(field) * 8;
   auto tr_x_r =
       ring_arshift(ring_lshift(x_r, {static_cast<int64_t>(bit_len - k)}),
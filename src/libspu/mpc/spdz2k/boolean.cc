@@ -266,6 +266,7 @@ NdArrayRef CastTypeB::proc(KernelEvalContext*, const NdArrayRef& in,
 
 NdArrayRef B2P::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto* beaver_ptr = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto s = ctx->getState<Spdz2kState>()->s();
   const auto field = in.eltype().as<BShrTy>()->field();
   const auto out_field = ctx->getState<Z2kState>()->getDefaultField();
@@ -277,7 +278,9 @@ NdArrayRef B2P::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
       beaver_ptr->BatchOpen(getValueShare(in), getMacShare(in), 1, s);
 
   // 2. Maccheck
-  SPU_ENFORCE(beaver_ptr->BatchMacCheck(pub, mac, 1, s));
+  mac_checker->check(pub, mac, 1, s);
+  // reveal, check all pending opens.
+  mac_checker->flush();
 
   return DISPATCH_ALL_FIELDS(field, [&]() {
     using BShrT = ring2k_t;
@@ -442,6 +445,7 @@ NdArrayRef AndBB::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   const auto field = lhs.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver_ptr = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const auto key = ctx->getState<Spdz2kState>()->key();
   const auto s = ctx->getState<Spdz2kState>()->s();
 
@@ -467,8 +471,8 @@ NdArrayRef AndBB::proc(KernelEvalContext* ctx, const NdArrayRef& lhs,
   auto [p_e, pe_mac] = beaver_ptr->BatchOpen(e, e_mac, 1, s);
   auto [p_f, pf_mac] = beaver_ptr->BatchOpen(f, f_mac, 1, s);
 
-  SPU_ENFORCE(beaver_ptr->BatchMacCheck(p_e, pe_mac, 1, s));
-  SPU_ENFORCE(beaver_ptr->BatchMacCheck(p_f, pf_mac, 1, s));
+  mac_checker->check(p_e, pe_mac, 1, s);
+  mac_checker->check(p_f, pf_mac, 1, s);
 
   // Reserve the least significant bit only
   ring_bitmask_(p_e, 0, 1);
@@ -160,6 +160,7 @@ NdArrayRef Bit2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto field = in.eltype().as<Ring2k>()->field();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const size_t s = ctx->getState<Spdz2kState>()->s();
   const size_t k = ctx->getState<Spdz2kState>()->k();
   const auto key = ctx->getState<Spdz2kState>()->key();
@@ -187,7 +188,7 @@ NdArrayRef Bit2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
 
   NdArrayRef c, zero_mac;
   std::tie(c, zero_mac) = beaver->BatchOpen(bc_val, bc_mac, 1, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(c, zero_mac, 1, s));
+  mac_checker->check(c, zero_mac, 1, s);
   ring_bitmask_(c, 0, 1);
 
   // 5. [x] = c + [r] - 2 * c * [r]
@@ -215,6 +216,7 @@ NdArrayRef Bit2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
 NdArrayRef A2B::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto field = in.eltype().as<Ring2k>()->field();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const size_t k = ctx->getState<Spdz2kState>()->k();
   const size_t s = ctx->getState<Spdz2kState>()->s();
 
@@ -241,7 +243,7 @@ NdArrayRef A2B::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto a_r_mac = ring_sub(in_mac, r_mac);
 
   auto [c, check_mac] = beaver->BatchOpen(a_r_val, a_r_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(c, check_mac, k, s));
+  mac_checker->check(c, check_mac, k, s);
 
   // 4. binary add
   auto ty = makeType<Pub2kTy>(field);
@@ -259,6 +261,7 @@ NdArrayRef B2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto nbits = in.eltype().as<BShrTy>()->nbits();
   auto* comm = ctx->getState<Communicator>();
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   const size_t k = ctx->getState<Spdz2kState>()->k();
   const size_t s = ctx->getState<Spdz2kState>()->s();
   const auto key = ctx->getState<Spdz2kState>()->key();
@@ -288,7 +291,7 @@ NdArrayRef B2A::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   NdArrayRef c;
   NdArrayRef zero_mac;
   std::tie(c, zero_mac) = beaver->BatchOpen(bc_val, bc_mac, 1, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(c, zero_mac, 1, s));
+  mac_checker->check(c, zero_mac, 1, s);
   ring_bitmask_(c, 0, 1);
 
   // 4. [x] = c + [r] - 2 * c * [r]
@@ -333,6 +336,7 @@ NdArrayRef MSB::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   const auto* comm = ctx->getState<Communicator>();
 
   auto* beaver = ctx->getState<Spdz2kState>()->beaver();
+  auto* mac_checker = ctx->getState<Spdz2kState>()->macChecker();
   // const auto numel = in.numel();
 
   // The protocol for extracting MSB in SPDZ2k
@@ -343,7 +347,7 @@ NdArrayRef MSB::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto _in_mac = GetMacShare(ctx, in);
 
   auto [c_in, c_in_mac] = beaver->BatchOpen(_in, _in_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(c_in, c_in_mac, k, s));
+  mac_checker->check(c_in, c_in_mac, k, s);
 
   auto _r_val = ring_zeros(field, in.shape());
   auto _r_mac = ring_zeros(field, in.shape());
@@ -365,7 +369,7 @@ NdArrayRef MSB::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto _c = ring_add(_in, _r_val);
   auto _c_mac = ring_add(_in_mac, _r_mac);
   auto [c_open, zero_mac] = beaver->BatchOpen(_c, _c_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(c_open, zero_mac, k, s));
+  mac_checker->check(c_open, zero_mac, k, s);
   auto _c_open = ring_bitmask(c_open, 0, k - 1);
 
   // 3. convert r from A-share to B-share
@@ -430,7 +434,7 @@ NdArrayRef MSB::proc(KernelEvalContext* ctx, const NdArrayRef& in) const {
   auto _e_mac = ring_add(_d_mac, ring_lshift(_b_mac, {k - 1}));
 
   auto [e_open, e_zero_mac] = beaver->BatchOpen(_e, _e_mac, k, s);
-  SPU_ENFORCE(beaver->BatchMacCheck(e_open, e_zero_mac, k, s));
+  mac_checker->check(e_open, e_zero_mac, k, s);
 
   // 8. e' be the most significant bit of e
   auto _ee = ring_bitmask(ring_rshift(e_open, {k - 1}), 0, 1);
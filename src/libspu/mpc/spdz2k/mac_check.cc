@@ -0,0 +1,87 @@
+// Copyright 2023 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libspu/mpc/spdz2k/mac_check.h"
+
+#include "spdlog/spdlog.h"
+
+#include "libspu/core/prelude.h"
+
+namespace spu::mpc::spdz2k {
+namespace {
+
+NdArrayRef flatConcat(const std::vector<NdArrayRef>& arrs) {
+  std::vector<NdArrayRef> flat;
+  flat.reserve(arrs.size());
+  for (const auto& arr : arrs) {
+    flat.emplace_back(arr.reshape({arr.numel()}));
+  }
+  if (flat.size() == 1) {
+    return flat[0];
+  }
+  return flat[0].concatenate(absl::MakeSpan(flat).subspan(1), 0);
+}
+
+}  // namespace
+
+MacChecker::~MacChecker() {
+  if (num_pending_ == 0) {
+    return;
+  }
+  // a check is a round trip to the other parties, which may be gone or
+  // unwinding from an error of their own.
+  SPDLOG_WARN("dropping {} opens without a mac check", num_pending_);
+}
+
+void MacChecker::check(const NdArrayRef& open_value, const NdArrayRef& mac,
+                       size_t k, size_t s) {
+  if (interval_ == 0) {
+    SPU_ENFORCE(beaver_->BatchMacCheck(open_value, mac, k, s),
+                "mac check failed");
+    return;
+  }
+
+  const auto field = open_value.eltype().as<Ring2k>()->field();
+  auto& pending = pending_[{field, k}];
+  // callers may modify the opened value in place after the check.
+  pending.values.emplace_back(open_value.clone());
+  pending.macs.emplace_back(mac.clone());
+  pending.s = s;
+
+  if (++num_pending_ >= interval_) {
+    flush();
+  }
+}
+
+void MacChecker::flush() {
+  if (num_pending_ == 0) {
+    return;
+  }
+
+  // clear first, a failed check must not be retried with the same opens.
+  auto pending = std::move(pending_);
+  pending_.clear();
+  num_pending_ = 0;
+
+  for (const auto& [key, group] : pending) {
+    const size_t k = key.second;
+    SPU_ENFORCE(beaver_->BatchMacCheck(flatConcat(group.values),
+                                       flatConcat(group.macs), k, group.s),
+                "deferred mac check failed, {} opens of {} bits",
+                group.values.size(), k);
+  }
+}
+
+}  // namespace spu::mpc::spdz2k
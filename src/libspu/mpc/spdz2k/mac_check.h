@@ -0,0 +1,71 @@
+// Copyright 2023 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "libspu/core/ndarray_ref.h"
+#include "libspu/mpc/spdz2k/beaver/beaver_interface.h"
+
+namespace spu::mpc::spdz2k {
+
+// Checks the MACs of opened values.
+//
+// Each BatchMacCheck costs two commit-and-open rounds, one for the public
+// coin and one for the check value. With a non zero interval, opens are
+// queued and checked together by one random linear combination once
+// `interval` opens are pending or on flush(), which every reveal calls
+// before returning, as in the online phase of SPDZ2k, 4. Trailing opens are
+// flushed at the end of an execution by Spdz2kState::flush.
+class MacChecker {
+ public:
+  MacChecker(Beaver* beaver, size_t interval)
+      : beaver_(beaver), interval_(interval) {}
+
+  // Drops the pending opens unchecked, without communicating. Callers must
+  // flush() before, e.g. through State::flush at the end of an execution.
+  ~MacChecker();
+
+  // Checks the low k bits of open_value against mac, now or at the next
+  // checkpoint. Throws if a check fails.
+  void check(const NdArrayRef& open_value, const NdArrayRef& mac, size_t k,
+             size_t s);
+
+  // Checks all pending opens.
+  void flush();
+
+  size_t numPending() const { return num_pending_; }
+
+ private:
+  struct Pending {
+    std::vector<NdArrayRef> values;
+    std::vector<NdArrayRef> macs;
+    size_t s = 0;
+  };
+
+  Beaver* const beaver_;
+
+  const size_t interval_;
+
+  // pending opens, grouped by (field, k).
+  std::map<std::pair<FieldType, size_t>, Pending> pending_;
+
+  size_t num_pending_ = 0;
+};
+
+}  // namespace spu::mpc::spdz2k
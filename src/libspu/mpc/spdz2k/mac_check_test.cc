@@ -0,0 +1,92 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libspu/mpc/spdz2k/mac_check.h"
+
+#include "gtest/gtest.h"
+
+#include "libspu/mpc/ab_api.h"
+#include "libspu/mpc/api.h"
+#include "libspu/mpc/spdz2k/protocol.h"
+#include "libspu/mpc/spdz2k/state.h"
+#include "libspu/mpc/spdz2k/value.h"
+#include "libspu/mpc/utils/ring_ops.h"
+#include "libspu/mpc/utils/simulate.h"
+
+namespace spu::mpc::spdz2k {
+
+namespace {
+
+constexpr size_t kWorldSize = 2;
+const Shape kShape = {3, 4};
+
+RuntimeConfig makeConfig(size_t interval) {
+  RuntimeConfig conf;
+  conf.protocol = ProtocolKind::SPDZ2K;
+  conf.field = FieldType::FM64;
+  conf.experimental_spdz2k_mac_check_interval = interval;
+  return conf;
+}
+
+// Runs a mul_aa on a share tampered by party 0, its opens are the last ones
+// of the program.
+void runTamperedMul(SPUContext* ctx) {
+  auto x = p2a(ctx, rand_p(ctx, kShape));
+  auto y = p2a(ctx, rand_p(ctx, kShape));
+  if (ctx->lctx()->Rank() == 0) {
+    auto share = getValueShare(x.data());
+    const auto field = share.eltype().as<Ring2k>()->field();
+    ring_add_(share, ring_ones(field, kShape));
+  }
+  mul_aa(ctx, x, y);
+}
+
+}  // namespace
+
+TEST(MacCheckTest, Immediate) {
+  utils::simulate(kWorldSize,
+                  [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+                    auto ctx = makeSpdz2kProtocol(makeConfig(0), lctx);
+                    EXPECT_THROW(runTamperedMul(ctx.get()), RuntimeError);
+                  });
+}
+
+TEST(MacCheckTest, DeferredTrailingOpen) {
+  utils::simulate(
+      kWorldSize, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+        auto ctx = makeSpdz2kProtocol(makeConfig(16), lctx);
+        auto* checker = ctx->prot()->getState<Spdz2kState>()->macChecker();
+        runTamperedMul(ctx.get());
+        EXPECT_GT(checker->numPending(), 0);
+
+        // The end of the execution checks the queued opens.
+        EXPECT_THROW(ctx->prot()->flush(), RuntimeError);
+        EXPECT_EQ(checker->numPending(), 0);
+      });
+}
+
+TEST(MacCheckTest, DestroyWithPendingOpens) {
+  utils::simulate(
+      kWorldSize, [&](const std::shared_ptr<yacl::link::Context>& lctx) {
+        auto ctx = makeSpdz2kProtocol(makeConfig(16), lctx);
+        auto* checker = ctx->prot()->getState<Spdz2kState>()->macChecker();
+        runTamperedMul(ctx.get());
+        EXPECT_GT(checker->numPending(), 0);
+
+        // Dropped without a flush, the tampered opens are not checked.
+        EXPECT_NO_THROW(ctx.reset());
+      });
+}
+
+}  // namespace spu::mpc::spdz2k
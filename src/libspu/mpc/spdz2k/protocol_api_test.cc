@@ -25,6 +25,12 @@ RuntimeConfig makeConfig(FieldType field) {
   return conf;
 }
 
+RuntimeConfig makeDeferredMacCheckConfig(FieldType field) {
+  RuntimeConfig conf = makeConfig(field);
+  conf.experimental_spdz2k_mac_check_interval = 16;
+  return conf;
+}
+
 }  // namespace
 
 INSTANTIATE_TEST_SUITE_P(
@@ -38,4 +44,15 @@ INSTANTIATE_TEST_SUITE_P(
                          std::get<1>(p.param).field, std::get<2>(p.param));
     });
 
+INSTANTIATE_TEST_SUITE_P(
+    Spdz2kDeferredMacCheck, ApiTest,
+    testing::Combine(
+        testing::Values(CreateObjectFn(makeSpdz2kProtocol, "tfp")),  //
+        testing::Values(makeDeferredMacCheckConfig(FieldType::FM64)),  //
+        testing::Values(2)),                                           //
+    [](const testing::TestParamInfo<ApiTest::ParamType>& p) {
+      return fmt::format("{}x{}x{}", std::get<0>(p.param).name(),
+                         std::get<1>(p.param).field, std::get<2>(p.param));
+    });
+
 }  // namespace spu::mpc::test
@@ -25,6 +25,7 @@
 #include "libspu/mpc/spdz2k/beaver/beaver_tfp.h"
 #include "libspu/mpc/spdz2k/beaver/beaver_tinyot.h"
 #include "libspu/mpc/spdz2k/commitment.h"
+#include "libspu/mpc/spdz2k/mac_check.h"
 
 namespace spu::mpc {
 
@@ -49,6 +50,8 @@ class Spdz2kState : public State {
 
   std::unique_ptr<spdz2k::Beaver> beaver_;
 
+  std::unique_ptr<spdz2k::MacChecker> mac_checker_;
+
   std::shared_ptr<yacl::link::Context> lctx_;
 
   // share of global key, share key has length of 128 bit
@@ -97,12 +100,19 @@ class Spdz2kState : public State {
     k_ = SizeOf(data_field_) * 8;
     s_ = k_;
     key_ = beaver_->InitSpdzKey(runtime_field_, s_);
+    mac_checker_ = std::make_unique<spdz2k::MacChecker>(
+        beaver_.get(), conf.experimental_spdz2k_mac_check_interval);
   }
 
   FieldType getDefaultField() const { return runtime_field_; }
 
   spdz2k::Beaver* beaver() { return beaver_.get(); }
 
+  spdz2k::MacChecker* macChecker() { return mac_checker_.get(); }
+
+  // Checks the opens still queued by the mac checker.
+  void flush() override { mac_checker_->flush(); }
+
   uint128_t key() const { return key_; }
 
   size_t k() const { return k_; }
@@ -14,4 +14,336 @@
 
 #include "libspu/mpc/utils/linalg.h"
 
-namespace spu::mpc::linalg::detail {}  // namespace spu::mpc::linalg::detail
+#include <algorithm>
+#include <vector>
+
+#include "yacl/utils/parallel.h"
+
+namespace spu::mpc::linalg {
+
+int64_t numThreads(int64_t budget) {
+  const int64_t pool = std::max<int64_t>(yacl::get_num_threads(), 1);
+  return budget > 0 ? std::min(budget, pool) : pool;
+}
+
+namespace detail {
+namespace {
+
+// Goto style blocking: A is packed into MR rows high panels, B into NR
+// columns wide panels, both stored k-major so the micro kernel streams them
+// linearly. A kMC x kKC block of A stays in L2 while it is multiplied against
+// the B panels of a kKC x kNC block.
+constexpr int64_t kKC = 256;
+constexpr int64_t kMC = 64;
+constexpr int64_t kNC = 256;
+
+// Below this many multiply-adds packing does not pay off.
+constexpr int64_t kMinPackedWork = 16 * 16 * 16;
+
+// Products per task, smaller problems use less threads.
+constexpr int64_t kMinTaskWork = 64 * 64 * 64;
+
+int64_t divUp(int64_t x, int64_t y) { return (x + y - 1) / y; }
+
+int64_t numThreadsFor(int64_t M, int64_t N, int64_t K, int64_t tasks,
+                      int64_t budget) {
+  if (yacl::in_parallel_region()) {
+    // already inside an intra-op parallel loop, do not oversubscribe.
+    return 1;
+  }
+  const int64_t by_work = std::max<int64_t>(M * N * K / kMinTaskWork, 1);
+  return std::min({numThreads(budget), by_work, tasks});
+}
+
+// Runs f(task) for task in [0, tasks) on at most num_threads threads.
+template <typename F>
+void runTasks(int64_t tasks, int64_t num_threads, F&& f) {
+  if (num_threads <= 1) {
+    for (int64_t t = 0; t < tasks; ++t) {
+      f(t);
+    }
+    return;
+  }
+  yacl::parallel_for(0, tasks, divUp(tasks, num_threads),
+                     [&](int64_t begin, int64_t end) {
+                       for (int64_t t = begin; t < end; ++t) {
+                         f(t);
+                       }
+                     });
+}
+
+template <typename T>
+void naiveGemm(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+               int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+               int64_t LDC, int64_t IDC) {
+  for (int64_t i = 0; i < M; ++i) {
+    for (int64_t j = 0; j < N; ++j) {
+      T acc = 0;
+      for (int64_t k = 0; k < K; ++k) {
+        acc += A[i * LDA + k * IDA] * B[k * LDB + j * IDB];
+      }
+      C[i * LDC + j * IDC] = acc;
+    }
+  }
+}
+
+// C := A * b, one dot product per row of A.
+template <typename T>
+void gemvRows(int64_t M, int64_t K, const T* A, int64_t LDA, int64_t IDA,
+              const T* B, int64_t LDB, T* C, int64_t LDC,
+              int64_t num_threads) {
+  const int64_t tasks = divUp(M, kMC);
+  runTasks(tasks, num_threads, [&](int64_t t) {
+    const int64_t end = std::min(M, (t + 1) * kMC);
+    for (int64_t i = t * kMC; i < end; ++i) {
+      T acc = 0;
+      for (int64_t k = 0; k < K; ++k) {
+        acc += A[i * LDA + k * IDA] * B[k * LDB];
+      }
+      C[i * LDC] = acc;
+    }
+  });
+}
+
+// C := a * B, accumulates the rows of B scaled by a, kNC columns per task.
+template <typename T>
+void gemvCols(int64_t N, int64_t K, const T* A, int64_t IDA, const T* B,
+              int64_t LDB, int64_t IDB, T* C, int64_t IDC,
+              int64_t num_threads) {
+  const int64_t tasks = divUp(N, kNC);
+  runTasks(tasks, num_threads, [&](int64_t t) {
+    const int64_t j0 = t * kNC;
+    const int64_t nc = std::min(kNC, N - j0);
+    T acc[kNC] = {};
+    for (int64_t k = 0; k < K; ++k) {
+      const T a = A[k * IDA];
+      const T* b = B + k * LDB + j0 * IDB;
+      for (int64_t j = 0; j < nc; ++j) {
+        acc[j] += a * b[j * IDB];
+      }
+    }
+    for (int64_t j = 0; j < nc; ++j) {
+      C[(j0 + j) * IDC] = acc[j];
+    }
+  });
+}
+
+// Packed panels of one operand, the panel p holds rows (or columns)
+// [p*W, p*W+W) as K groups of W elements, zero padded. A 128 bits operand is
+// stored as two planes of 64 bits limbs.
+template <typename L>
+struct Panels {
+  int64_t width;
+  int64_t depth;
+  std::vector<L> lo;
+  std::vector<L> hi;
+
+  const L* loAt(int64_t p, int64_t k) const {
+    return lo.data() + (p * depth + k) * width;
+  }
+  const L* hiAt(int64_t p, int64_t k) const {
+    return hi.data() + (p * depth + k) * width;
+  }
+};
+
+// Packs a `rows` x `depth` matrix, X(r, k) = X[r * LD + k * ID]. Pass
+// (LDA, IDA) to pack A by rows, (IDB, LDB) to pack B by columns.
+template <typename T, typename L>
+Panels<L> pack(int64_t rows, int64_t depth, const T* X, int64_t LD,
+               int64_t ID, int64_t width, int64_t num_threads) {
+  constexpr bool kSplit = sizeof(T) > sizeof(L);
+
+  Panels<L> ret;
+  ret.width = width;
+  ret.depth = depth;
+  const int64_t num_panels = divUp(rows, width);
+  ret.lo.resize(num_panels * depth * width);
+  if constexpr (kSplit) {
+    ret.hi.resize(num_panels * depth * width);
+  }
+
+  runTasks(num_panels, num_threads, [&](int64_t p) {
+    const int64_t r0 = p * width;
+    const int64_t w = std::min(width, rows - r0);
+    L* lo = ret.lo.data() + p * depth * width;
+    L* hi = kSplit ? ret.hi.data() + p * depth * width : nullptr;
+    for (int64_t k = 0; k < depth; ++k) {
+      for (int64_t r = 0; r < w; ++r) {
+        const T v = X[(r0 + r) * LD + k * ID];
+        lo[k * width + r] = static_cast<L>(v);
+        if constexpr (kSplit) {
+          hi[k * width + r] = static_cast<L>(v >> 64);
+        }
+      }
+      for (int64_t r = w; r < width; ++r) {
+        lo[k * width + r] = 0;
+        if constexpr (kSplit) {
+          hi[k * width + r] = 0;
+        }
+      }
+    }
+  });
+
+  return ret;
+}
+
+// MR x NR register tile, acc += a[0:kc] * b[0:kc].
+template <typename T, int64_t MR, int64_t NR>
+inline void microKernel(int64_t kc, const T* __restrict a,
+                        const T* __restrict b, T* __restrict acc) {
+  for (int64_t k = 0; k < kc; ++k) {
+    const T* ak = a + k * MR;
+    const T* bk = b + k * NR;
+    for (int64_t r = 0; r < MR; ++r) {
+      const T ar = ak[r];
+      T* accr = acc + r * NR;
+#pragma GCC ivdep
+      for (int64_t c = 0; c < NR; ++c) {
+        accr[c] += ar * bk[c];
+      }
+    }
+  }
+}
+
+// 128 bits split-limb tile, modulo 2^128
+//   a * b = lo(a)*lo(b) + (lo(a)*hi(b) + hi(a)*lo(b)) << 64,
+// so only the low product needs a widening multiply, the cross terms are
+// summed on 64 bits and shifted once at the end.
+template <int64_t MR, int64_t NR>
+inline void microKernelSplit(int64_t kc, const uint64_t* __restrict a_lo,
+                             const uint64_t* __restrict a_hi,
+                             const uint64_t* __restrict b_lo,
+                             const uint64_t* __restrict b_hi,
+                             uint128_t* __restrict acc,
+                             uint64_t* __restrict cross) {
+  uint128_t lo[MR * NR] = {};
+  uint64_t hi[MR * NR] = {};
+  for (int64_t k = 0; k < kc; ++k) {
+#pragma GCC unroll 8
+    for (int64_t r = 0; r < MR; ++r) {
+      const uint64_t al = a_lo[k * MR + r];
+      const uint64_t ah = a_hi[k * MR + r];
+#pragma GCC unroll 8
+      for (int64_t c = 0; c < NR; ++c) {
+        const uint64_t bl = b_lo[k * NR + c];
+        const uint64_t bh = b_hi[k * NR + c];
+        lo[r * NR + c] += static_cast<uint128_t>(al) * bl;
+        hi[r * NR + c] += al * bh + ah * bl;
+      }
+    }
+  }
+  for (int64_t i = 0; i < MR * NR; ++i) {
+    acc[i] += lo[i];
+    cross[i] += hi[i];
+  }
+}
+
+// Register tiles of ringGemm: 4 x 16 for 32 bits (one cache line of C per
+// row), 4 x 8 for 64 bits and 2 x 4 limb pairs for 128 bits, which keeps the
+// accumulators of the split kernel in general purpose registers.
+
+// Computes the C tile [i0, i1) x [j0, j1) from the packed operands, one kKC
+// deep slice at a time so the A micro panel stays in L1 while the B panels of
+// the tile stream from L2.
+template <typename T, typename L, int64_t MR, int64_t NR>
+void computeTile(int64_t i0, int64_t i1, int64_t j0, int64_t j1, int64_t K,
+                 const Panels<L>& pa, const Panels<L>& pb, T* C, int64_t LDC,
+                 int64_t IDC) {
+  constexpr bool kSplit = sizeof(T) > sizeof(L);
+
+  for (int64_t k = 0; k < K; k += kKC) {
+    const int64_t kc = std::min(kKC, K - k);
+    for (int64_t i = i0; i < i1; i += MR) {
+      const int64_t mr = std::min(MR, i1 - i);
+      for (int64_t j = j0; j < j1; j += NR) {
+        const int64_t nr = std::min(NR, j1 - j);
+        T acc[MR * NR] = {};
+        [[maybe_unused]] L cross[MR * NR] = {};
+        if constexpr (kSplit) {
+          microKernelSplit<MR, NR>(kc, pa.loAt(i / MR, k), pa.hiAt(i / MR, k),
+                               pb.loAt(j / NR, k), pb.hiAt(j / NR, k), acc,
+                               cross);
+        } else {
+          microKernel<T, MR, NR>(kc, pa.loAt(i / MR, k), pb.loAt(j / NR, k),
+                                 acc);
+        }
+        for (int64_t r = 0; r < mr; ++r) {
+          for (int64_t c = 0; c < nr; ++c) {
+            T v = acc[r * NR + c];
+            if constexpr (kSplit) {
+              v += static_cast<T>(cross[r * NR + c]) << 64;
+            }
+            T& dst = C[(i + r) * LDC + (j + c) * IDC];
+            dst = (k == 0) ? v : dst + v;
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename T, typename L, int64_t MR, int64_t NR>
+void ringGemmImpl(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+                  int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+                  int64_t LDC, int64_t IDC, int64_t budget) {
+  if (M == 0 || N == 0) {
+    return;
+  }
+  if (M * N * K < kMinPackedWork) {
+    naiveGemm(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+    return;
+  }
+
+  if (N == 1) {
+    gemvRows(M, K, A, LDA, IDA, B, LDB, C, LDC,
+             numThreadsFor(M, N, K, divUp(M, kMC), budget));
+    return;
+  }
+  if (M == 1) {
+    gemvCols(N, K, A, IDA, B, LDB, IDB, C, IDC,
+             numThreadsFor(M, N, K, divUp(N, kNC), budget));
+    return;
+  }
+
+  const int64_t m_tiles = divUp(M, kMC);
+  const int64_t n_tiles = divUp(N, kNC);
+  const int64_t num_threads =
+      numThreadsFor(M, N, K, m_tiles * n_tiles, budget);
+
+  const auto pa = pack<T, L>(M, K, A, LDA, IDA, MR, num_threads);
+  const auto pb = pack<T, L>(N, K, B, IDB, LDB, NR, num_threads);
+
+  runTasks(m_tiles * n_tiles, num_threads, [&](int64_t t) {
+    const int64_t i0 = (t / n_tiles) * kMC;
+    const int64_t j0 = (t % n_tiles) * kNC;
+    computeTile<T, L, MR, NR>(i0, std::min(M, i0 + kMC), j0,
+                              std::min(N, j0 + kNC), K, pa, pb, C, LDC, IDC);
+  });
+}
+
+}  // namespace
+
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint32_t* A, int64_t LDA,
+              int64_t IDA, const uint32_t* B, int64_t LDB, int64_t IDB,
+              uint32_t* C, int64_t LDC, int64_t IDC, int64_t num_threads) {
+  ringGemmImpl<uint32_t, uint32_t, 4, 16>(M, N, K, A, LDA, IDA, B, LDB, IDB,
+                                          C, LDC, IDC, num_threads);
+}
+
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint64_t* A, int64_t LDA,
+              int64_t IDA, const uint64_t* B, int64_t LDB, int64_t IDB,
+              uint64_t* C, int64_t LDC, int64_t IDC, int64_t num_threads) {
+  ringGemmImpl<uint64_t, uint64_t, 4, 8>(M, N, K, A, LDA, IDA, B, LDB, IDB,
+                                         C, LDC, IDC, num_threads);
+}
+
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint128_t* A, int64_t LDA,
+              int64_t IDA, const uint128_t* B, int64_t LDB, int64_t IDB,
+              uint128_t* C, int64_t LDC, int64_t IDC, int64_t num_threads) {
+  ringGemmImpl<uint128_t, uint64_t, 2, 4>(M, N, K, A, LDA, IDA, B, LDB, IDB,
+                                          C, LDC, IDC, num_threads);
+}
+
+}  // namespace detail
+
+}  // namespace spu::mpc::linalg
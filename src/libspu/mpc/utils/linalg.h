@@ -15,16 +15,83 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 #define EIGEN_HAS_OPENMP
 
 #include "Eigen/Core"
+#include "yacl/base/int128.h"
 
 namespace spu::mpc::linalg {
 
+// Number of threads of a matmul with a thread budget of `budget`, i.e.
+//   min(budget, size of the parallel pool) if budget > 0,
+//   size of the parallel pool otherwise.
+int64_t numThreads(int64_t budget);
+
+namespace detail {
+
+// Cache blocked ring gemm on packed panels, wraps around 2^k. 128 bits rings
+// are multiplied limb by limb, see linalg.cc.
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint32_t* A, int64_t LDA,
+              int64_t IDA, const uint32_t* B, int64_t LDB, int64_t IDB,
+              uint32_t* C, int64_t LDC, int64_t IDC, int64_t num_threads);
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint64_t* A, int64_t LDA,
+              int64_t IDA, const uint64_t* B, int64_t LDB, int64_t IDB,
+              uint64_t* C, int64_t LDC, int64_t IDC, int64_t num_threads);
+void ringGemm(int64_t M, int64_t N, int64_t K, const uint128_t* A, int64_t LDA,
+              int64_t IDA, const uint128_t* B, int64_t LDB, int64_t IDB,
+              uint128_t* C, int64_t LDC, int64_t IDC, int64_t num_threads);
+
+template <typename T>
+constexpr bool isRingElement() {
+  if constexpr (std::is_same_v<T, int128_t> || std::is_same_v<T, uint128_t>) {
+    return true;
+  } else {
+    return std::is_integral_v<T> &&
+           (sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t));
+  }
+}
+
+template <typename T>
+using RingElementT = std::conditional_t<
+    sizeof(T) == sizeof(uint32_t), uint32_t,
+    std::conditional_t<sizeof(T) == sizeof(uint64_t), uint64_t, uint128_t>>;
+
+}  // namespace detail
+
+/**
+ * @brief C := op( A )*op( B ), on Eigen
+ *
+ * Reference implementation, used for non ring types (i.e. floats). Runs with
+ * the thread count of Eigen, which is process wide and left untouched.
+ */
+template <typename T>
+void matmulEigen(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
+                 int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
+                 int64_t LDC, int64_t IDC) {
+  using StrideT = Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>;
+  using MapMatrixConstT = Eigen::Map<
+      const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+      Eigen::Unaligned, StrideT>;
+  using MapMatrixT = Eigen::Map<
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+      Eigen::Unaligned, StrideT>;
+
+  MapMatrixConstT a(A, M, K, StrideT(LDA, IDA));
+  MapMatrixConstT b(B, K, N, StrideT(LDB, IDB));
+  MapMatrixT c(C, M, N, StrideT(LDC, IDC));
+
+  c.noalias() = a * b;
+}
+
 /**
  * @brief C := op( A )*op( B )
  *
+ * 32, 64 and 128 bits integers are computed modulo 2^k by the ring gemm, other
+ * types fall back to Eigen.
+ *
  * @tparam T Type of A, B, C
  * @param M   Number of rows in A
  * @param N   Number of columns in B
@@ -38,57 +105,21 @@ namespace spu::mpc::linalg {
  * @param C   Pointer to C
  * @param LDC Leading dimension stride of C
  * @param IDC Inner dimension stride of C
+ * @param num_threads Thread budget of ring types, see numThreads
  */
 template <typename T>
 void matmul(int64_t M, int64_t N, int64_t K, const T* A, int64_t LDA,
             int64_t IDA, const T* B, int64_t LDB, int64_t IDB, T* C,
-            int64_t LDC, int64_t IDC) {
-  using StrideT = Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>;
-  using MapMatrixConstT = Eigen::Map<
-      const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
-      Eigen::Unaligned, StrideT>;
-  using MapMatrixT = Eigen::Map<
-      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
-      Eigen::Unaligned, StrideT>;
-
-  MapMatrixConstT a(A, M, K, StrideT(LDA, IDA));
-  MapMatrixConstT b(B, K, N, StrideT(LDB, IDB));
-  MapMatrixT c(C, M, N, StrideT(LDC, IDC));
-
-  // if (M == 1) {
-  //   // GEMV case 1*K * K*N -> 1*N
-  //   auto work_load_size = computeTaskSize(N);
-  //   yacl::parallel_for(0, N, work_load_size, [&](int64_t begin, int64_t end)
-  //   {
-  //     auto block_size = end - begin;
-  //     c.block(0, begin, 1, block_size) =
-  //         a.row(0) * b.block(0, begin, K, block_size);
-  //   });
-  //   return;
-  // } else if (N == 1) {
-  //   // GEMV case M*K * K*1 -> M*1
-  //   auto work_load_size = computeTaskSize(M);
-  //   yacl::parallel_for(0, M, work_load_size, [&](int64_t begin, int64_t end)
-  //   {
-  //     auto block_size = end - begin;
-  //     c.block(begin, 0, block_size, 1) =
-  //         a.block(begin, 0, block_size, K) * b.col(0);
-  //   });
-  //   return;
-  // }
-
-  // If we don't limit # threads, eigen may overloading omp tasks (especially
-  // under relative small tasks, MLP for example)
-  //
-  // FIXME: Investigate what can happen once we support ILP
-  //        The performance is extremely bad when multi-process all tries to use
-  //        num_cores.
-  // auto expected_num_threads = std::max((M * K + kMinTaskSize) / kMinTaskSize,
-  //                                     (N * K + kMinTaskSize) / kMinTaskSize);
-
-  Eigen::setNbThreads(4);
-
-  c.noalias() = a * b;
+            int64_t LDC, int64_t IDC, int64_t num_threads = 0) {
+  if constexpr (detail::isRingElement<T>()) {
+    // signed products wrap around the same way.
+    using U = detail::RingElementT<T>;
+    detail::ringGemm(M, N, K, reinterpret_cast<const U*>(A), LDA, IDA,
+                     reinterpret_cast<const U*>(B), LDB, IDB,
+                     reinterpret_cast<U*>(C), LDC, IDC, num_threads);
+  } else {
+    matmulEigen(M, N, K, A, LDA, IDA, B, LDB, IDB, C, LDC, IDC);
+  }
 }
 
 }  // namespace spu::mpc::linalg
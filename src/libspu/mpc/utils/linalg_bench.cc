@@ -0,0 +1,155 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "libspu/mpc/utils/linalg.h"
+
+// Ring matmul against the Eigen path, on shapes of LR (tall matrix times a
+// vector), MLP layers (batch x features times features x hidden) and square
+// matrices, for 32, 64 and 128 bits rings and a few thread budgets.
+
+namespace spu::mpc::linalg {
+
+namespace {
+
+void makeArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"m", "n", "k", "threads"});
+  for (const auto& [m, n, k] : std::vector<std::array<int64_t, 3>>{
+           {10000, 1, 100},  // LR, X * w
+           {1, 100, 10000},  // LR, X^T * g, as a row vector
+           {64, 128, 784},   // MLP, first layer
+           {64, 10, 128},    // MLP, output layer
+           {128, 128, 128},
+           {512, 512, 512},
+       }) {
+    for (int64_t threads : {1, 4, 16}) {
+      b->Args({m, n, k, threads});
+    }
+  }
+  b->UseRealTime();
+}
+
+template <typename T>
+struct Setup {
+  explicit Setup(const benchmark::State& state)
+      : m(state.range(0)),
+        n(state.range(1)),
+        k(state.range(2)),
+        a(m * k),
+        b(k * n),
+        c(m * n),
+        threads(state.range(3)) {
+    std::mt19937_64 rng(0);
+    for (auto& x : a) {
+      x = static_cast<T>(rng());
+    }
+    for (auto& x : b) {
+      x = static_cast<T>(rng());
+    }
+  }
+
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  std::vector<T> a;
+  std::vector<T> b;
+  std::vector<T> c;
+  int64_t threads;
+};
+
+template <typename T>
+void BM_RingMatmul(benchmark::State& state) {
+  Setup<T> s(state);
+  for (auto _ : state) {
+    matmul(s.m, s.n, s.k, s.a.data(), s.k, 1, s.b.data(), s.n, 1, s.c.data(),
+           s.n, 1, s.threads);
+  }
+  state.SetItemsProcessed(state.iterations() * s.m * s.n * s.k);
+}
+
+template <typename T>
+void BM_EigenMatmul(benchmark::State& state) {
+  Setup<T> s(state);
+  Eigen::setNbThreads(static_cast<int>(numThreads(s.threads)));
+  for (auto _ : state) {
+    matmulEigen(s.m, s.n, s.k, s.a.data(), s.k, 1, s.b.data(), s.n, 1,
+                s.c.data(), s.n, 1);
+  }
+  state.SetItemsProcessed(state.iterations() * s.m * s.n * s.k);
+}
+
+// A replicated share times a public matrix, as MatMulAP of ABY3: the two
+// shares of A are interleaved, they are multiplied either through the stride
+// 2 views or after a copy into two unit stride planes.
+template <typename T>
+void BM_ShareMatmul(benchmark::State& state) {
+  Setup<T> s(state);
+  const bool planes = state.range(4) != 0;
+  std::vector<T> shares(2 * s.m * s.k);
+  for (size_t i = 0; i < shares.size(); ++i) {
+    shares[i] = s.a[i / 2] + static_cast<T>(i % 2);
+  }
+  std::vector<T> plane(s.m * s.k);
+  for (auto _ : state) {
+    for (int64_t idx = 0; idx < 2; ++idx) {
+      if (planes) {
+        for (int64_t i = 0; i < s.m * s.k; ++i) {
+          plane[i] = shares[2 * i + idx];
+        }
+        matmul(s.m, s.n, s.k, plane.data(), s.k, 1, s.b.data(), s.n, 1,
+               s.c.data(), s.n, 1, s.threads);
+      } else {
+        matmul(s.m, s.n, s.k, shares.data() + idx, 2 * s.k, 2, s.b.data(),
+               s.n, 1, s.c.data(), s.n, 1, s.threads);
+      }
+      benchmark::DoNotOptimize(s.c.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * s.m * s.n * s.k);
+}
+
+void makeShareArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"m", "n", "k", "threads", "planes"});
+  for (const auto& [m, n, k] : std::vector<std::array<int64_t, 3>>{
+           {10000, 1, 100},
+           {1, 100, 10000},
+           {64, 128, 784},
+           {512, 512, 512},
+       }) {
+    for (int64_t planes : {0, 1}) {
+      b->Args({m, n, k, 1, planes});
+    }
+  }
+  b->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ShareMatmul, uint64_t)->Apply(makeShareArgs);
+BENCHMARK_TEMPLATE(BM_ShareMatmul, uint128_t)->Apply(makeShareArgs);
+
+BENCHMARK_TEMPLATE(BM_RingMatmul, uint32_t)->Apply(makeArgs);
+BENCHMARK_TEMPLATE(BM_EigenMatmul, uint32_t)->Apply(makeArgs);
+BENCHMARK_TEMPLATE(BM_RingMatmul, uint64_t)->Apply(makeArgs);
+BENCHMARK_TEMPLATE(BM_EigenMatmul, uint64_t)->Apply(makeArgs);
+BENCHMARK_TEMPLATE(BM_RingMatmul, uint128_t)->Apply(makeArgs);
+BENCHMARK_TEMPLATE(BM_EigenMatmul, uint128_t)->Apply(makeArgs);
+
+}  // namespace spu::mpc::linalg
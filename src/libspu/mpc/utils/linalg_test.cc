@@ -14,6 +14,9 @@
 
 #include "libspu/mpc/utils/linalg.h"
 
+#include <algorithm>
+#include <array>
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -52,4 +55,78 @@ TEST(LinalgTest, MatMulStrides) {
   EXPECT_EQ(C, expected);
 }
 
+template <typename T>
+class RingMatMulTest : public ::testing::Test {};
+
+using RingTypes = ::testing::Types<int32_t, uint32_t, int64_t, uint64_t,
+                                   int128_t, uint128_t>;
+TYPED_TEST_SUITE(RingMatMulTest, RingTypes);
+
+TYPED_TEST(RingMatMulTest, WrapAround) {
+  using T = TypeParam;
+  std::mt19937_64 rng(0);
+  auto rand = [&]() {
+    T v = static_cast<T>(rng());
+    if constexpr (sizeof(T) == 16) {
+      v = static_cast<T>((static_cast<uint128_t>(v) << 64) | rng());
+    }
+    return v;
+  };
+
+  // tiny, gemv, tail tiles, and more than one kKC slice of K.
+  for (const auto& [M, N, K] : std::vector<std::array<int64_t, 3>>{
+           {3, 5, 7}, {100, 1, 300}, {1, 100, 300}, {130, 70, 513}}) {
+    // stride 2 on all operands.
+    std::vector<T> A(M * K * 2);
+    std::vector<T> B(K * N * 2);
+    std::generate(A.begin(), A.end(), rand);
+    std::generate(B.begin(), B.end(), rand);
+
+    std::vector<T> C(M * N);
+    matmul(M, N, K, A.data(), 2 * K, 2, B.data(), 2 * N, 2, C.data(), N, 1);
+
+    std::vector<T> expected(M * N);
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t j = 0; j < N; ++j) {
+        // unsigned, signed overflow is undefined.
+        using U = detail::RingElementT<T>;
+        U acc = 0;
+        for (int64_t k = 0; k < K; ++k) {
+          acc += static_cast<U>(A[2 * (i * K + k)]) *
+                 static_cast<U>(B[2 * (k * N + j)]);
+        }
+        expected[i * N + j] = static_cast<T>(acc);
+      }
+    }
+
+    EXPECT_EQ(C, expected) << M << "x" << N << "x" << K;
+  }
+}
+
+TEST(LinalgTest, ThreadBudget) {
+  const int64_t pool = numThreads(0);
+  EXPECT_GE(pool, 1);
+  EXPECT_EQ(numThreads(1), 1);
+  EXPECT_EQ(numThreads(pool + 1), pool);
+
+  // every budget computes the same product.
+  const int64_t M = 256;
+  const int64_t N = 192;
+  const int64_t K = 160;
+  std::mt19937_64 rng(0);
+  auto rand = [&]() { return rng(); };
+  std::vector<uint64_t> A(M * K);
+  std::vector<uint64_t> B(K * N);
+  std::generate(A.begin(), A.end(), rand);
+  std::generate(B.begin(), B.end(), rand);
+
+  std::vector<uint64_t> expected(M * N);
+  matmul(M, N, K, A.data(), K, 1, B.data(), N, 1, expected.data(), N, 1, 1);
+  for (int64_t budget : {0, 2, 4}) {
+    std::vector<uint64_t> C(M * N);
+    matmul(M, N, K, A.data(), K, 1, B.data(), N, 1, C.data(), N, 1, budget);
+    EXPECT_EQ(C, expected) << budget;
+  }
+}
+
 }  // namespace spu::mpc::linalg
@@ -0,0 +1,415 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "libspu/core/ndarray_ref.h"
+#include "libspu/core/parallel_utils.h"
+#include "libspu/core/type_util.h"
+
+// Fused element-wise ring expressions.
+//
+// Chained ring ops, e.g. the beaver multiplication tail
+//
+//   ring_mul_(b, x_a); ring_mul_(a, y_b); ring_add_(b, a); ring_add_(b, c);
+//
+// walk the arrays once per op. The same computation as an expression
+//
+//   ring_eval(b, ring_expr(c) + ring_expr(x_a) * ring_expr(b) +
+//                    ring_expr(y_b) * ring_expr(a));
+//
+// is evaluated in a single pass without temporaries. When the output and all
+// operands are compact, the pass runs on raw pointers, on x86 it is compiled
+// for AVX-512 or AVX2 (selected at runtime) for 32 and 64 bits rings.
+//
+// Operands are captured by reference, so an expression must be evaluated
+// before its operands are destroyed. The output may alias an operand, as long
+// as they refer to the same elements.
+
+namespace spu::mpc {
+
+#define SPU_RING_EXPR_INLINE inline __attribute__((always_inline))
+
+namespace detail {
+
+struct AddOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x, T y) const {
+    return x + y;
+  }
+};
+
+struct SubOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x, T y) const {
+    return x - y;
+  }
+};
+
+struct MulOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x, T y) const {
+    return x * y;
+  }
+};
+
+struct AndOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x, T y) const {
+    return x & y;
+  }
+};
+
+struct XorOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x, T y) const {
+    return x ^ y;
+  }
+};
+
+struct NegOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x) const {
+    return -x;
+  }
+};
+
+struct NotOp {
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x) const {
+    return ~x;
+  }
+};
+
+struct LShiftOp {
+  size_t bits;
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x) const {
+    return x << bits;
+  }
+};
+
+struct RShiftOp {
+  size_t bits;
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x) const {
+    return x >> bits;
+  }
+};
+
+struct ARShiftOp {
+  size_t bits;
+  template <typename T>
+  SPU_RING_EXPR_INLINE T operator()(T x) const {
+    using S = std::make_signed_t<T>;
+    return static_cast<T>(static_cast<S>(x) >> bits);
+  }
+};
+
+// Evaluators, an expression bound to the element type.
+
+template <typename T, bool kCompact>
+class LeafEval;
+
+template <typename T>
+class LeafEval<T, true> {
+  const T* ptr_;
+
+ public:
+  explicit LeafEval(const NdArrayRef& arr) : ptr_(arr.data<T>()) {}
+  SPU_RING_EXPR_INLINE T operator[](int64_t idx) const { return ptr_[idx]; }
+};
+
+template <typename T>
+class LeafEval<T, false> {
+  NdArrayView<T> view_;
+
+ public:
+  explicit LeafEval(const NdArrayRef& arr) : view_(arr) {}
+  SPU_RING_EXPR_INLINE T operator[](int64_t idx) const { return view_[idx]; }
+};
+
+template <typename T>
+struct ScalarEval {
+  T value;
+  SPU_RING_EXPR_INLINE T operator[](int64_t) const { return value; }
+};
+
+template <typename T, class Op, class E>
+struct UnaryEval {
+  Op op;
+  E e;
+  SPU_RING_EXPR_INLINE T operator[](int64_t idx) const {
+    return static_cast<T>(op(e[idx]));
+  }
+};
+
+template <typename T, class Op, class L, class R>
+struct BinaryEval {
+  Op op;
+  L l;
+  R r;
+  SPU_RING_EXPR_INLINE T operator[](int64_t idx) const {
+    return static_cast<T>(op(l[idx], r[idx]));
+  }
+};
+
+template <typename T, class E>
+SPU_RING_EXPR_INLINE void evalLoop(T* dst, const E& e, int64_t begin,
+                                   int64_t end) {
+  for (int64_t idx = begin; idx < end; ++idx) {
+    dst[idx] = e[idx];
+  }
+}
+
+#ifdef __x86_64__
+// Same loop compiled for wider vectors, 64 bits multiplication needs avx512dq.
+template <typename T, class E>
+__attribute__((target("avx512f,avx512dq"))) void evalLoopAvx512(
+    T* dst, const E& e, int64_t begin, int64_t end) {
+  evalLoop(dst, e, begin, end);
+}
+
+template <typename T, class E>
+__attribute__((target("avx2"))) void evalLoopAvx2(T* dst, const E& e,
+                                                  int64_t begin, int64_t end) {
+  evalLoop(dst, e, begin, end);
+}
+
+inline bool hasAvx512() {
+  static const bool kHas = __builtin_cpu_supports("avx512f") &&
+                           __builtin_cpu_supports("avx512dq");
+  return kHas;
+}
+
+inline bool hasAvx2() {
+  static const bool kHas = __builtin_cpu_supports("avx2");
+  return kHas;
+}
+#endif
+
+template <typename T, class E>
+void evalCompact(T* dst, const E& e, int64_t begin, int64_t end) {
+#ifdef __x86_64__
+  // 128 bits elements do not map to vector lanes, they stay scalar.
+  if constexpr (sizeof(T) <= sizeof(uint64_t)) {
+    if (hasAvx512()) {
+      return evalLoopAvx512(dst, e, begin, end);
+    }
+    if (hasAvx2()) {
+      return evalLoopAvx2(dst, e, begin, end);
+    }
+  }
+#endif
+  evalLoop(dst, e, begin, end);
+}
+
+}  // namespace detail
+
+template <class Derived>
+class RingExpr;
+
+template <class Op, class E>
+class RingUnaryExpr;
+
+// Base of all ring expressions.
+template <class Derived>
+class RingExpr {
+ public:
+  const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+  RingUnaryExpr<detail::LShiftOp, Derived> lshift(size_t bits) const {
+    return {detail::LShiftOp{bits}, self()};
+  }
+
+  RingUnaryExpr<detail::RShiftOp, Derived> rshift(size_t bits) const {
+    return {detail::RShiftOp{bits}, self()};
+  }
+
+  RingUnaryExpr<detail::ARShiftOp, Derived> arshift(size_t bits) const {
+    return {detail::ARShiftOp{bits}, self()};
+  }
+};
+
+class RingLeafExpr : public RingExpr<RingLeafExpr> {
+  const NdArrayRef* arr_;
+
+ public:
+  explicit RingLeafExpr(const NdArrayRef& arr) : arr_(&arr) {}
+
+  template <class F>
+  void visit(F&& f) const {
+    f(*arr_);
+  }
+
+  template <typename T, bool kCompact>
+  detail::LeafEval<T, kCompact> bind() const {
+    return detail::LeafEval<T, kCompact>(*arr_);
+  }
+};
+
+class RingScalarExpr : public RingExpr<RingScalarExpr> {
+  uint128_t value_;
+
+ public:
+  explicit RingScalarExpr(uint128_t value) : value_(value) {}
+
+  template <class F>
+  void visit(F&&) const {}
+
+  template <typename T, bool kCompact>
+  detail::ScalarEval<T> bind() const {
+    return {static_cast<T>(value_)};
+  }
+};
+
+template <class Op, class E>
+class RingUnaryExpr : public RingExpr<RingUnaryExpr<Op, E>> {
+  Op op_;
+  E e_;
+
+ public:
+  RingUnaryExpr(Op op, E e) : op_(op), e_(std::move(e)) {}
+
+  template <class F>
+  void visit(F&& f) const {
+    e_.visit(f);
+  }
+
+  template <typename T, bool kCompact>
+  auto bind() const {
+    using EE = decltype(e_.template bind<T, kCompact>());
+    return detail::UnaryEval<T, Op, EE>{op_, e_.template bind<T, kCompact>()};
+  }
+};
+
+template <class Op, class L, class R>
+class RingBinaryExpr : public RingExpr<RingBinaryExpr<Op, L, R>> {
+  Op op_;
+  L l_;
+  R r_;
+
+ public:
+  RingBinaryExpr(Op op, L l, R r)
+      : op_(op), l_(std::move(l)), r_(std::move(r)) {}
+
+  template <class F>
+  void visit(F&& f) const {
+    l_.visit(f);
+    r_.visit(f);
+  }
+
+  template <typename T, bool kCompact>
+  auto bind() const {
+    using LE = decltype(l_.template bind<T, kCompact>());
+    using RE = decltype(r_.template bind<T, kCompact>());
+    return detail::BinaryEval<T, Op, LE, RE>{
+        op_, l_.template bind<T, kCompact>(), r_.template bind<T, kCompact>()};
+  }
+};
+
+// Leaf of an expression, the array is captured by reference.
+inline RingLeafExpr ring_expr(const NdArrayRef& arr) {
+  return RingLeafExpr(arr);
+}
+RingLeafExpr ring_expr(NdArrayRef&& arr) = delete;
+
+// Constant broadcast to all elements, truncated to the ring.
+inline RingScalarExpr ring_scalar(uint128_t value) {
+  return RingScalarExpr(value);
+}
+
+#define SPU_DEF_RING_EXPR_BINARY(OP, OPNAME)        \
+  template <class L, class R>                       \
+  RingBinaryExpr<detail::OPNAME, L, R> operator OP( \
+      const RingExpr<L>& l, const RingExpr<R>& r) { \
+    return {detail::OPNAME{}, l.self(), r.self()};  \
+  }
+
+SPU_DEF_RING_EXPR_BINARY(+, AddOp)
+SPU_DEF_RING_EXPR_BINARY(-, SubOp)
+SPU_DEF_RING_EXPR_BINARY(*, MulOp)
+SPU_DEF_RING_EXPR_BINARY(&, AndOp)
+SPU_DEF_RING_EXPR_BINARY(^, XorOp)
+
+#undef SPU_DEF_RING_EXPR_BINARY
+
+template <class E>
+RingUnaryExpr<detail::NegOp, E> operator-(const RingExpr<E>& e) {
+  return {detail::NegOp{}, e.self()};
+}
+
+template <class E>
+RingUnaryExpr<detail::NotOp, E> operator~(const RingExpr<E>& e) {
+  return {detail::NotOp{}, e.self()};
+}
+
+// Evaluates `expr` into `out`, operands must have the same field and shape.
+template <class E>
+void ring_eval(NdArrayRef& out, const RingExpr<E>& expr) {
+  const auto& e = expr.self();
+  SPU_ENFORCE(out.eltype().isa<Ring2k>(), "expect ring type, got={}",
+              out.eltype());
+  const auto field = out.eltype().as<Ring2k>()->field();
+
+  bool compact = out.isCompact();
+  e.visit([&](const NdArrayRef& arr) {
+    SPU_ENFORCE(arr.eltype().isa<Ring2k>() &&
+                    arr.eltype().as<Ring2k>()->field() == field,
+                "type mismatch out={}, operand={}", out.eltype(),
+                arr.eltype());
+    SPU_ENFORCE(arr.shape() == out.shape(),
+                "shape mismatch out={}, operand={}", out.shape(),
+                arr.shape());
+    compact = compact && arr.isCompact();
+  });
+
+  const int64_t numel = out.numel();
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    using T = ring2k_t;
+    if (compact) {
+      auto bound = e.template bind<T, true>();
+      T* dst = out.data<T>();
+      pforeach(0, numel, [&](int64_t begin, int64_t end) {
+        detail::evalCompact(dst, bound, begin, end);
+      });
+    } else {
+      auto bound = e.template bind<T, false>();
+      NdArrayView<T> _out(out);
+      pforeach(0, numel, [&](int64_t idx) { _out[idx] = bound[idx]; });
+    }
+  });
+}
+
+// Evaluates `expr` into a new compact array, typed as the first operand.
+template <class E>
+NdArrayRef ring_eval(const RingExpr<E>& expr) {
+  const NdArrayRef* first = nullptr;
+  expr.self().visit([&](const NdArrayRef& arr) {
+    if (first == nullptr) {
+      first = &arr;
+    }
+  });
+  SPU_ENFORCE(first != nullptr, "expression without array operand");
+
+  NdArrayRef out(first->eltype(), first->shape());
+  ring_eval(out, expr);
+  return out;
+}
+
+#undef SPU_RING_EXPR_INLINE
+
+}  // namespace spu::mpc
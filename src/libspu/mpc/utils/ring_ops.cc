@@ -14,6 +14,7 @@
 
 #include "libspu/mpc/utils/ring_ops.h"
 
+#include <algorithm>
 #include <cstring>
 #include <random>
 
@@ -160,7 +161,8 @@ void ring_bitrev_impl(NdArrayRef& ret, const NdArrayRef& x, size_t start,
 
     NdArrayView<U> _ret(ret);
     NdArrayView<U> _x(x);
-    pforeach(0, numel, [&](int64_t idx) { _ret[idx] = bitrev_fn(_x[idx]); });
+    pforeach(0, numel, TaskCost{static_cast<int64_t>(end - start)},
+             [&](int64_t idx) { _ret[idx] = bitrev_fn(_x[idx]); });
   });
 }
 
@@ -379,7 +381,7 @@ NdArrayRef ring_mul(NdArrayRef&& x, uint128_t y) {
 }
 
 void ring_mmul_impl(NdArrayRef& z, const NdArrayRef& lhs,
-                    const NdArrayRef& rhs) {
+                    const NdArrayRef& rhs, int64_t num_threads) {
   SPU_ENFORCE(lhs.eltype().isa<Ring2k>(), "lhs not ring, got={}", lhs.eltype());
   SPU_ENFORCE(rhs.eltype().isa<Ring2k>(), "rhs not ring, got={}", rhs.eltype());
 
@@ -401,11 +403,12 @@ void ring_mmul_impl(NdArrayRef& z, const NdArrayRef& lhs,
 
     linalg::matmul(M, N, K, lhs.data<const ring2k_t>(), LDA, IDA,
                    rhs.data<const ring2k_t>(), LDB, IDB, z.data<ring2k_t>(),
-                   LDC, IDC);
+                   LDC, IDC, num_threads);
   });
 }
 
-NdArrayRef ring_mmul(const NdArrayRef& lhs, const NdArrayRef& rhs) {
+NdArrayRef ring_mmul(const NdArrayRef& lhs, const NdArrayRef& rhs,
+                     int64_t num_threads) {
   SPU_ENFORCE(lhs.shape().size() == 2 && rhs.shape().size() == 2);
   SPU_ENFORCE(lhs.shape()[1] == rhs.shape()[0],
               "contracting dim mismatch, lhs = {}, rhs = {}", lhs.shape()[1],
@@ -413,17 +416,18 @@ NdArrayRef ring_mmul(const NdArrayRef& lhs, const NdArrayRef& rhs) {
 
   NdArrayRef ret(lhs.eltype(), {lhs.shape()[0], rhs.shape()[1]});
 
-  ring_mmul_impl(ret, lhs, rhs);
+  ring_mmul_impl(ret, lhs, rhs, num_threads);
 
   return ret;
 }
 
-void ring_mmul_(NdArrayRef& out, const NdArrayRef& lhs, const NdArrayRef& rhs) {
+void ring_mmul_(NdArrayRef& out, const NdArrayRef& lhs, const NdArrayRef& rhs,
+                int64_t num_threads) {
   SPU_ENFORCE(lhs.shape()[1] == rhs.shape()[0],
               "contracting dim mismatch, lhs = {}, rhs = {}", lhs.shape()[1],
               rhs.shape()[0]);
 
-  ring_mmul_impl(out, lhs, rhs);
+  ring_mmul_impl(out, lhs, rhs, num_threads);
 }
 
 NdArrayRef ring_and(const NdArrayRef& x, const NdArrayRef& y) {
@@ -581,6 +585,103 @@ NdArrayRef ring_select(const std::vector<uint8_t>& c, const NdArrayRef& x,
   return z;
 }
 
+yacl::Buffer ring_pack_bits(const NdArrayRef& x, size_t nbits) {
+  const auto field = x.eltype().as<Ring2k>()->field();
+  SPU_ENFORCE(nbits > 0 && nbits <= SizeOf(field) * 8, "invalid nbits={}",
+              nbits);
+  SPU_ENFORCE(x.elsize() == SizeOf(field), "expect ring element, got={}",
+              x.eltype());
+
+  const int64_t numel = x.numel();
+  const int64_t num_blocks = (numel + 63) / 64;
+  yacl::Buffer packed(num_blocks * nbits * sizeof(uint64_t));
+  auto* words = packed.data<uint64_t>();
+  std::memset(words, 0, packed.size());
+
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    const uint128_t mask =
+        nbits == 128 ? ~uint128_t(0) : (uint128_t(1) << nbits) - 1;
+    NdArrayView<ring2k_t> _x(x);
+    pforeach(0, num_blocks, TaskCost{64}, [&](int64_t block) {
+      uint64_t* out = words + block * nbits;
+      const int64_t end = std::min<int64_t>(numel, (block + 1) * 64);
+      size_t pos = 0;
+      for (int64_t idx = block * 64; idx < end; ++idx, pos += nbits) {
+        uint128_t v = static_cast<uint128_t>(_x[idx]) & mask;
+        size_t word = pos / 64;
+        size_t offset = pos % 64;
+        size_t left = nbits;
+        while (true) {
+          out[word] |= static_cast<uint64_t>(v << offset);
+          const size_t taken = 64 - offset;
+          if (left <= taken) {
+            break;
+          }
+          v >>= taken;
+          left -= taken;
+          ++word;
+          offset = 0;
+        }
+      }
+    });
+  });
+
+  return packed;
+}
+
+NdArrayRef ring_unpack_bits(yacl::ByteContainerView packed, const Type& eltype,
+                            const Shape& shape, size_t nbits) {
+  const auto field = eltype.as<Ring2k>()->field();
+  SPU_ENFORCE(nbits > 0 && nbits <= SizeOf(field) * 8, "invalid nbits={}",
+              nbits);
+  SPU_ENFORCE(eltype.size() == SizeOf(field), "expect ring element, got={}",
+              eltype);
+
+  const int64_t numel = shape.numel();
+  const int64_t num_blocks = (numel + 63) / 64;
+  SPU_ENFORCE(static_cast<int64_t>(packed.size()) ==
+                  num_blocks * static_cast<int64_t>(nbits * sizeof(uint64_t)),
+              "packed size mismatch, got={}, numel={}, nbits={}",
+              packed.size(), numel, nbits);
+
+  // the stream may not be aligned, e.g. when received from the network.
+  auto load = [&](size_t word) {
+    uint64_t v;
+    std::memcpy(&v, packed.data() + word * sizeof(uint64_t), sizeof(v));
+    return v;
+  };
+
+  NdArrayRef out(eltype, shape);
+  DISPATCH_ALL_FIELDS(field, [&]() {
+    NdArrayView<ring2k_t> _out(out);
+    pforeach(0, num_blocks, TaskCost{64}, [&](int64_t block) {
+      const size_t base = block * nbits;
+      const int64_t end = std::min<int64_t>(numel, (block + 1) * 64);
+      size_t pos = 0;
+      for (int64_t idx = block * 64; idx < end; ++idx, pos += nbits) {
+        uint128_t v = 0;
+        size_t word = base + pos / 64;
+        size_t offset = pos % 64;
+        size_t got = 0;
+        while (got < nbits) {
+          const size_t take = std::min(64 - offset, nbits - got);
+          uint64_t bits = load(word) >> offset;
+          if (take < 64) {
+            bits &= (uint64_t(1) << take) - 1;
+          }
+          v |= static_cast<uint128_t>(bits) << got;
+          got += take;
+          ++word;
+          offset = 0;
+        }
+        _out[idx] = static_cast<ring2k_t>(v);
+      }
+    });
+  });
+
+  return out;
+}
+
 std::vector<NdArrayRef> ring_rand_additive_splits(const NdArrayRef& arr,
                                                   size_t num_splits) {
   const auto field = arr.eltype().as<Ring2k>()->field();
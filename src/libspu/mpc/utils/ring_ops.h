@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include "yacl/base/buffer.h"
+#include "yacl/base/byte_container_view.h"
+
 #include "libspu/core/ndarray_ref.h"
 
 namespace spu::mpc {
@@ -51,8 +54,11 @@ NdArrayRef ring_mul(const NdArrayRef& x, uint128_t y);
 void ring_mul_(NdArrayRef& x, uint128_t y);
 NdArrayRef ring_mul(NdArrayRef&& x, uint128_t y);
 
-NdArrayRef ring_mmul(const NdArrayRef& lhs, const NdArrayRef& rhs);
-void ring_mmul_(NdArrayRef& out, const NdArrayRef& lhs, const NdArrayRef& rhs);
+// `num_threads` is the thread budget, see linalg::numThreads.
+NdArrayRef ring_mmul(const NdArrayRef& lhs, const NdArrayRef& rhs,
+                     int64_t num_threads = 0);
+void ring_mmul_(NdArrayRef& out, const NdArrayRef& lhs, const NdArrayRef& rhs,
+                int64_t num_threads = 0);
 
 NdArrayRef ring_not(const NdArrayRef& x);
 void ring_not_(NdArrayRef& x);
@@ -94,6 +100,14 @@ void ring_bitmask_(NdArrayRef& x, size_t low, size_t high);
 NdArrayRef ring_select(const std::vector<uint8_t>& c, const NdArrayRef& x,
                        const NdArrayRef& y);
 
+// Packs the low `nbits` bits of each element into a dense bit stream, every 64
+// elements take `nbits` little-endian words.
+yacl::Buffer ring_pack_bits(const NdArrayRef& x, size_t nbits);
+
+// Inverse of ring_pack_bits, bits above `nbits` of the result are zero.
+NdArrayRef ring_unpack_bits(yacl::ByteContainerView packed, const Type& eltype,
+                            const Shape& shape, size_t nbits);
+
 // random additive splits.
 std::vector<NdArrayRef> ring_rand_additive_splits(const NdArrayRef& arr,
                                                   size_t num_splits);
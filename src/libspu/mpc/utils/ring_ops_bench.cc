@@ -17,6 +17,7 @@
 
 #include "benchmark/benchmark.h"
 
+#include "libspu/mpc/utils/ring_eval.h"
 #include "libspu/mpc/utils/ring_ops.h"
 
 namespace spu::mpc::utils {
@@ -64,8 +65,46 @@ static void BM_RingAdd_(benchmark::State& state) {  // NOLINT
   }
 }
 
+// z = c + x * b + y * a, the tail of beaver multiplication.
+static void BM_RingBeaverUnfused(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+  const int64_t stride = state.range(1);
+  const auto field = static_cast<spu::FieldType>(state.range(2));
+
+  const auto a = makeRandomArray(field, numel, stride);
+  const auto b = makeRandomArray(field, numel, stride);
+  const auto c = makeRandomArray(field, numel, stride);
+  const auto x = makeRandomArray(field, numel, stride);
+  const auto y = makeRandomArray(field, numel, stride);
+
+  for (auto _ : state) {
+    auto z = ring_mul(x, b);
+    ring_add_(z, ring_mul(y, a));
+    ring_add_(z, c);
+  }
+}
+
+static void BM_RingBeaverFused(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+  const int64_t stride = state.range(1);
+  const auto field = static_cast<spu::FieldType>(state.range(2));
+
+  const auto a = makeRandomArray(field, numel, stride);
+  const auto b = makeRandomArray(field, numel, stride);
+  const auto c = makeRandomArray(field, numel, stride);
+  const auto x = makeRandomArray(field, numel, stride);
+  const auto y = makeRandomArray(field, numel, stride);
+
+  for (auto _ : state) {
+    ring_eval(ring_expr(c) + ring_expr(x) * ring_expr(b) +
+              ring_expr(y) * ring_expr(a));
+  }
+}
+
 BENCHMARK(BM_RingAdd)->Apply(makeUnaryArgs);
 BENCHMARK(BM_RingAdd_)->Apply(makeUnaryArgs);
+BENCHMARK(BM_RingBeaverUnfused)->Apply(makeUnaryArgs);
+BENCHMARK(BM_RingBeaverFused)->Apply(makeUnaryArgs);
 
 }  // namespace spu::mpc::utils
 
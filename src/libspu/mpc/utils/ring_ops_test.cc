@@ -18,6 +18,8 @@
 
 #include "gtest/gtest.h"
 
+#include "libspu/mpc/utils/ring_eval.h"
+
 namespace spu::mpc {
 
 class RingArrayRefTest
@@ -238,4 +240,69 @@ TEST_P(RingArrayRefTest, RingBitMask) {
   }
 }
 
+TEST_P(RingArrayRefTest, PackBits) {
+  const FieldType field = std::get<0>(GetParam());
+  const int64_t numel = std::get<1>(GetParam());
+  const int64_t stride = std::get<2>(GetParam());
+
+  // GIVEN
+  const auto x = makeRandomArray(field, numel, stride);
+
+  for (size_t nbits : {size_t(1), size_t(7), size_t(31), SizeOf(field) * 8}) {
+    // WHEN
+    auto packed = ring_pack_bits(x, nbits);
+    auto y = ring_unpack_bits(
+        yacl::ByteContainerView(packed.data<uint8_t>(), packed.size()),
+        x.eltype(), x.shape(), nbits);
+
+    // THEN
+    EXPECT_EQ(packed.size(), (numel + 63) / 64 * nbits * sizeof(uint64_t));
+    EXPECT_TRUE(ring_all_equal(y, ring_bitmask(x, 0, nbits)));
+  }
+}
+
+TEST_P(RingArrayRefTest, Eval) {
+  const FieldType field = std::get<0>(GetParam());
+  const int64_t numel = std::get<1>(GetParam());
+  const int64_t stride_x = std::get<2>(GetParam());
+  const int64_t stride_y = std::get<3>(GetParam());
+
+  // GIVEN
+  const auto x = makeRandomArray(field, numel, stride_x);
+  const auto y = makeRandomArray(field, numel, stride_y);
+  const auto c = makeRandomArray(field, numel, 1);
+
+  {
+    // WHEN
+    auto z = ring_eval(ring_expr(c) + ring_expr(x) * ring_expr(y) -
+                       (ring_expr(x) ^ ring_expr(y)));
+
+    // THEN
+    auto expected = ring_add(c, ring_mul(x, y));
+    ring_sub_(expected, ring_xor(x, y));
+    EXPECT_TRUE(ring_all_equal(z, expected));
+  }
+  {
+    // WHEN
+    auto z = ring_eval(-ring_expr(x).arshift(3) +
+                       (~ring_expr(y) & ring_scalar(0xff)).lshift(2));
+
+    // THEN
+    auto expected = ring_lshift(ring_bitmask(ring_not(y), 0, 8), {2});
+    ring_sub_(expected, ring_arshift(x, {3}));
+    EXPECT_TRUE(ring_all_equal(z, expected));
+  }
+  {
+    // in place, the output aliases an operand.
+    auto z = y.clone();
+    auto expected = ring_add(ring_mul(z, x), z);
+
+    // WHEN
+    ring_eval(z, ring_expr(z) * ring_expr(x) + ring_expr(z));
+
+    // THEN
+    EXPECT_TRUE(ring_all_equal(z, expected));
+  }
+}
+
 }  // namespace spu::mpc
@@ -121,6 +121,23 @@ void convertFromPB(const pb::RuntimeConfig& src, RuntimeConfig& dst) {
       src.experimental_exp_prime_disable_lower_bound();
   dst.experimental_exp_prime_enable_upper_bound =
       src.experimental_exp_prime_enable_upper_bound();
+  dst.experimental_beaver_prefetch_depth =
+      src.experimental_beaver_prefetch_depth();
+  dst.experimental_beaver_record_dir = src.experimental_beaver_record_dir();
+  dst.experimental_beaver_replay_dir = src.experimental_beaver_replay_dir();
+  dst.experimental_beaver_cache_memory_budget =
+      src.experimental_beaver_cache_memory_budget();
+  dst.experimental_enable_numa_pinning = src.experimental_enable_numa_pinning();
+  dst.experimental_enable_comm_bit_packing =
+      src.experimental_enable_comm_bit_packing();
+  dst.experimental_mmul_num_threads = src.experimental_mmul_num_threads();
+  dst.experimental_spdz2k_mac_check_interval =
+      src.experimental_spdz2k_mac_check_interval();
+  dst.experimental_buffer_pool_size = src.experimental_buffer_pool_size();
+  dst.experimental_enable_executable_cache =
+      src.experimental_enable_executable_cache();
+  dst.experimental_enable_critical_path_scheduling =
+      src.experimental_enable_critical_path_scheduling();
 
   if (src.has_ttp_beaver_config()) {
     auto ttp_conf = src.ttp_beaver_config();
@@ -143,6 +160,10 @@ void convertFromPB(const pb::RuntimeConfig& src, RuntimeConfig& dst) {
         CheetahConfig(src.cheetah_2pc_config().disable_matmul_pack(),
                       src.cheetah_2pc_config().enable_mul_lsb_error(),
                       CheetahOtKind(src.cheetah_2pc_config().ot_kind()));
+    dst.cheetah_2pc_config.enable_ot_prefetch =
+        src.cheetah_2pc_config().enable_ot_prefetch();
+    dst.cheetah_2pc_config.matmul_encode_cache_budget =
+        src.cheetah_2pc_config().matmul_encode_cache_budget();
   }
 }
 
@@ -199,6 +220,10 @@ void convertToPB(const RuntimeConfig& src, pb::RuntimeConfig& dst) {
         src.cheetah_2pc_config.enable_mul_lsb_error);
     cheetah_conf->set_ot_kind(
         pb::CheetahOtKind(src.cheetah_2pc_config.ot_kind));
+    cheetah_conf->set_enable_ot_prefetch(
+        src.cheetah_2pc_config.enable_ot_prefetch);
+    cheetah_conf->set_matmul_encode_cache_budget(
+        src.cheetah_2pc_config.matmul_encode_cache_budget);
   }
   dst.set_trunc_allow_msb_error(src.trunc_allow_msb_error);
   dst.set_experimental_disable_mmul_split(src.experimental_disable_mmul_split);
@@ -218,6 +243,24 @@ void convertToPB(const RuntimeConfig& src, pb::RuntimeConfig& dst) {
       src.experimental_exp_prime_disable_lower_bound);
   dst.set_experimental_exp_prime_enable_upper_bound(
       src.experimental_exp_prime_enable_upper_bound);
+  dst.set_experimental_beaver_prefetch_depth(
+      src.experimental_beaver_prefetch_depth);
+  dst.set_experimental_beaver_record_dir(src.experimental_beaver_record_dir);
+  dst.set_experimental_beaver_replay_dir(src.experimental_beaver_replay_dir);
+  dst.set_experimental_beaver_cache_memory_budget(
+      src.experimental_beaver_cache_memory_budget);
+  dst.set_experimental_enable_numa_pinning(
+      src.experimental_enable_numa_pinning);
+  dst.set_experimental_enable_comm_bit_packing(
+      src.experimental_enable_comm_bit_packing);
+  dst.set_experimental_mmul_num_threads(src.experimental_mmul_num_threads);
+  dst.set_experimental_spdz2k_mac_check_interval(
+      src.experimental_spdz2k_mac_check_interval);
+  dst.set_experimental_buffer_pool_size(src.experimental_buffer_pool_size);
+  dst.set_experimental_enable_executable_cache(
+      src.experimental_enable_executable_cache);
+  dst.set_experimental_enable_critical_path_scheduling(
+      src.experimental_enable_critical_path_scheduling);
 }
 
 RuntimeConfig::RuntimeConfig(const spu::pb::RuntimeConfig& pb_conf) {
@@ -515,7 +558,9 @@ bool CompilerOptions::operator==(const CompilerOptions& other) const {
          disable_deallocation_insertion ==
              other.disable_deallocation_insertion &&
          disable_partial_sort_optimization ==
-             other.disable_partial_sort_optimization;
+             other.disable_partial_sort_optimization &&
+         enable_bytecode_output == other.enable_bytecode_output &&
+         enable_secret_op_batching == other.enable_secret_op_batching;
 }
 #endif
 };  // namespace spu
@@ -548,7 +593,8 @@ std::size_t hash<spu::CompilerOptions>::operator()(
       co.disable_maxpooling_optimization, co.disallow_mix_types_opts,
       co.disable_select_optimization,
       co.enable_optimize_denominator_with_broadcast,
-      co.disable_deallocation_insertion, co.disable_partial_sort_optimization);
+      co.disable_deallocation_insertion, co.disable_partial_sort_optimization,
+      co.enable_bytecode_output, co.enable_secret_op_batching);
   return seed;
 }
 };  // namespace std
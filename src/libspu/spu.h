@@ -191,6 +191,11 @@ struct CheetahConfig {
   bool enable_mul_lsb_error = false;
   // Setup for cheetah ot
   CheetahOtKind ot_kind = CheetahOtKind::YACL_Ferret;
+  // expand the next batch of Ferret OTs in background, works for YACL_Ferret.
+  bool enable_ot_prefetch = false;
+  // bytes of encoded matmul operands kept for the shares marked by
+  // make_cached_var, 0 to disable.
+  uint64_t matmul_encode_cache_budget = 0;
 
   CheetahConfig() = default;
   CheetahConfig(bool disable_matmul_pack, bool enable_mul_lsb_error,
@@ -416,6 +421,52 @@ struct RuntimeConfig {
   // default to disable it
   bool experimental_exp_prime_enable_upper_bound = false;
 
+  // Number of hinted beaver requests generated ahead of time on a background
+  // thread, works for semi2k only, 0(default) disables prefetching.
+  uint64_t experimental_beaver_prefetch_depth = 0;
+
+  // Offline/online split of correlated randomness, works for semi2k only.
+  // When set, every beaver request is generated and persisted under this
+  // directory, the executable should be run once with placeholder inputs.
+  std::string experimental_beaver_record_dir;
+  // When set, beaver requests are served from a directory written by a record
+  // run of the same executable. A recorded directory MUST NOT be replayed
+  // twice.
+  std::string experimental_beaver_replay_dir;
+
+  // When non-zero, the semi2k beaver cache keeps opened values in a memory
+  // mapped arena instead of LevelDB, with at most this many bytes in memory,
+  // colder values spill to a temporary file.
+  uint64_t experimental_beaver_cache_memory_budget = 0;
+
+  // Spread the workers of the parallel pool over NUMA nodes, round-robin.
+  // The pool is shared, workers stay pinned while any context enabling it is
+  // alive.
+  bool experimental_enable_numa_pinning = false;
+
+  // Send only the live bits of boolean shares, works for semi2k and cheetah.
+  bool experimental_enable_comm_bit_packing = false;
+
+  // Max number of threads of a ring matmul run by this context, 0 means the
+  // size of the parallel pool.
+  uint64_t experimental_mmul_num_threads = 0;
+
+  // Number of spdz2k opens whose MACs are checked together, 0 checks every
+  // open at once. Pending opens are also checked before any reveal.
+  uint64_t experimental_spdz2k_mac_check_interval = 0;
+
+  // When non-zero, buffers of freed arrays are pooled (up to this many bytes)
+  // and reused by later allocations during execution. Process wide.
+  uint64_t experimental_buffer_pool_size = 0;
+
+  // Keep parsed executables in a process wide cache, running the same
+  // executable again skips parsing and verification.
+  bool experimental_enable_executable_cache = false;
+
+  // With inter op parallel, run ops on the longest path of communication
+  // rounds first instead of in program order.
+  bool experimental_enable_critical_path_scheduling = false;
+
   // static RuntimeConfig makeFromJson(const std::string& json_str);
 
   RuntimeConfig() = default;
@@ -501,6 +552,14 @@ struct CompilerOptions {
   // Disable sort->topk rewrite when only partial sort is required
   bool disable_partial_sort_optimization = false;
 
+  // Emit MLIR bytecode instead of textual IR, which is smaller and faster to
+  // parse, the runtime accepts both.
+  bool enable_bytecode_output = false;
+
+  // Merge independent secret ops of the same kind, e.g. multiplications and
+  // comparisons, into one op, so they share communication rounds.
+  bool enable_secret_op_batching = false;
+
 #if __cplusplus >= 202002L
   bool operator==(const CompilerOptions& other) const = default;
 #else